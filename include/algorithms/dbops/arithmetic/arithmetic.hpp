@@ -26,191 +26,342 @@
 #ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_MULTIPLY_HPP
 #define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_MULTIPLY_HPP
 
+#include <algorithm>
+#include <array>
 #include <climits>
 #include <cstddef>
 #include <deque>
 #include <iostream>
 #include <iterable.hpp>
+#include <limits>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
+#include "algorithms/dbops/arithmetic/deterministic_sum.hpp"
 #include "algorithms/dbops/dbops_hints.hpp"
 #include "generated/declarations/calc.hpp"
 #include "tsl.hpp"
 
 namespace tuddbs {
+  /**
+   * @brief Result of a reduction with hints::arithmetic::statistics.
+   * @details For an empty selection, min and max keep their neutral elements (numeric max and lowest). The sum has the
+   * accumulator type of the Arithmetic (SumT), e.g. arithmetic_statistics_t<int32_t, int64_t> for a widened sum.
+   */
+  template <typename T, typename SumT = T>
+  struct arithmetic_statistics_t {
+    T min;
+    T max;
+    SumT sum;
+    size_t count;
+  };
+
+  template <typename T>
+  struct is_arithmetic_statistics : std::false_type {};
+  template <typename T, typename SumT>
+  struct is_arithmetic_statistics<arithmetic_statistics_t<T, SumT>> : std::true_type {};
+
+  template <typename T>
+  struct is_int128 : std::false_type {};
+#ifdef __SIZEOF_INT128__
+  template <>
+  struct is_int128<__int128> : std::true_type {};
+  template <>
+  struct is_int128<unsigned __int128> : std::true_type {};
+#endif
+
+  /**
+   * @brief Result sink of a single-column reduction: an iterable, a pointer to arithmetic_statistics_t or a pointer to
+   * a 128-bit accumulator.
+   */
+  template <typename T>
+  concept ArithmeticReductionSink =
+    SimdOpsIterable<T> || (std::is_pointer_v<T> && (is_arithmetic_statistics<std::remove_pointer_t<T>>::value ||
+                                                    is_int128<std::remove_pointer_t<T>>::value));
+
   /**
    * @brief A class for performing arithmetic operations on columns.
    * @details We assume that the data is stored in a columnar format.
-   * Furthermore, the operation must not exceed the range of the base type.
-   * Consequently, when working with uint8_t, the maximum possible result is 255.
-   * @todo We should add a convert_up version to support arbitrary length columns.
+   * Element-wise operations must not exceed the range of the base type.
+   * Sums and averages are accumulated in _AccumulatorType: if it is wider than the base type, every register is widened
+   * via convert_up into multiple accumulator registers, a 128-bit accumulator is emulated with a low and a high 64-bit
+   * half per lane. With hints::arithmetic::checked, an overflow of the accumulator throws std::overflow_error.
    *
    * @tparam _SimdStyle
    * @tparam HintSet
+   * @tparam _AccumulatorType Type of the sum (e.g. int64_t for int32_t data or __int128 for int64_t data).
    */
-  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::arithmetic::add>>
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::arithmetic::add>,
+            typename _AccumulatorType = typename _SimdStyle::base_type>
   class Arithmetic {
    public:
     using SimdStyle = _SimdStyle;
     using reg_t = typename SimdStyle::register_type;
     using base_t = typename SimdStyle::base_type;
+    // Averages of narrow integers are accumulated in 64 bit, as the result is a double anyway.
+    using accumulator_t =
+      std::conditional_t<has_hint<HintSet, hints::arithmetic::average> && std::is_integral_v<_AccumulatorType> &&
+                           (sizeof(_AccumulatorType) < sizeof(uint64_t)),
+                         std::conditional_t<std::is_signed_v<_AccumulatorType>, int64_t, uint64_t>, _AccumulatorType>;
+    static_assert(sizeof(accumulator_t) >= sizeof(base_t), "The accumulator must not be narrower than the data.");
+    using statistics_t = arithmetic_statistics_t<base_t, accumulator_t>;
+
+   private:
+    template <class HS>
+    constexpr static bool is_reduction =
+      has_any_hint<HS, hints::arithmetic::sum, hints::arithmetic::average, hints::arithmetic::min,
+                   hints::arithmetic::max, hints::arithmetic::count, hints::arithmetic::statistics>;
+
+    constexpr static bool is_statistics_reduction =
+      has_any_hint<HintSet, hints::arithmetic::min, hints::arithmetic::max, hints::arithmetic::count,
+                   hints::arithmetic::statistics>;
+
+    constexpr static bool is_checked = has_hint<HintSet, hints::arithmetic::checked>;
+    static_assert(!is_checked || !std::is_floating_point_v<accumulator_t>,
+                  "Overflow checks are only supported for integral accumulators.");
+
+    // Sums and averages go through the SumAccumulator if they must be widened or checked.
+    constexpr static bool sum_needs_accumulator = is_checked || !std::is_same_v<accumulator_t, base_t>;
+    constexpr static bool use_sum_accumulator = !is_statistics_reduction && sum_needs_accumulator;
+    // The sum of a statistics reduction is kept in a SumAccumulator next to min and max, other statistics (min, max,
+    // count) do not compute a sum that could overflow.
+    constexpr static bool use_statistics_sum_accumulator =
+      has_hint<HintSet, hints::arithmetic::statistics> && sum_needs_accumulator;
 
+    // Number of data registers after which the collected overflow flags are tested.
+    constexpr static size_t checked_block_registers = 1024;
+
+    // Number of independent accumulators of floating point sums, hiding the latency of the add.
+    constexpr static size_t sum_unroll_factor = 4;
+
+    // Number of registers the rows of a position list are prefetched ahead of the gather.
+    constexpr static size_t gather_prefetch_distance = 8;
+
+   public:
     explicit Arithmetic() {}
 
     /* Reducing Operations on a single column, e.g., sum, avg */
     template <class HS = HintSet>
-    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end,
                     activate_for_position_list<HS> = {}) {
       const auto simd_end = tuddbs::simd_iter_end<SimdStyle>(p_data, p_end);
       const auto scalar_end = tuddbs::iter_end(p_data, p_end);
 
-      reg_t res_vec = tsl::set1<SimdStyle>(0);
-      if constexpr (std::is_floating_point_v<base_t>) {
-        // This is a SIMDified version of the Kahan summation
-        reg_t error_vec = tsl::set1<SimdStyle>(0);
+      if constexpr (is_statistics_reduction || use_sum_accumulator) {
+        ReductionAccumulator accumulator;
         for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
-          reg_t vals = tsl::loadu<SimdStyle>(p_data);
-          vals = tsl::sub<SimdStyle>(vals, error_vec);
-          reg_t buffer = tsl::add<SimdStyle>(res_vec, vals);
-          error_vec = tsl::sub<SimdStyle>(tsl::sub<SimdStyle>(buffer, res_vec), vals);
-          res_vec = buffer;
+          accumulator.update(tsl::loadu<SimdStyle>(p_data));
         }
-      } else {
-        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
-          res_vec = tsl::add<SimdStyle>(res_vec, tsl::loadu<SimdStyle>(p_data));
+        for (; p_data != scalar_end; p_data++) {
+          accumulator.update(*p_data);
         }
+        write_reduction_result(p_result, accumulator.result());
+        return;
       }
 
-      base_t res_scalar = 0;
-
+      const size_t element_count = scalar_end - p_data;
       if constexpr (std::is_floating_point_v<base_t>) {
-        base_t error = static_cast<base_t>(0.0);
-        for (; p_data != scalar_end; p_data++) {
-          // This is a scalar version of the Kahan summation
-          base_t y = *p_data - error;
-          base_t t = res_scalar + y;
-          error = (t - res_scalar) - y;
-          res_scalar = t;
+        // Kahan summation with sum_unroll_factor independent accumulators
+        KahanAccumulator accumulator;
+        const auto batched_end = tuddbs::batched_iter_end<KahanAccumulator::batch_size>(p_data, p_end);
+        for (; p_data != batched_end; p_data += KahanAccumulator::batch_size) {
+          accumulator.update_batch(p_data);
+        }
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
+          accumulator.update(0, tsl::loadu<SimdStyle>(p_data));
         }
-        // Scalar remainder for Kahan
-        const auto vec_res = tsl::hadd<SimdStyle>(res_vec);
-        base_t y = vec_res - error;
-        res_scalar += y;
-      } else {
         for (; p_data != scalar_end; p_data++) {
-          res_scalar += *p_data;
+          accumulator.update(*p_data);
         }
-        res_scalar += tsl::hadd<SimdStyle>(res_vec);
+        write_reduction_result(p_result, std::pair<accumulator_t, size_t>{accumulator.result(), element_count});
+        return;
       }
 
-      if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::sum>) {
-        *p_result = res_scalar;
-      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::average>) {
-        const size_t element_count = scalar_end - p_data;
-        if constexpr (std::is_floating_point_v<base_t>) {
-          *p_result = res_scalar / element_count;
-        } else {
-          *p_result = static_cast<double>(res_scalar) / element_count;
-        }
-      } else {
-        throw std::runtime_error("Unknown single-column arithmetic. No suitable hint was provided.");
+      reg_t res_vec = tsl::set1<SimdStyle>(0);
+      for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
+        res_vec = tsl::add<SimdStyle>(res_vec, tsl::loadu<SimdStyle>(p_data));
       }
+
+      base_t res_scalar = 0;
+      for (; p_data != scalar_end; p_data++) {
+        res_scalar += *p_data;
+      }
+      res_scalar += tsl::hadd<SimdStyle>(res_vec);
+      write_reduction_result(p_result, std::pair<accumulator_t, size_t>{res_scalar, element_count});
     }
 
     template <class HS = HintSet>
-    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end,
                     SimdOpsIterable auto p_valid_masks, activate_for_bit_mask<HS> = {}) {
       using CountSimdStyle = typename SimdStyle::template transform_extension<typename SimdStyle::offset_base_type>;
 
       const auto simd_end = tuddbs::simd_iter_end<SimdStyle>(p_data, p_end);
       const auto scalar_end = tuddbs::iter_end(p_data, p_end);
       auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
-      auto valid_elements_count_reg = tsl::set1<CountSimdStyle>(0);
-      auto const valid_elements_increment_reg = tsl::set1<CountSimdStyle>(1);
-      reg_t res_vec = tsl::set1<SimdStyle>(static_cast<base_t>(0));
 
-      if constexpr (std::is_floating_point_v<base_t>) {
-        // This is a SIMDified version of the Kahan summation
-        reg_t error_vec = tsl::set1<SimdStyle>(0);
+      if constexpr (is_statistics_reduction || use_sum_accumulator) {
+        ReductionAccumulator accumulator;
         for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
-          reg_t vals = tsl::loadu<SimdStyle>(p_data);
-          auto valid_mask = tsl::load_mask<SimdStyle>(valid_masks);
-          vals = tsl::sub<SimdStyle>(valid_mask, vals, error_vec);
-          reg_t buffer = tsl::add<SimdStyle>(valid_mask, res_vec, vals);
-          error_vec = tsl::blend<SimdStyle>(
-            valid_mask, error_vec,
-            tsl::sub<SimdStyle>(valid_mask, tsl::sub<SimdStyle>(valid_mask, buffer, res_vec), vals));
-
-          res_vec = buffer;
-          if constexpr (std::is_same_v<decltype(valid_mask), typename CountSimdStyle::mask_type>) {
-            valid_elements_count_reg =
-              tsl::add<CountSimdStyle>(valid_mask, valid_elements_count_reg, valid_elements_increment_reg);
-          } else {
-            valid_elements_count_reg = tsl::add<CountSimdStyle>(tsl::reinterpret<SimdStyle, CountSimdStyle>(valid_mask),
-                                                                valid_elements_count_reg, valid_elements_increment_reg);
-          }
+          accumulator.update(tsl::load_mask<SimdStyle>(valid_masks), tsl::loadu<SimdStyle>(p_data));
         }
-      } else {
-        auto const p_data_start = p_data;
-        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
-          auto valid_mask = tsl::load_mask<SimdStyle>(valid_masks);
-          res_vec = tsl::add<SimdStyle>(valid_mask, res_vec, tsl::loadu<SimdStyle>(p_data));
-          valid_elements_count_reg =
-            tsl::add<CountSimdStyle>(valid_mask, valid_elements_count_reg, valid_elements_increment_reg);
+        auto valid_mask = tsl::load_imask<SimdStyle>(valid_masks);
+        for (; p_data != scalar_end; p_data++) {
+          if ((valid_mask & 0b1) == 0b1) {
+            accumulator.update(*p_data);
+          }
+          valid_mask >>= 1;
         }
+        write_reduction_result(p_result, accumulator.result());
+        return;
       }
 
-      base_t res_scalar = 0;
-      typename SimdStyle::offset_base_type valid_elements_count = tsl::hadd<CountSimdStyle>(valid_elements_count_reg);
       if constexpr (std::is_floating_point_v<base_t>) {
-        base_t error = static_cast<base_t>(0.0);
+        // Kahan summation with sum_unroll_factor independent accumulators
+        KahanAccumulator accumulator;
+        size_t valid_elements_count = 0;
+        const auto batched_end = tuddbs::batched_iter_end<KahanAccumulator::batch_size>(p_data, p_end);
+        for (; p_data != batched_end; p_data += KahanAccumulator::batch_size, valid_masks += sum_unroll_factor) {
+          accumulator.update_batch(p_data, valid_masks);
+          for (size_t i = 0; i < sum_unroll_factor; ++i) {
+            valid_elements_count += tsl::mask_population_count<SimdStyle>(tsl::load_mask<SimdStyle>(valid_masks + i));
+          }
+        }
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
+          auto const valid_mask = tsl::load_mask<SimdStyle>(valid_masks);
+          accumulator.update(0, valid_mask, tsl::loadu<SimdStyle>(p_data));
+          valid_elements_count += tsl::mask_population_count<SimdStyle>(valid_mask);
+        }
         auto valid_mask = tsl::load_imask<SimdStyle>(valid_masks);
         for (; p_data != scalar_end; p_data++) {
           if ((valid_mask & 0b1) == 0b1) {
-            // This is a scalar version of the Kahan summation
-            base_t y = *p_data - error;
-            base_t t = res_scalar + y;
-            error = (t - res_scalar) - y;
-            res_scalar = t;
+            accumulator.update(*p_data);
             ++valid_elements_count;
           }
           valid_mask >>= 1;
         }
-        // Scalar remainder for Kahan
-        const auto vec_res = tsl::hadd<SimdStyle>(res_vec);
-        base_t y = vec_res - error;
-        res_scalar += y;
-      } else {
-        auto valid_mask = tsl::load_imask<SimdStyle>(valid_masks);
-        // std::cout << "Remainder:" << std::endl;
+        write_reduction_result(p_result,
+                               std::pair<accumulator_t, size_t>{accumulator.result(), valid_elements_count});
+        return;
+      }
+
+      auto valid_elements_count_reg = tsl::set1<CountSimdStyle>(0);
+      auto const valid_elements_increment_reg = tsl::set1<CountSimdStyle>(1);
+      reg_t res_vec = tsl::set1<SimdStyle>(static_cast<base_t>(0));
+      for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
+        auto valid_mask = tsl::load_mask<SimdStyle>(valid_masks);
+        res_vec = tsl::add<SimdStyle>(valid_mask, res_vec, tsl::loadu<SimdStyle>(p_data));
+        valid_elements_count_reg =
+          tsl::add<CountSimdStyle>(valid_mask, valid_elements_count_reg, valid_elements_increment_reg);
+      }
+
+      base_t res_scalar = 0;
+      typename SimdStyle::offset_base_type valid_elements_count = tsl::hadd<CountSimdStyle>(valid_elements_count_reg);
+      auto valid_mask = tsl::load_imask<SimdStyle>(valid_masks);
+      for (; p_data != scalar_end; p_data++) {
+        if ((valid_mask & 0b1) == 0b1) {
+          res_scalar += *p_data;
+          ++valid_elements_count;
+        }
+        valid_mask >>= 1;
+      }
+      res_scalar += tsl::hadd<SimdStyle>(res_vec);
+      write_reduction_result(p_result, std::pair<accumulator_t, size_t>{res_scalar, valid_elements_count});
+    }
+
+    /* Reducing the elements of a single column selected by a dense bitmask (one bit per element). */
+    template <class HS = HintSet>
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end,
+                    SimdOpsIterable auto p_valid_masks, activate_for_dense_bit_mask<HS> = {}) {
+      using imask_type = typename SimdStyle::imask_type;
+      constexpr size_t bits_per_mask = sizeof(imask_type) * CHAR_BIT;
+      constexpr size_t registers_per_mask = bits_per_mask / SimdStyle::vector_element_count();
+      // The lanes of a single register. A register that spans the whole mask must not be shifted by the mask width.
+      constexpr imask_type register_lanes = []() {
+        if constexpr (registers_per_mask == 1) {
+          return static_cast<imask_type>(~imask_type{0});
+        } else {
+          return static_cast<imask_type>((imask_type{1} << SimdStyle::vector_element_count()) - 1);
+        }
+      }();
+      const auto batched_end = tuddbs::batched_iter_end<bits_per_mask>(p_data, p_end);
+      const auto scalar_end = tuddbs::iter_end(p_data, p_end);
+      auto valid_masks = reinterpret_iterable<imask_type *>(p_valid_masks);
+
+      ReductionAccumulator accumulator;
+      for (; p_data != batched_end; ++valid_masks) {
+        auto const valid_mask = *valid_masks;
+        if (valid_mask == 0) {
+          p_data += bits_per_mask;
+          continue;
+        }
+        if constexpr (SimdStyle::vector_element_count() > 1) {
+          // Fully selected words need no masking.
+          if (valid_mask == static_cast<imask_type>(~imask_type{0})) {
+            for (size_t i = 0; i < registers_per_mask; ++i, p_data += SimdStyle::vector_element_count()) {
+              accumulator.update(tsl::loadu<SimdStyle>(p_data));
+            }
+            continue;
+          }
+        }
+        for (size_t i = 0; i < registers_per_mask; ++i, p_data += SimdStyle::vector_element_count()) {
+          imask_type const register_mask =
+            static_cast<imask_type>((valid_mask >> (i * SimdStyle::vector_element_count())) & register_lanes);
+          accumulator.update(tsl::load_mask<SimdStyle>(&register_mask), tsl::loadu<SimdStyle>(p_data));
+        }
+      }
+      if (p_data != scalar_end) {
+        auto valid_mask = *valid_masks;
         for (; p_data != scalar_end; p_data++) {
           if ((valid_mask & 0b1) == 0b1) {
-            res_scalar += *p_data;
-            ++valid_elements_count;
+            accumulator.update(*p_data);
           }
           valid_mask >>= 1;
         }
-        res_scalar += tsl::hadd<SimdStyle>(res_vec);
       }
+      write_reduction_result(p_result, accumulator.result());
+    }
 
-      if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::sum>) {
-        *p_result = res_scalar;
-      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::average>) {
-        if constexpr (std::is_floating_point_v<base_t>) {
-          *p_result = res_scalar / valid_elements_count;
-        } else {
-          *p_result = static_cast<double>(res_scalar) / valid_elements_count;
+    /* Reducing the elements of a single column at the positions given by a position list. */
+    template <class HS = HintSet>
+      requires(is_reduction<HS>)
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterable auto p_position_list, SimdOpsIterableOrSizeT auto p_position_list_end,
+                    activate_for_position_list<HS> = {}) {
+      constexpr size_t prefetch_offset = gather_prefetch_distance * SimdStyle::vector_element_count();
+      auto positions = reinterpret_iterable<size_t *>(p_position_list);
+      const auto batched_end =
+        tuddbs::batched_iter_end<SimdStyle::vector_element_count()>(positions, p_position_list_end);
+      const auto scalar_end = tuddbs::iter_end(positions, p_position_list_end);
+      const auto prefetch_end = (static_cast<size_t>(batched_end - positions) > prefetch_offset)
+                                  ? batched_end - prefetch_offset
+                                  : positions;
+
+      ReductionAccumulator accumulator;
+      for (; positions != prefetch_end; positions += SimdStyle::vector_element_count()) {
+        for (size_t i = 0; i < SimdStyle::vector_element_count(); ++i) {
+          __builtin_prefetch(&p_data[positions[prefetch_offset + i]]);
         }
-      } else {
-        throw std::runtime_error("Unknown single-column arithmetic. No suitable hint was provided.");
+        accumulator.update(gather_register(p_data, positions));
+      }
+      for (; positions != batched_end; positions += SimdStyle::vector_element_count()) {
+        accumulator.update(gather_register(p_data, positions));
       }
+      for (; positions != scalar_end; positions++) {
+        accumulator.update(p_data[*positions]);
+      }
+      write_reduction_result(p_result, accumulator.result());
     }
 
     /* Combining two columns element-wise, e.g., add, sub, div, mul
      * There is no need for bitmasks, as we assume columns to be materialized prior to calculation.
      */
     template <typename HS = HintSet>
+      requires(!is_reduction<HS>)
     auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data1, SimdOpsIterableOrSizeT auto p_end1,
                     SimdOpsIterable auto p_data2, activate_for_position_list<HS> = {}) {
       const auto simd_end = tuddbs::simd_iter_end<SimdStyle>(p_data1, p_end1);
@@ -228,9 +379,12 @@ namespace tuddbs {
       }
     }
 
-   private:
+    /**
+     * @brief Applies the operation selected by HintSet to two registers.
+     * @details Public, as it is the building block for fused expressions (see arithmetic_expression.hpp).
+     */
     template <class PS = SimdStyle>
-    typename PS::register_type calc(typename PS::register_type vals1, typename PS::register_type vals2) const {
+    static typename PS::register_type calc(typename PS::register_type vals1, typename PS::register_type vals2) {
       if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::add>) {
         return tsl::add<PS>(vals1, vals2);
       } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::sub>) {
@@ -243,6 +397,364 @@ namespace tuddbs {
         throw std::runtime_error("No supported arithmetic operation found");
       }
     }
+
+   private:
+    TSL_FORCE_INLINE static void accumulate_scalar(accumulator_t &sum, accumulator_t value) {
+      if constexpr (is_checked) {
+        if (__builtin_add_overflow(sum, value, &sum)) {
+          throw std::overflow_error("Arithmetic: The sum exceeds the range of the accumulator type.");
+        }
+      } else {
+        sum += value;
+      }
+    }
+
+    /**
+     * @brief Sum and count of a sum/average reduction, accumulated in registers of accumulator_t.
+     * @details Every data register is widened via convert_up into widening_factor accumulator registers. With
+     * hints::arithmetic::checked, the lanes that overflowed are or-ed into a mask which is tested once per block of
+     * checked_block_registers, so the hot loop stays free of data-dependent branches.
+     */
+    class WideningSumAccumulator {
+      using AccSimdStyle = typename SimdStyle::template transform_extension<accumulator_t>;
+      using acc_reg_t = typename AccSimdStyle::register_type;
+      constexpr static size_t widening_factor =
+        (SimdStyle::vector_element_count() == 1) ? 1 : sizeof(accumulator_t) / sizeof(base_t);
+
+      std::array<acc_reg_t, widening_factor> m_sums;
+      uint64_t m_overflow;
+      size_t m_block_fill;
+      accumulator_t m_scalar_sum;
+      size_t m_count;
+
+      TSL_FORCE_INLINE void check_block() {
+        m_block_fill = 0;
+        if (m_overflow != 0) {
+          throw std::overflow_error("Arithmetic: The sum exceeds the range of the accumulator type.");
+        }
+      }
+
+      TSL_FORCE_INLINE void add(reg_t vals) {
+        if constexpr (SimdStyle::vector_element_count() == 1) {
+          accumulate_scalar(m_scalar_sum, static_cast<accumulator_t>(vals));
+          return;
+        } else {
+          std::array<acc_reg_t, widening_factor> widened;
+          if constexpr (std::is_same_v<accumulator_t, base_t>) {
+            widened[0] = vals;
+          } else {
+            widened = tsl::convert_up<SimdStyle, AccSimdStyle>(vals);
+          }
+          for (size_t i = 0; i < widening_factor; ++i) {
+            auto const sum = tsl::add<AccSimdStyle>(m_sums[i], widened[i]);
+            if constexpr (is_checked) {
+              if constexpr (std::is_signed_v<accumulator_t>) {
+                // Signed overflow: both summands have a different sign than the sum.
+                auto const overflow = tsl::binary_and<AccSimdStyle>(tsl::binary_xor<AccSimdStyle>(m_sums[i], sum),
+                                                                    tsl::binary_xor<AccSimdStyle>(widened[i], sum));
+                m_overflow |= static_cast<uint64_t>(tsl::to_integral<AccSimdStyle>(
+                  tsl::less_than<AccSimdStyle>(overflow, tsl::set1<AccSimdStyle>(0))));
+              } else {
+                // Unsigned overflow: the sum wrapped around and is smaller than a summand.
+                m_overflow |=
+                  static_cast<uint64_t>(tsl::to_integral<AccSimdStyle>(tsl::less_than<AccSimdStyle>(sum, widened[i])));
+              }
+            }
+            m_sums[i] = sum;
+          }
+          if constexpr (is_checked) {
+            if (++m_block_fill == checked_block_registers) {
+              check_block();
+            }
+          }
+        }
+      }
+
+     public:
+      WideningSumAccumulator() : m_overflow(0), m_block_fill(0), m_scalar_sum(0), m_count(0) {
+        m_sums.fill(tsl::set1<AccSimdStyle>(0));
+      }
+
+      TSL_FORCE_INLINE void update(reg_t vals)
+        requires(SimdStyle::vector_element_count() > 1)
+      {
+        add(vals);
+        m_count += SimdStyle::vector_element_count();
+      }
+
+      TSL_FORCE_INLINE void update(typename SimdStyle::mask_type valid_mask, reg_t vals) {
+        add(tsl::maskz_mov<SimdStyle>(valid_mask, vals));
+        m_count += tsl::mask_population_count<SimdStyle>(valid_mask);
+      }
+
+      TSL_FORCE_INLINE void update(base_t val) {
+        accumulate_scalar(m_scalar_sum, static_cast<accumulator_t>(val));
+        ++m_count;
+      }
+
+      auto result() -> std::pair<accumulator_t, size_t> {
+        check_block();
+        accumulator_t sum = m_scalar_sum;
+        if constexpr (SimdStyle::vector_element_count() > 1) {
+          if constexpr (is_checked) {
+            alignas(64) std::array<accumulator_t, AccSimdStyle::vector_element_count()> lanes;
+            for (auto const &sums : m_sums) {
+              tsl::store<AccSimdStyle>(lanes.data(), sums);
+              for (auto const lane : lanes) {
+                accumulate_scalar(sum, lane);
+              }
+            }
+          } else {
+            for (auto const &sums : m_sums) {
+              sum += tsl::hadd<AccSimdStyle>(sums);
+            }
+          }
+        }
+        return {sum, m_count};
+      }
+    };
+
+    /**
+     * @brief Sum and count of a sum/average reduction of 64-bit integers into a 128-bit accumulator.
+     * @details Every lane holds the low half as uint64_t and the high half as (u)int64_t. A carry out of the low half
+     * is detected by an unsigned comparison, negative values are sign-extended by decrementing the high half. As the
+     * high half changes by at most one per row, it can not overflow, thus hints::arithmetic::checked always holds.
+     */
+    class Int128SumAccumulator {
+      using LowSimdStyle = typename SimdStyle::template transform_extension<uint64_t>;
+      using high_t = std::conditional_t<std::is_signed_v<base_t>, int64_t, uint64_t>;
+      using HighSimdStyle = typename SimdStyle::template transform_extension<high_t>;
+      static_assert(std::is_integral_v<base_t> && (sizeof(base_t) == 8),
+                    "A 128-bit accumulator is only supported for 64-bit integers.");
+
+      typename LowSimdStyle::register_type m_low;
+      typename HighSimdStyle::register_type m_high;
+      accumulator_t m_scalar_sum;
+      size_t m_count;
+
+      TSL_FORCE_INLINE void add(reg_t vals) {
+        if constexpr (SimdStyle::vector_element_count() == 1) {
+          m_scalar_sum += static_cast<accumulator_t>(vals);
+        } else {
+          auto const one = tsl::set1<HighSimdStyle>(1);
+          typename LowSimdStyle::register_type low_vals;
+          if constexpr (std::is_same_v<base_t, uint64_t>) {
+            low_vals = vals;
+          } else {
+            low_vals = tsl::reinterpret<SimdStyle, LowSimdStyle>(vals);
+          }
+          auto const low = tsl::add<LowSimdStyle>(m_low, low_vals);
+          m_high = tsl::add<HighSimdStyle>(tsl::less_than<LowSimdStyle>(low, low_vals), m_high, one);
+          if constexpr (std::is_signed_v<base_t>) {
+            m_high =
+              tsl::sub<HighSimdStyle>(tsl::less_than<SimdStyle>(vals, tsl::set1<SimdStyle>(0)), m_high, one);
+          }
+          m_low = low;
+        }
+      }
+
+     public:
+      Int128SumAccumulator()
+        : m_low(tsl::set1<LowSimdStyle>(0)), m_high(tsl::set1<HighSimdStyle>(0)), m_scalar_sum(0), m_count(0) {}
+
+      TSL_FORCE_INLINE void update(reg_t vals)
+        requires(SimdStyle::vector_element_count() > 1)
+      {
+        add(vals);
+        m_count += SimdStyle::vector_element_count();
+      }
+
+      TSL_FORCE_INLINE void update(typename SimdStyle::mask_type valid_mask, reg_t vals) {
+        add(tsl::maskz_mov<SimdStyle>(valid_mask, vals));
+        m_count += tsl::mask_population_count<SimdStyle>(valid_mask);
+      }
+
+      TSL_FORCE_INLINE void update(base_t val) {
+        m_scalar_sum += static_cast<accumulator_t>(val);
+        ++m_count;
+      }
+
+      auto result() const -> std::pair<accumulator_t, size_t> {
+        accumulator_t sum = m_scalar_sum;
+        if constexpr (SimdStyle::vector_element_count() > 1) {
+          alignas(64) std::array<uint64_t, LowSimdStyle::vector_element_count()> lows;
+          alignas(64) std::array<high_t, HighSimdStyle::vector_element_count()> highs;
+          tsl::store<LowSimdStyle>(lows.data(), m_low);
+          tsl::store<HighSimdStyle>(highs.data(), m_high);
+          for (size_t i = 0; i < lows.size(); ++i) {
+            sum += static_cast<accumulator_t>(
+              (static_cast<unsigned __int128>(static_cast<uint64_t>(highs[i])) << 64) | lows[i]);
+          }
+        }
+        return {sum, m_count};
+      }
+    };
+
+    using SumAccumulator =
+      std::conditional_t<is_int128<accumulator_t>::value, Int128SumAccumulator, WideningSumAccumulator>;
+    using KahanAccumulator = UnrolledKahanAccumulator<SimdStyle, sum_unroll_factor>;
+
+    /**
+     * @brief Compensated floating point sum and count for inputs that are not consumed in batches.
+     * @details Dense bitmasks and position lists deliver one register at a time, consecutive registers are added to
+     * the Kahan accumulators in turn, so the adds can still overlap.
+     */
+    class CompensatedSumAccumulator {
+      KahanAccumulator m_accumulator;
+      size_t m_next;
+      size_t m_count;
+
+     public:
+      CompensatedSumAccumulator() : m_accumulator(), m_next(0), m_count(0) {}
+
+      TSL_FORCE_INLINE void update(reg_t vals)
+        requires(SimdStyle::vector_element_count() > 1)
+      {
+        m_accumulator.update(m_next, vals);
+        m_next = (m_next + 1) % sum_unroll_factor;
+        m_count += SimdStyle::vector_element_count();
+      }
+
+      TSL_FORCE_INLINE void update(typename SimdStyle::mask_type valid_mask, reg_t vals) {
+        m_accumulator.update(m_next, valid_mask, vals);
+        m_next = (m_next + 1) % sum_unroll_factor;
+        m_count += tsl::mask_population_count<SimdStyle>(valid_mask);
+      }
+
+      TSL_FORCE_INLINE void update(base_t val) {
+        m_accumulator.update(val);
+        ++m_count;
+      }
+
+      auto result() const -> std::pair<accumulator_t, size_t> { return {m_accumulator.result(), m_count}; }
+    };
+
+    /**
+     * @brief Register-resident state of a single-pass min/max/sum/count reduction.
+     * @details Selected lanes are merged via blend / masked add, thus no branch depends on the data. A sum that has to
+     * be widened or checked is accumulated by a SumAccumulator instead of a register of base_t.
+     */
+    class StatisticsAccumulator {
+      using sum_t = std::conditional_t<use_statistics_sum_accumulator, SumAccumulator, reg_t>;
+
+      reg_t m_min;
+      reg_t m_max;
+      sum_t m_sum;
+      statistics_t m_scalar;
+
+     public:
+      StatisticsAccumulator()
+        : m_min(tsl::set1<SimdStyle>(std::numeric_limits<base_t>::max())),
+          m_max(tsl::set1<SimdStyle>(std::numeric_limits<base_t>::lowest())),
+          m_sum(),
+          m_scalar{std::numeric_limits<base_t>::max(), std::numeric_limits<base_t>::lowest(), 0, 0} {
+        if constexpr (!use_statistics_sum_accumulator) {
+          m_sum = tsl::set1<SimdStyle>(0);
+        }
+      }
+
+      // For the scalar processing style, reg_t equals base_t and update(base_t) is used.
+      TSL_FORCE_INLINE void update(reg_t vals)
+        requires(SimdStyle::vector_element_count() > 1)
+      {
+        m_min = tsl::min<SimdStyle>(m_min, vals);
+        m_max = tsl::max<SimdStyle>(m_max, vals);
+        if constexpr (use_statistics_sum_accumulator) {
+          m_sum.update(vals);
+        } else {
+          m_sum = tsl::add<SimdStyle>(m_sum, vals);
+        }
+        m_scalar.count += SimdStyle::vector_element_count();
+      }
+
+      TSL_FORCE_INLINE void update(typename SimdStyle::mask_type valid_mask, reg_t vals) {
+        m_min = tsl::blend<SimdStyle>(valid_mask, m_min, tsl::min<SimdStyle>(m_min, vals));
+        m_max = tsl::blend<SimdStyle>(valid_mask, m_max, tsl::max<SimdStyle>(m_max, vals));
+        if constexpr (use_statistics_sum_accumulator) {
+          m_sum.update(valid_mask, vals);
+        } else {
+          m_sum = tsl::add<SimdStyle>(valid_mask, m_sum, vals);
+        }
+        m_scalar.count += tsl::mask_population_count<SimdStyle>(valid_mask);
+      }
+
+      TSL_FORCE_INLINE void update(base_t val) {
+        m_scalar.min = std::min(m_scalar.min, val);
+        m_scalar.max = std::max(m_scalar.max, val);
+        if constexpr (use_statistics_sum_accumulator) {
+          m_sum.update(val);
+        } else {
+          m_scalar.sum += val;
+        }
+        ++m_scalar.count;
+      }
+
+      auto result() -> statistics_t {
+        std::array<base_t, SimdStyle::vector_element_count()> mins;
+        std::array<base_t, SimdStyle::vector_element_count()> maxs;
+        tsl::storeu<SimdStyle>(mins.data(), m_min);
+        tsl::storeu<SimdStyle>(maxs.data(), m_max);
+        statistics_t result = m_scalar;
+        result.min = std::min(result.min, *std::min_element(mins.cbegin(), mins.cend()));
+        result.max = std::max(result.max, *std::max_element(maxs.cbegin(), maxs.cend()));
+        if constexpr (use_statistics_sum_accumulator) {
+          result.sum = m_sum.result().first;
+        } else {
+          result.sum += tsl::hadd<SimdStyle>(m_sum);
+        }
+        return result;
+      }
+    };
+
+    using ReductionAccumulator = std::conditional_t<
+      use_sum_accumulator, SumAccumulator,
+      std::conditional_t<std::is_floating_point_v<base_t> && !is_statistics_reduction, CompensatedSumAccumulator,
+                         StatisticsAccumulator>>;
+
+    TSL_FORCE_INLINE static reg_t gather_register(auto p_data, size_t const *positions) {
+      if constexpr ((sizeof(base_t) == sizeof(size_t)) && (SimdStyle::vector_element_count() > 1)) {
+        using PositionalSimdStyle = typename SimdStyle::template transform_extension<size_t>;
+        return tsl::gather<SimdStyle>(p_data, tsl::loadu<PositionalSimdStyle>(positions));
+      } else {
+        alignas(64) std::array<base_t, SimdStyle::vector_element_count()> buffer;
+        for (size_t i = 0; i < SimdStyle::vector_element_count(); ++i) {
+          buffer[i] = p_data[positions[i]];
+        }
+        return tsl::load<SimdStyle>(buffer.data());
+      }
+    }
+
+    static void write_reduction_result(auto p_result, statistics_t const &statistics) {
+      if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::statistics>) {
+        *p_result = statistics;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::min>) {
+        *p_result = statistics.min;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::max>) {
+        *p_result = statistics.max;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::count>) {
+        *p_result = statistics.count;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::sum>) {
+        *p_result = statistics.sum;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::average>) {
+        if constexpr (std::is_floating_point_v<base_t>) {
+          *p_result = statistics.sum / statistics.count;
+        } else {
+          *p_result = static_cast<double>(statistics.sum) / statistics.count;
+        }
+      } else {
+        throw std::runtime_error("Unknown single-column arithmetic. No suitable hint was provided.");
+      }
+    }
+
+    static void write_reduction_result(auto p_result, std::pair<accumulator_t, size_t> const &sum_and_count) {
+      if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::sum>) {
+        *p_result = sum_and_count.first;
+      } else if constexpr (has_hint<HintSet, tuddbs::hints::arithmetic::average>) {
+        *p_result = static_cast<double>(sum_and_count.first) / sum_and_count.second;
+      } else {
+        throw std::runtime_error("Unknown single-column arithmetic. No suitable hint was provided.");
+      }
+    }
   };
 
   template <typename SimdStyle>
@@ -277,6 +789,41 @@ namespace tuddbs {
   template <typename SimdStyle>
   using col_bm_average_t = tuddbs::Arithmetic<
     SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::average, tuddbs::hints::intermediate::bit_mask>>;
+
+  template <typename SimdStyle>
+  using col_min_t = tuddbs::Arithmetic<
+    SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::min, tuddbs::hints::intermediate::position_list>>;
+
+  template <typename SimdStyle>
+  using col_bm_min_t =
+    tuddbs::Arithmetic<SimdStyle,
+                       tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::min, tuddbs::hints::intermediate::bit_mask>>;
+
+  template <typename SimdStyle>
+  using col_max_t = tuddbs::Arithmetic<
+    SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::max, tuddbs::hints::intermediate::position_list>>;
+
+  template <typename SimdStyle>
+  using col_bm_max_t =
+    tuddbs::Arithmetic<SimdStyle,
+                       tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::max, tuddbs::hints::intermediate::bit_mask>>;
+
+  template <typename SimdStyle>
+  using col_count_t = tuddbs::Arithmetic<
+    SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::count, tuddbs::hints::intermediate::position_list>>;
+
+  template <typename SimdStyle>
+  using col_bm_count_t = tuddbs::Arithmetic<
+    SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::count, tuddbs::hints::intermediate::bit_mask>>;
+
+  template <typename SimdStyle>
+  using col_stats_t = tuddbs::Arithmetic<
+    SimdStyle,
+    tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::statistics, tuddbs::hints::intermediate::position_list>>;
+
+  template <typename SimdStyle>
+  using col_bm_stats_t = tuddbs::Arithmetic<
+    SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::arithmetic::statistics, tuddbs::hints::intermediate::bit_mask>>;
 }  // namespace tuddbs
 
 #endif
@@ -0,0 +1,333 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+
+/**
+ * @file arithmetic_expression.hpp
+ * @brief Expression templates for fused column/scalar arithmetic.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_ARITHMETIC_EXPRESSION_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_ARITHMETIC_EXPRESSION_HPP
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+
+#include "algorithms/dbops/arithmetic/arithmetic.hpp"
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Nodes of an arithmetic expression tree.
+   * @details Q1's price * (1 - discount) * (1 + tax) is written as
+   * col(price) * (lit(1.0) - col(discount)) * (lit(1.0) + col(tax)). The tree only stores pointers and constants,
+   * evaluation happens register-wise in ArithmeticExpression.
+   */
+  namespace arithmetic_expression {
+    struct node_tag {};
+
+    template <class Node>
+    concept ExpressionNode = std::is_base_of_v<node_tag, std::remove_cvref_t<Node>>;
+
+    /**
+     * @brief A column leaf. Loads (or gathers) the values of the referenced column.
+     */
+    template <typename T>
+    struct column : node_tag {
+      T const *data;
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load(size_t i) const noexcept {
+        return tsl::loadu<PS, Idof>(data + i);
+      }
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load_selected(size_t i, typename PS::mask_type) const noexcept {
+        return tsl::loadu<PS, Idof>(data + i);
+      }
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto gather(size_t const *positions) const noexcept {
+        if constexpr ((sizeof(typename PS::base_type) == sizeof(size_t)) && (PS::vector_element_count() > 1)) {
+          using PositionalSimdStyle = typename PS::template transform_extension<size_t>;
+          return tsl::gather<PS, Idof>(data, tsl::loadu<PositionalSimdStyle, Idof>(positions));
+        } else {
+          // A native gather with narrower elements would need a conversion of the indices, a register-sized buffer
+          // is cheaper.
+          alignas(64) std::array<typename PS::base_type, PS::vector_element_count()> buffer;
+          for (size_t j = 0; j < PS::vector_element_count(); ++j) {
+            buffer[j] = data[positions[j]];
+          }
+          return tsl::load<PS, Idof>(buffer.data());
+        }
+      }
+    };
+
+    /**
+     * @brief A scalar leaf. Broadcasted via tsl::set1, which the compiler hoists out of the evaluation loop.
+     */
+    template <typename T>
+    struct literal : node_tag {
+      T constant;
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load(size_t) const noexcept {
+        return tsl::set1<PS, Idof>(static_cast<typename PS::base_type>(constant));
+      }
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load_selected(size_t, typename PS::mask_type) const noexcept {
+        return tsl::set1<PS, Idof>(static_cast<typename PS::base_type>(constant));
+      }
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto gather(size_t const *) const noexcept {
+        return tsl::set1<PS, Idof>(static_cast<typename PS::base_type>(constant));
+      }
+    };
+
+    /**
+     * @brief An inner node, Operation is one of hints::arithmetic::{add, sub, mul, div}.
+     */
+    template <class Operation, ExpressionNode Left, ExpressionNode Right>
+    struct binary : node_tag {
+      Left left;
+      Right right;
+
+      template <tsl::VectorProcessingStyle PS>
+      using arithmetic_t = Arithmetic<PS, OperatorHintSet<Operation>>;
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load(size_t i) const noexcept {
+        return arithmetic_t<PS>::template calc<PS>(left.template load<PS, Idof>(i), right.template load<PS, Idof>(i));
+      }
+
+      /**
+       * @brief Like load, but the divisors of the lanes that are not set in p_valid are replaced by 1, so that
+       * filtered out rows can not trap on an integer division by zero.
+       */
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto load_selected(size_t i, typename PS::mask_type p_valid) const noexcept {
+        auto const lhs = left.template load_selected<PS, Idof>(i, p_valid);
+        auto const rhs = right.template load_selected<PS, Idof>(i, p_valid);
+        if constexpr (std::is_same_v<Operation, hints::arithmetic::div>) {
+          return arithmetic_t<PS>::template calc<PS>(
+            lhs, tsl::blend<PS, Idof>(p_valid, tsl::set1<PS, Idof>(typename PS::base_type{1}), rhs));
+        } else {
+          return arithmetic_t<PS>::template calc<PS>(lhs, rhs);
+        }
+      }
+
+      template <tsl::VectorProcessingStyle PS, typename Idof>
+      TSL_FORCE_INLINE auto gather(size_t const *positions) const noexcept {
+        return arithmetic_t<PS>::template calc<PS>(left.template gather<PS, Idof>(positions),
+                                                   right.template gather<PS, Idof>(positions));
+      }
+    };
+
+    template <typename T>
+    constexpr auto col(T const *p_data) noexcept -> column<T> {
+      return column<T>{{}, p_data};
+    }
+
+    template <typename T>
+    constexpr auto lit(T p_value) noexcept -> literal<T> {
+      return literal<T>{{}, p_value};
+    }
+
+    template <ExpressionNode L, ExpressionNode R>
+    constexpr auto operator+(L const &l, R const &r) noexcept {
+      return binary<hints::arithmetic::add, L, R>{{}, l, r};
+    }
+
+    template <ExpressionNode L, ExpressionNode R>
+    constexpr auto operator-(L const &l, R const &r) noexcept {
+      return binary<hints::arithmetic::sub, L, R>{{}, l, r};
+    }
+
+    template <ExpressionNode L, ExpressionNode R>
+    constexpr auto operator*(L const &l, R const &r) noexcept {
+      return binary<hints::arithmetic::mul, L, R>{{}, l, r};
+    }
+
+    template <ExpressionNode L, ExpressionNode R>
+    constexpr auto operator/(L const &l, R const &r) noexcept {
+      return binary<hints::arithmetic::div, L, R>{{}, l, r};
+    }
+  }  // namespace arithmetic_expression
+
+  /**
+   * @brief Evaluates an arithmetic expression tree in a single pass.
+   * @details Every register is loaded once per referenced column and all intermediate results stay in registers, so
+   * no intermediate column is materialized. Without a selection, one result is written per row. With a bit_mask or
+   * dense_bit_mask selection, only the results of the selected rows are written (compacted), and the divisors of the
+   * rows that are not selected are replaced by 1. With a position list, the leaves are gathered at the given positions.
+   *
+   * @tparam _SimdStyle The processing style. All columns and literals are evaluated with its base type.
+   * @tparam HintSet intermediate::{bit_mask, dense_bit_mask, position_list} select the kind of selection.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::intermediate::bit_mask>,
+            typename Idof = tsl::workaround>
+  class ArithmeticExpression {
+   public:
+    using SimdStyle = _SimdStyle;
+    using base_t = typename SimdStyle::base_type;
+    using DataSinkType = base_t *;
+
+   private:
+    using ScalarT = tsl::simd<base_t, tsl::scalar>;
+
+   public:
+    explicit ArithmeticExpression() = default;
+    ~ArithmeticExpression() = default;
+
+   public:
+    /**
+     * @brief Evaluates the expression for all rows [0, p_element_count).
+     * @return The end of the written result.
+     */
+    auto operator()(SimdOpsIterable auto p_result, arithmetic_expression::ExpressionNode auto const &p_expression,
+                    size_t p_element_count) const noexcept {
+      auto result = reinterpret_iterable<DataSinkType>(p_result);
+      auto const simd_element_count = p_element_count - (p_element_count % SimdStyle::vector_element_count());
+      size_t i = 0;
+      for (; i != simd_element_count; i += SimdStyle::vector_element_count()) {
+        tsl::storeu<SimdStyle, Idof>(result + i, p_expression.template load<SimdStyle, Idof>(i));
+      }
+      for (; i != p_element_count; ++i) {
+        result[i] = p_expression.template load<ScalarT, Idof>(i);
+      }
+      return result + p_element_count;
+    }
+
+    /**
+     * @brief Evaluates the expression for the rows selected by a bit_mask and writes the results consecutively.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_result, arithmetic_expression::ExpressionNode auto const &p_expression,
+                    size_t p_element_count, SimdOpsIterable auto p_valid_masks,
+                    activate_for_bit_mask<HS> = {}) const noexcept {
+      using UnsignedMaskType = std::make_unsigned_t<typename SimdStyle::imask_type>;
+      auto result = reinterpret_iterable<DataSinkType>(p_result);
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type const *>(p_valid_masks);
+      auto const simd_element_count = p_element_count - (p_element_count % SimdStyle::vector_element_count());
+      size_t i = 0;
+      for (; i != simd_element_count; i += SimdStyle::vector_element_count(), ++valid_masks) {
+        auto const valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        if (valid_mask == 0) {
+          continue;
+        }
+        tsl::compress_store<SimdStyle, Idof>(
+          valid_mask, result,
+          p_expression.template load_selected<SimdStyle, Idof>(i, tsl::load_mask<SimdStyle, Idof>(valid_masks)));
+        result += std::popcount(static_cast<UnsignedMaskType>(valid_mask));
+      }
+      if (i != p_element_count) {
+        auto const valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        for (size_t j = 0; i != p_element_count; ++i, ++j) {
+          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, j)) {
+            *result++ = p_expression.template load<ScalarT, Idof>(i);
+          }
+        }
+      }
+      return result;
+    }
+
+    /**
+     * @brief Evaluates the expression for the rows selected by a dense_bit_mask and writes the results consecutively.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_result, arithmetic_expression::ExpressionNode auto const &p_expression,
+                    size_t p_element_count, SimdOpsIterable auto p_valid_masks,
+                    activate_for_dense_bit_mask<HS> = {}) const noexcept {
+      using imask_type = typename SimdStyle::imask_type;
+      using UnsignedMaskType = std::make_unsigned_t<imask_type>;
+      constexpr size_t bits_per_mask = sizeof(imask_type) * CHAR_BIT;
+      constexpr size_t registers_per_mask = bits_per_mask / SimdStyle::vector_element_count();
+      constexpr UnsignedMaskType register_lanes = (SimdStyle::vector_element_count() == bits_per_mask)
+                                                    ? static_cast<UnsignedMaskType>(~UnsignedMaskType{0})
+                                                    : static_cast<UnsignedMaskType>(
+                                                        (UnsignedMaskType{1} << SimdStyle::vector_element_count()) - 1);
+      auto result = reinterpret_iterable<DataSinkType>(p_result);
+      auto valid_masks = reinterpret_iterable<imask_type const *>(p_valid_masks);
+      auto const batched_element_count = p_element_count - (p_element_count % bits_per_mask);
+      size_t i = 0;
+      for (; i != batched_element_count; ++valid_masks) {
+        auto const valid_mask = static_cast<UnsignedMaskType>(*valid_masks);
+        if (valid_mask == 0) {
+          i += bits_per_mask;
+          continue;
+        }
+        for (size_t r = 0; r < registers_per_mask; ++r, i += SimdStyle::vector_element_count()) {
+          auto const register_mask =
+            static_cast<UnsignedMaskType>((valid_mask >> (r * SimdStyle::vector_element_count())) & register_lanes);
+          auto const selected = static_cast<imask_type>(register_mask);
+          tsl::compress_store<SimdStyle, Idof>(
+            selected, result,
+            p_expression.template load_selected<SimdStyle, Idof>(i, tsl::load_mask<SimdStyle, Idof>(&selected)));
+          result += std::popcount(register_mask);
+        }
+      }
+      if (i != p_element_count) {
+        auto const valid_mask = *valid_masks;
+        for (size_t j = 0; i != p_element_count; ++i, ++j) {
+          if ((valid_mask >> j) & 1) {
+            *result++ = p_expression.template load<ScalarT, Idof>(i);
+          }
+        }
+      }
+      return result;
+    }
+
+    /**
+     * @brief Evaluates the expression at the given positions, the leaves are gathered.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_result, arithmetic_expression::ExpressionNode auto const &p_expression,
+                    SimdOpsIterable auto p_position_list, SimdOpsIterableOrSizeT auto p_position_list_end,
+                    activate_for_position_list<HS> = {}) const noexcept {
+      auto result = reinterpret_iterable<DataSinkType>(p_result);
+      auto positions = reinterpret_iterable<size_t const *>(p_position_list);
+      auto const end = iter_end(positions, p_position_list_end);
+      auto const batched_end = batched_iter_end<SimdStyle::vector_element_count()>(positions, p_position_list_end);
+      for (; positions != batched_end;
+           positions += SimdStyle::vector_element_count(), result += SimdStyle::vector_element_count()) {
+        tsl::storeu<SimdStyle, Idof>(result, p_expression.template gather<SimdStyle, Idof>(positions));
+      }
+      for (; positions != end; ++positions, ++result) {
+        *result = p_expression.template gather<ScalarT, Idof>(positions);
+      }
+      return result;
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStlye, class OtherHintSet, typename OtherIdof>
+    auto merge(ArithmeticExpression<OtherSimdStlye, OtherHintSet, OtherIdof> const &) noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_ARITHMETIC_EXPRESSION_HPP
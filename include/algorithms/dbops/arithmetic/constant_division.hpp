@@ -0,0 +1,86 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file constant_division.hpp
+ * @brief Division of an integer column by a scalar, e.g. for unit conversions and bucketing.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_CONSTANT_DIVISION_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_CONSTANT_DIVISION_HPP
+
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/constant_divider.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief Divides every element of an integer column by a divisor given at construction.
+   * @details The divisor is turned into a ConstantDivider once, every register is then divided via multiply-high and
+   * shifts instead of tsl::div. The quotient is truncated towards zero like the built-in operator /, a divisor of 0
+   * throws std::domain_error on construction.
+   *
+   * @tparam _SimdStyle
+   * @tparam HintSet
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::arithmetic::div>,
+            typename Idof = tsl::workaround>
+  class ConstantDivision {
+   public:
+    using SimdStyle = _SimdStyle;
+    using base_t = typename SimdStyle::base_type;
+    static_assert(std::is_integral_v<base_t>, "Use Arithmetic for floating point divisions.");
+    static_assert(has_hint<HintSet, hints::arithmetic::div>, "ConstantDivision only divides.");
+
+   private:
+    ConstantDivider<SimdStyle, Idof> const m_divider;
+
+   public:
+    explicit ConstantDivision(base_t p_divisor) : m_divider(p_divisor) {}
+
+    auto divisor() const noexcept -> base_t { return m_divider.divisor(); }
+
+    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end)
+      -> void {
+      auto const simd_end = tuddbs::simd_iter_end<SimdStyle>(p_data, p_end);
+      auto const scalar_end = tuddbs::iter_end(p_data, p_end);
+      for (; p_data != simd_end;
+           p_data += SimdStyle::vector_element_count(), p_result += SimdStyle::vector_element_count()) {
+        tsl::storeu<SimdStyle, Idof>(p_result, m_divider.divide(tsl::loadu<SimdStyle, Idof>(p_data)));
+      }
+      for (; p_data != scalar_end; ++p_data) {
+        *p_result++ = m_divider.divide_value(*p_data);
+      }
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStlye, class OtherHintSet, typename OtherIdof>
+    auto merge(ConstantDivision<OtherSimdStlye, OtherHintSet, OtherIdof> const &) noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  template <typename SimdStyle>
+  using col_constant_divider_t = tuddbs::ConstantDivision<SimdStyle>;
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_CONSTANT_DIVISION_HPP
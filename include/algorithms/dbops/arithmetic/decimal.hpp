@@ -0,0 +1,456 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file decimal.hpp
+ * @brief Arithmetic on fixed-point decimals, i.e. DECIMAL(precision, scale) columns stored as scaled integers.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DECIMAL_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DECIMAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "algorithms/dbops/arithmetic/arithmetic.hpp"
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+#include "algorithms/utils/constant_divider.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+  template <typename T>
+  constexpr T decimal_power_of_ten(size_t p_exponent) {
+    T result = 1;
+    for (size_t i = 0; i < p_exponent; ++i) {
+      result *= 10;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Describes a DECIMAL(_Precision, _Scale): _Precision digits in total, _Scale of them after the decimal point.
+   * @details A value v is stored as the integer v * 10^_Scale in the smallest signed type holding _Precision digits.
+   */
+  template <size_t _Precision, size_t _Scale>
+  struct decimal {
+    static_assert((_Precision >= 1) && (_Precision <= 38), "The precision has to be in [1, 38].");
+    static_assert(_Scale <= _Precision, "The scale must not exceed the precision.");
+
+    constexpr static size_t precision = _Precision;
+    constexpr static size_t scale = _Scale;
+    using storage_t =
+      std::conditional_t<(precision <= 9), int32_t, std::conditional_t<(precision <= 18), int64_t, __int128>>;
+    constexpr static storage_t scale_factor = decimal_power_of_ten<storage_t>(scale);
+    constexpr static storage_t max_value = decimal_power_of_ten<storage_t>(precision) - 1;
+  };
+
+  /**
+   * @brief Divides and rounds half away from zero, as SQL does for decimals.
+   */
+  template <typename T>
+  constexpr T decimal_round_divide(T p_numerator, T p_denominator) {
+    if (p_denominator < 0) {
+      p_numerator = -p_numerator;
+      p_denominator = -p_denominator;
+    }
+    T const half = p_denominator / 2;
+    return (p_numerator >= 0) ? (p_numerator + half) / p_denominator : (p_numerator - half) / p_denominator;
+  }
+
+  /**
+   * @brief Multiplies by 10^Shift, a negative Shift divides with rounding.
+   */
+  template <int Shift, typename T>
+  constexpr T decimal_rescale(T p_value) {
+    if constexpr (Shift > 0) {
+      return p_value * decimal_power_of_ten<T>(Shift);
+    } else if constexpr (Shift < 0) {
+      return decimal_round_divide(p_value, decimal_power_of_ten<T>(-Shift));
+    } else {
+      return p_value;
+    }
+  }
+
+  /**
+   * @brief Average of a sum of InputDecimal values, rounded to ResultDecimal. An empty group yields 0.
+   * @details Used for the results of DecimalGroupAggregate_Sum, whose sums keep the scale of the input.
+   */
+  template <class ResultDecimal, class InputDecimal, typename T>
+  constexpr auto decimal_average(T p_sum, size_t p_count) -> typename ResultDecimal::storage_t {
+    if (p_count == 0) {
+      return 0;
+    }
+    constexpr int shift = static_cast<int>(ResultDecimal::scale) - static_cast<int>(InputDecimal::scale);
+    using wide_t = std::conditional_t<(sizeof(T) < sizeof(int64_t)), int64_t, __int128>;
+    auto const count = static_cast<wide_t>(p_count);
+    if constexpr (shift >= 0) {
+      return static_cast<typename ResultDecimal::storage_t>(
+        decimal_round_divide(decimal_rescale<shift>(static_cast<wide_t>(p_sum)), count));
+    } else {
+      return static_cast<typename ResultDecimal::storage_t>(
+        decimal_round_divide(static_cast<wide_t>(p_sum), count * decimal_power_of_ten<wide_t>(-shift)));
+    }
+  }
+
+  /**
+   * @brief Scale-aware arithmetic on decimal columns.
+   * @details Both operand columns are stored in SimdStyle::base_type (int32_t for a precision up to 9, int64_t up to
+   * 18). The operation is selected via HintSet like for Arithmetic:
+   * - add, sub, mul, div: element-wise, the result is rescaled to ResultDecimal and rounded half away from zero. If the
+   *   intermediate result fits into base_type, the operation stays in SIMD registers: scaling down divides by a power
+   *   of ten with a ConstantDivider, divisions use the lane-wise division and round via the remainders. Otherwise, the
+   *   lanes are computed in the widened type (int64_t or __int128), e.g. for products whose digits exceed base_type.
+   * - sum, average: single-column reductions, accumulated in the widened type via Arithmetic. The result is a
+   *   ResultDecimal::storage_t.
+   * With hints::arithmetic::checked, results exceeding the precision of ResultDecimal throw std::overflow_error.
+   * Division by zero throws std::domain_error.
+   *
+   * @tparam _SimdStyle
+   * @tparam LhsDecimal Type of the first (or only) column.
+   * @tparam RhsDecimal Type of the second column.
+   * @tparam ResultDecimal Type of the result.
+   * @tparam HintSet
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class LhsDecimal, class RhsDecimal = LhsDecimal,
+            class ResultDecimal = LhsDecimal, class HintSet = OperatorHintSet<hints::arithmetic::add>,
+            typename Idof = tsl::workaround>
+  class DecimalArithmetic {
+   public:
+    using SimdStyle = _SimdStyle;
+    using reg_t = typename SimdStyle::register_type;
+    using base_t = typename SimdStyle::base_type;
+    using wide_t = std::conditional_t<(sizeof(base_t) == sizeof(int32_t)), int64_t, __int128>;
+    using result_t = typename ResultDecimal::storage_t;
+
+    static_assert(std::is_same_v<base_t, int32_t> || std::is_same_v<base_t, int64_t>,
+                  "Decimals are stored as int32_t or int64_t.");
+
+   private:
+    constexpr static size_t base_digits = (sizeof(base_t) == sizeof(int32_t)) ? 9 : 18;
+    static_assert((LhsDecimal::precision <= base_digits) && (RhsDecimal::precision <= base_digits),
+                  "The precision of the operands exceeds the base type.");
+
+    template <class HS>
+    constexpr static bool is_reduction = has_any_hint<HS, hints::arithmetic::sum, hints::arithmetic::average>;
+    constexpr static bool is_checked = has_hint<HintSet, hints::arithmetic::checked>;
+    static_assert(is_reduction<HintSet> || (ResultDecimal::precision <= base_digits),
+                  "Element-wise results are stored in the base type.");
+
+    constexpr static int result_scale = static_cast<int>(ResultDecimal::scale);
+    constexpr static int lhs_scale = static_cast<int>(LhsDecimal::scale);
+    constexpr static int rhs_scale = static_cast<int>(RhsDecimal::scale);
+    constexpr static int lhs_shift = result_scale - lhs_scale;
+    constexpr static int rhs_shift = result_scale - rhs_scale;
+    /* Sums and differences are computed exactly at the finer operand scale and rounded once. */
+    constexpr static int common_scale = std::max(lhs_scale, rhs_scale);
+    constexpr static int mul_shift = result_scale - (lhs_scale + rhs_scale);
+    constexpr static int div_shift = result_scale + rhs_scale - lhs_scale;
+
+    /* The scale at which sums and differences are computed in registers, rounded afterwards if it exceeds the result
+     * scale. */
+    constexpr static int add_sub_scale = std::max(common_scale, result_scale);
+    constexpr static int lhs_precision = static_cast<int>(LhsDecimal::precision);
+    constexpr static int rhs_precision = static_cast<int>(RhsDecimal::precision);
+    constexpr static bool add_sub_in_register =
+      (std::max(lhs_precision + add_sub_scale - lhs_scale, rhs_precision + add_sub_scale - rhs_scale) + 1 <=
+       static_cast<int>(base_digits));
+    constexpr static bool mul_in_register =
+      (lhs_precision + rhs_precision + std::max(mul_shift, 0) <= static_cast<int>(base_digits));
+    /* The dividend is upscaled for div_shift >= 0, the divisor otherwise. */
+    constexpr static bool div_in_register =
+      ((div_shift >= 0) ? (lhs_precision + div_shift) : (rhs_precision - div_shift)) <= static_cast<int>(base_digits);
+
+    template <class IntermediateHint>
+    using sum_hint_set =
+      std::conditional_t<is_checked,
+                         OperatorHintSet<hints::arithmetic::sum, hints::arithmetic::checked, IntermediateHint>,
+                         OperatorHintSet<hints::arithmetic::sum, IntermediateHint>>;
+
+    constexpr static bool calc_in_register =
+      (has_any_hint<HintSet, hints::arithmetic::add, hints::arithmetic::sub> && add_sub_in_register) ||
+      (has_hint<HintSet, hints::arithmetic::mul> && mul_in_register) ||
+      (has_hint<HintSet, hints::arithmetic::div> && div_in_register);
+
+    TSL_FORCE_INLINE static void check_result(wide_t p_value) {
+      if constexpr (is_checked) {
+        if ((p_value > ResultDecimal::max_value) || (p_value < -ResultDecimal::max_value)) {
+          throw std::overflow_error("DecimalArithmetic: The result exceeds the precision of the result type.");
+        }
+      }
+    }
+
+    TSL_FORCE_INLINE static void check_result(reg_t p_values) {
+      if constexpr (is_checked) {
+        auto const max_reg = tsl::set1<SimdStyle>(static_cast<base_t>(ResultDecimal::max_value));
+        auto const min_reg = tsl::set1<SimdStyle>(static_cast<base_t>(-ResultDecimal::max_value));
+        auto const out_of_range = tsl::to_integral<SimdStyle>(tsl::greater_than<SimdStyle>(p_values, max_reg)) |
+                                  tsl::to_integral<SimdStyle>(tsl::less_than<SimdStyle>(p_values, min_reg));
+        if (out_of_range != 0) {
+          throw std::overflow_error("DecimalArithmetic: The result exceeds the precision of the result type.");
+        }
+      }
+    }
+
+    TSL_FORCE_INLINE static reg_t upscale(reg_t p_values, int p_shift) {
+      if (p_shift == 0) {
+        return p_values;
+      }
+      return tsl::mul<SimdStyle>(p_values,
+                                 tsl::set1<SimdStyle>(decimal_power_of_ten<base_t>(static_cast<size_t>(p_shift))));
+    }
+
+    /**
+     * @brief The divider by 10^Shift, which is set up once.
+     */
+    template <int Shift>
+    static auto power_of_ten_divider() -> ConstantDivider<SimdStyle, Idof> const & {
+      static ConstantDivider<SimdStyle, Idof> const divider(decimal_power_of_ten<base_t>(static_cast<size_t>(Shift)));
+      return divider;
+    }
+
+    /**
+     * @brief Rounds truncated quotients half away from zero, i.e. moves a quotient one step away from zero if twice the
+     * magnitude of the remainder reaches the magnitude of the divisor. The remainder has the sign of the dividend.
+     */
+    TSL_FORCE_INLINE static reg_t round_quotients(reg_t p_quotients, reg_t p_remainders, reg_t p_divisor_magnitudes,
+                                                  reg_t p_steps) {
+      auto const zero = tsl::set1<SimdStyle>(0);
+      auto const remainder_magnitudes = tsl::blend<SimdStyle>(
+        tsl::less_than<SimdStyle>(p_remainders, zero), p_remainders, tsl::sub<SimdStyle>(zero, p_remainders));
+      auto const round_down = tsl::less_than<SimdStyle>(
+        tsl::add<SimdStyle>(remainder_magnitudes, remainder_magnitudes), p_divisor_magnitudes);
+      return tsl::add<SimdStyle>(p_quotients, tsl::blend<SimdStyle>(round_down, p_steps, zero));
+    }
+
+    /**
+     * @brief Divides by 10^Shift with rounding, using the multiply-high of a ConstantDivider instead of a division.
+     */
+    template <int Shift>
+    TSL_FORCE_INLINE static reg_t downscale(reg_t p_values) {
+      if constexpr (Shift == 0) {
+        return p_values;
+      } else {
+        auto const divisor = tsl::set1<SimdStyle>(decimal_power_of_ten<base_t>(static_cast<size_t>(Shift)));
+        auto const quotients = power_of_ten_divider<Shift>().divide(p_values);
+        auto const remainders = tsl::sub<SimdStyle>(p_values, tsl::mul<SimdStyle>(quotients, divisor));
+        auto const steps = tsl::blend<SimdStyle>(tsl::less_than<SimdStyle>(remainders, tsl::set1<SimdStyle>(0)),
+                                                 tsl::set1<SimdStyle>(1), tsl::set1<SimdStyle>(-1));
+        return round_quotients(quotients, remainders, divisor, steps);
+      }
+    }
+
+    /**
+     * @brief Divides by per-lane divisors with rounding. The divisors must not be 0.
+     */
+    TSL_FORCE_INLINE static reg_t round_divide(reg_t p_dividends, reg_t p_divisors) {
+      auto const zero = tsl::set1<SimdStyle>(0);
+      auto const quotients = tsl::div<SimdStyle>(p_dividends, p_divisors);
+      auto const remainders = tsl::sub<SimdStyle>(p_dividends, tsl::mul<SimdStyle>(quotients, p_divisors));
+      auto const negative_divisors = tsl::less_than<SimdStyle>(p_divisors, zero);
+      auto const divisor_magnitudes =
+        tsl::blend<SimdStyle>(negative_divisors, p_divisors, tsl::sub<SimdStyle>(zero, p_divisors));
+      // The quotient is negative if exactly one of dividend (i.e. remainder) and divisor is.
+      auto const steps = tsl::blend<SimdStyle>(tsl::less_than<SimdStyle>(remainders, zero), tsl::set1<SimdStyle>(1),
+                                               tsl::set1<SimdStyle>(-1));
+      return round_quotients(quotients, remainders, divisor_magnitudes,
+                             tsl::blend<SimdStyle>(negative_divisors, steps, tsl::sub<SimdStyle>(zero, steps)));
+    }
+
+    static auto count_selected(auto p_valid_masks, size_t p_element_count) -> size_t {
+      using imask_type = typename SimdStyle::imask_type;
+      using unsigned_imask_type = std::make_unsigned_t<imask_type>;
+      constexpr size_t bits_per_mask = SimdStyle::vector_element_count();
+      auto valid_masks = reinterpret_iterable<imask_type *>(p_valid_masks);
+      size_t count = 0;
+      for (size_t i = 0; i < p_element_count / bits_per_mask; ++i) {
+        count += std::popcount(static_cast<unsigned_imask_type>(valid_masks[i]));
+      }
+      if (auto const remainder = p_element_count % bits_per_mask; remainder != 0) {
+        count += std::popcount(static_cast<unsigned_imask_type>(valid_masks[p_element_count / bits_per_mask] &
+                                                                ((unsigned_imask_type{1} << remainder) - 1)));
+      }
+      return count;
+    }
+
+    static void write_reduction_result(auto p_result, wide_t p_sum, size_t p_count) {
+      if constexpr (has_hint<HintSet, hints::arithmetic::sum>) {
+        using sum_t = std::conditional_t<(sizeof(result_t) > sizeof(wide_t)), result_t, wide_t>;
+        auto const sum = decimal_rescale<lhs_shift>(static_cast<sum_t>(p_sum));
+        if constexpr (is_checked) {
+          if ((sum > ResultDecimal::max_value) || (sum < -ResultDecimal::max_value)) {
+            throw std::overflow_error("DecimalArithmetic: The result exceeds the precision of the result type.");
+          }
+        }
+        *p_result = static_cast<result_t>(sum);
+      } else {
+        *p_result = decimal_average<ResultDecimal, LhsDecimal>(p_sum, p_count);
+      }
+    }
+
+   public:
+    explicit DecimalArithmetic() {}
+
+    /**
+     * @brief Applies the operation to two scalar values.
+     */
+    static auto calc(base_t lhs, base_t rhs) -> base_t {
+      auto const wide_lhs = static_cast<wide_t>(lhs);
+      auto const wide_rhs = static_cast<wide_t>(rhs);
+      wide_t result;
+      if constexpr (has_hint<HintSet, hints::arithmetic::add>) {
+        result = decimal_rescale<result_scale - common_scale>(decimal_rescale<common_scale - lhs_scale>(wide_lhs) +
+                                                              decimal_rescale<common_scale - rhs_scale>(wide_rhs));
+      } else if constexpr (has_hint<HintSet, hints::arithmetic::sub>) {
+        result = decimal_rescale<result_scale - common_scale>(decimal_rescale<common_scale - lhs_scale>(wide_lhs) -
+                                                              decimal_rescale<common_scale - rhs_scale>(wide_rhs));
+      } else if constexpr (has_hint<HintSet, hints::arithmetic::mul>) {
+        result = decimal_rescale<mul_shift>(wide_lhs * wide_rhs);
+      } else if constexpr (has_hint<HintSet, hints::arithmetic::div>) {
+        if (rhs == 0) {
+          throw std::domain_error("DecimalArithmetic: Division by zero.");
+        }
+        if constexpr (div_shift >= 0) {
+          result = decimal_round_divide(decimal_rescale<div_shift>(wide_lhs), wide_rhs);
+        } else {
+          result = decimal_round_divide(wide_lhs, wide_rhs * decimal_power_of_ten<wide_t>(-div_shift));
+        }
+      } else {
+        throw std::runtime_error("No supported decimal operation found");
+      }
+      check_result(result);
+      return static_cast<base_t>(result);
+    }
+
+    /**
+     * @brief Applies the operation to two registers.
+     */
+    static auto calc(reg_t lhs, reg_t rhs) -> reg_t
+      requires(SimdStyle::vector_element_count() > 1)
+    {
+      if constexpr (calc_in_register) {
+        reg_t result;
+        if constexpr (has_hint<HintSet, hints::arithmetic::add>) {
+          result = downscale<add_sub_scale - result_scale>(tsl::add<SimdStyle>(
+            upscale(lhs, add_sub_scale - lhs_scale), upscale(rhs, add_sub_scale - rhs_scale)));
+        } else if constexpr (has_hint<HintSet, hints::arithmetic::sub>) {
+          result = downscale<add_sub_scale - result_scale>(tsl::sub<SimdStyle>(
+            upscale(lhs, add_sub_scale - lhs_scale), upscale(rhs, add_sub_scale - rhs_scale)));
+        } else if constexpr (has_hint<HintSet, hints::arithmetic::mul>) {
+          if constexpr (mul_shift >= 0) {
+            result = upscale(tsl::mul<SimdStyle>(lhs, rhs), mul_shift);
+          } else {
+            result = downscale<-mul_shift>(tsl::mul<SimdStyle>(lhs, rhs));
+          }
+        } else {
+          auto const zero = tsl::set1<SimdStyle>(0);
+          if (tsl::to_integral<SimdStyle>(tsl::equal<SimdStyle>(rhs, zero)) != 0) {
+            throw std::domain_error("DecimalArithmetic: Division by zero.");
+          }
+          if constexpr (div_shift >= 0) {
+            result = round_divide(upscale(lhs, div_shift), rhs);
+          } else {
+            result = round_divide(lhs, upscale(rhs, -div_shift));
+          }
+        }
+        check_result(result);
+        return result;
+      } else {
+        alignas(64) std::array<base_t, SimdStyle::vector_element_count()> lhs_values;
+        alignas(64) std::array<base_t, SimdStyle::vector_element_count()> rhs_values;
+        tsl::store<SimdStyle>(lhs_values.data(), lhs);
+        tsl::store<SimdStyle>(rhs_values.data(), rhs);
+        for (size_t i = 0; i < SimdStyle::vector_element_count(); ++i) {
+          lhs_values[i] = calc(lhs_values[i], rhs_values[i]);
+        }
+        return tsl::load<SimdStyle>(lhs_values.data());
+      }
+    }
+
+    /* Combining two decimal columns element-wise. */
+    template <class HS = HintSet>
+      requires(!is_reduction<HS>)
+    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data1, SimdOpsIterableOrSizeT auto p_end1,
+                    SimdOpsIterable auto p_data2) -> void {
+      auto const simd_end = tuddbs::simd_iter_end<SimdStyle>(p_data1, p_end1);
+      auto const scalar_end = tuddbs::iter_end(p_data1, p_end1);
+      if constexpr (SimdStyle::vector_element_count() > 1) {
+        for (; p_data1 != simd_end; p_data1 += SimdStyle::vector_element_count(),
+                                    p_data2 += SimdStyle::vector_element_count(),
+                                    p_result += SimdStyle::vector_element_count()) {
+          tsl::storeu<SimdStyle>(p_result, calc(tsl::loadu<SimdStyle>(p_data1), tsl::loadu<SimdStyle>(p_data2)));
+        }
+      }
+      for (; p_data1 != scalar_end; p_data1++, p_data2++) {
+        *p_result++ = calc(static_cast<base_t>(*p_data1), static_cast<base_t>(*p_data2));
+      }
+    }
+
+    /* Sum or average of a decimal column. */
+    template <class HS = HintSet>
+      requires(is_reduction<HS>)
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end) -> void {
+      using SumHintSet = sum_hint_set<hints::intermediate::position_list>;
+      size_t const element_count = tuddbs::iter_end(p_data, p_end) - p_data;
+      wide_t sum;
+      Arithmetic<SimdStyle, SumHintSet, wide_t>{}(&sum, p_data, p_end);
+      write_reduction_result(p_result, sum, element_count);
+    }
+
+    /* Sum or average of the elements of a decimal column selected by a bit_mask. */
+    template <class HS = HintSet>
+      requires(is_reduction<HS>)
+    auto operator()(ArithmeticReductionSink auto p_result, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                    activate_for_bit_mask<HS> = {}) -> void {
+      using SumHintSet = sum_hint_set<hints::intermediate::bit_mask>;
+      size_t const element_count = tuddbs::iter_end(p_data, p_end) - p_data;
+      wide_t sum;
+      Arithmetic<SimdStyle, SumHintSet, wide_t>{}(&sum, p_data, p_end, p_valid_masks);
+      write_reduction_result(p_result, sum, count_selected(p_valid_masks, element_count));
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStlye, class OtherLhsDecimal, class OtherRhsDecimal,
+              class OtherResultDecimal, class OtherHintSet, typename OtherIdof>
+    auto merge(DecimalArithmetic<OtherSimdStlye, OtherLhsDecimal, OtherRhsDecimal, OtherResultDecimal, OtherHintSet,
+                                 OtherIdof> const &) noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  /**
+   * @brief Per-group sums of a decimal column, accumulated in int64_t with the scale of Decimal.
+   * @details The sums can be turned into averages with decimal_average and the group sizes.
+   */
+  template <tsl::VectorProcessingStyle _KeySimdStyle, class Decimal,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>,
+            typename Idof = tsl::workaround>
+  using DecimalGroupAggregate_Sum =
+    GroupAggregate_Sum<_KeySimdStyle, typename Decimal::storage_t, HintSet, Idof, int64_t>;
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DECIMAL_HPP
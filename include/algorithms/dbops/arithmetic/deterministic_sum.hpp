@@ -0,0 +1,284 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file deterministic_sum.hpp
+ * @brief Unrolled Kahan summation and a floating point sum that is reproducible across partitionings.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DETERMINISTIC_SUM_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DETERMINISTIC_SUM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief UnrollFactor independent Kahan accumulators, combined in a fixed tree order.
+   * @details A single (sum, error) register pair serializes the loop on the latency of the floating point add. With
+   * UnrollFactor pairs, consecutive registers are added to different pairs and the adds can overlap. The pairs, and
+   * afterwards the lanes, are combined pairwise in an order that only depends on UnrollFactor and the vector width,
+   * thus the result is the same for every run over the same data.
+   *
+   * @tparam _SimdStyle
+   * @tparam UnrollFactor Number of independent accumulators, a power of two.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, size_t UnrollFactor = 4>
+  class UnrolledKahanAccumulator {
+   public:
+    using SimdStyle = _SimdStyle;
+    using reg_t = typename SimdStyle::register_type;
+    using base_t = typename SimdStyle::base_type;
+    static_assert(std::is_floating_point_v<base_t>, "Kahan summation is only needed for floating point types.");
+    static_assert((UnrollFactor != 0) && ((UnrollFactor & (UnrollFactor - 1)) == 0),
+                  "The unroll factor has to be a power of two.");
+
+    constexpr static size_t batch_size = UnrollFactor * SimdStyle::vector_element_count();
+
+   private:
+    std::array<reg_t, UnrollFactor> m_sums;
+    std::array<reg_t, UnrollFactor> m_errors;
+    base_t m_scalar_sum;
+    base_t m_scalar_error;
+
+    TSL_FORCE_INLINE static void kahan_add(base_t &sum, base_t &error, base_t val) {
+      base_t const y = val - error;
+      base_t const t = sum + y;
+      error = (t - sum) - y;
+      sum = t;
+    }
+
+    // Adds the compensated value (sum, error) to (p_sum, p_error).
+    TSL_FORCE_INLINE static void kahan_combine(base_t &p_sum, base_t &p_error, base_t sum, base_t error) {
+      base_t const y = (sum - error) - p_error;
+      base_t const t = p_sum + y;
+      p_error = (t - p_sum) - y;
+      p_sum = t;
+    }
+
+   public:
+    UnrolledKahanAccumulator() : m_scalar_sum(0), m_scalar_error(0) {
+      m_sums.fill(tsl::set1<SimdStyle>(0));
+      m_errors.fill(tsl::set1<SimdStyle>(0));
+    }
+
+    TSL_FORCE_INLINE void update(size_t p_accumulator, reg_t vals) {
+      auto &sum = m_sums[p_accumulator];
+      auto &error = m_errors[p_accumulator];
+      reg_t const y = tsl::sub<SimdStyle>(vals, error);
+      reg_t const t = tsl::add<SimdStyle>(sum, y);
+      error = tsl::sub<SimdStyle>(tsl::sub<SimdStyle>(t, sum), y);
+      sum = t;
+    }
+
+    TSL_FORCE_INLINE void update(size_t p_accumulator, typename SimdStyle::mask_type valid_mask, reg_t vals) {
+      update(p_accumulator, tsl::maskz_mov<SimdStyle>(valid_mask, vals));
+    }
+
+    TSL_FORCE_INLINE void update(base_t val) { kahan_add(m_scalar_sum, m_scalar_error, val); }
+
+    /**
+     * @brief Adds batch_size consecutive elements, one register to every accumulator.
+     */
+    TSL_FORCE_INLINE void update_batch(SimdOpsIterable auto p_data) {
+      for (size_t i = 0; i < UnrollFactor; ++i) {
+        update(i, tsl::loadu<SimdStyle>(p_data + i * SimdStyle::vector_element_count()));
+      }
+    }
+
+    /**
+     * @brief Adds the selected elements of batch_size consecutive elements, p_valid_masks holds one mask per register.
+     */
+    TSL_FORCE_INLINE void update_batch(SimdOpsIterable auto p_data, SimdOpsIterable auto p_valid_masks) {
+      for (size_t i = 0; i < UnrollFactor; ++i) {
+        update(i, tsl::load_mask<SimdStyle>(p_valid_masks + i),
+               tsl::loadu<SimdStyle>(p_data + i * SimdStyle::vector_element_count()));
+      }
+    }
+
+    auto result() const -> base_t {
+      auto sums = m_sums;
+      auto errors = m_errors;
+      for (size_t stride = UnrollFactor / 2; stride != 0; stride /= 2) {
+        for (size_t i = 0; i < stride; ++i) {
+          reg_t const y =
+            tsl::sub<SimdStyle>(tsl::sub<SimdStyle>(sums[i + stride], errors[i + stride]), errors[i]);
+          reg_t const t = tsl::add<SimdStyle>(sums[i], y);
+          errors[i] = tsl::sub<SimdStyle>(tsl::sub<SimdStyle>(t, sums[i]), y);
+          sums[i] = t;
+        }
+      }
+      alignas(64) std::array<base_t, SimdStyle::vector_element_count()> lane_sums;
+      alignas(64) std::array<base_t, SimdStyle::vector_element_count()> lane_errors;
+      tsl::store<SimdStyle>(lane_sums.data(), sums[0]);
+      tsl::store<SimdStyle>(lane_errors.data(), errors[0]);
+      for (size_t stride = SimdStyle::vector_element_count() / 2; stride != 0; stride /= 2) {
+        for (size_t i = 0; i < stride; ++i) {
+          kahan_combine(lane_sums[i], lane_errors[i], lane_sums[i + stride], lane_errors[i + stride]);
+        }
+      }
+      kahan_combine(lane_sums[0], lane_errors[0], m_scalar_sum, m_scalar_error);
+      return lane_sums[0] - lane_errors[0];
+    }
+  };
+
+  /**
+   * @brief Floating point sum whose result does not depend on how the column is split among threads.
+   * @details The column is divided into blocks of BlockSize rows, counted from the first row of the column. Every
+   * block is summed with an UnrolledKahanAccumulator starting at its first row, the block sums are combined in a
+   * pairwise tree over the block indices during finalize(). Thus, as long as every partition starts at a block boundary
+   * (p_start_position), the result is bit-for-bit identical for any number of partitions and any order of merge().
+   *
+   * @tparam _SimdStyle
+   * @tparam HintSet intermediate::position_list (all rows) or intermediate::bit_mask (selected rows).
+   * @tparam UnrollFactor Number of independent accumulators per block.
+   * @tparam BlockSize Rows per block, a multiple of UnrollFactor * vector_element_count().
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::intermediate::position_list>,
+            size_t UnrollFactor = 4, size_t BlockSize = size_t{1} << 14, typename Idof = tsl::workaround>
+  class DeterministicSum {
+   public:
+    using SimdStyle = _SimdStyle;
+    using base_t = typename SimdStyle::base_type;
+    using accumulator_t = UnrolledKahanAccumulator<SimdStyle, UnrollFactor>;
+    static_assert((BlockSize % accumulator_t::batch_size) == 0,
+                  "The block size has to be a multiple of the accumulator batch size.");
+
+   private:
+    struct block_sum_t {
+      size_t block;
+      base_t sum;
+    };
+
+    std::vector<block_sum_t> m_block_sums;
+    size_t m_count;
+    base_t m_result;
+
+    static auto pairwise_sum(block_sum_t const *p_begin, size_t p_count) -> base_t {
+      if (p_count == 1) {
+        return p_begin->sum;
+      }
+      auto const half = p_count / 2;
+      return pairwise_sum(p_begin, half) + pairwise_sum(p_begin + half, p_count - half);
+    }
+
+   public:
+    explicit DeterministicSum() : m_count(0), m_result(0) {}
+    ~DeterministicSum() = default;
+
+   public:
+    auto count() const noexcept -> size_t { return m_count; }
+    auto result() const noexcept -> base_t { return m_result; }
+    auto average() const noexcept -> double { return static_cast<double>(m_result) / m_count; }
+
+    /**
+     * @brief Sums [p_data, p_end), where p_data is row p_start_position of the column.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, size_t p_start_position = 0,
+                    activate_for_position_list<HS> = {}) -> void {
+      assert((p_start_position % BlockSize) == 0);
+      auto const end = iter_end(p_data, p_end);
+      size_t block = p_start_position / BlockSize;
+      while (p_data != end) {
+        auto const block_end = iter_end(p_data, std::min<size_t>(BlockSize, end - p_data));
+        auto const batched_end = batched_iter_end<accumulator_t::batch_size>(p_data, block_end);
+        auto const simd_end = simd_iter_end<SimdStyle>(p_data, block_end);
+        m_count += block_end - p_data;
+        accumulator_t accumulator;
+        for (; p_data != batched_end; p_data += accumulator_t::batch_size) {
+          accumulator.update_batch(p_data);
+        }
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
+          accumulator.update(0, tsl::loadu<SimdStyle>(p_data));
+        }
+        for (; p_data != block_end; ++p_data) {
+          accumulator.update(*p_data);
+        }
+        m_block_sums.push_back(block_sum_t{block++, accumulator.result()});
+      }
+    }
+
+    /**
+     * @brief Sums the selected rows of [p_data, p_end), where p_data is row p_start_position of the column.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                    size_t p_start_position = 0, activate_for_bit_mask<HS> = {}) -> void {
+      assert((p_start_position % BlockSize) == 0);
+      auto const end = iter_end(p_data, p_end);
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type const *>(p_valid_masks);
+      size_t block = p_start_position / BlockSize;
+      while (p_data != end) {
+        auto const block_end = iter_end(p_data, std::min<size_t>(BlockSize, end - p_data));
+        auto const batched_end = batched_iter_end<accumulator_t::batch_size>(p_data, block_end);
+        auto const simd_end = simd_iter_end<SimdStyle>(p_data, block_end);
+        accumulator_t accumulator;
+        for (; p_data != batched_end; p_data += accumulator_t::batch_size, valid_masks += UnrollFactor) {
+          accumulator.update_batch(p_data, valid_masks);
+          for (size_t i = 0; i < UnrollFactor; ++i) {
+            m_count += tsl::mask_population_count<SimdStyle>(tsl::load_mask<SimdStyle>(valid_masks + i));
+          }
+        }
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
+          auto const valid_mask = tsl::load_mask<SimdStyle>(valid_masks);
+          accumulator.update(0, valid_mask, tsl::loadu<SimdStyle>(p_data));
+          m_count += tsl::mask_population_count<SimdStyle>(valid_mask);
+        }
+        if (p_data != block_end) {
+          auto valid_mask = tsl::load_imask<SimdStyle>(valid_masks);
+          for (; p_data != block_end; ++p_data) {
+            if ((valid_mask & 0b1) == 0b1) {
+              accumulator.update(*p_data);
+              ++m_count;
+            }
+            valid_mask >>= 1;
+          }
+        }
+        m_block_sums.push_back(block_sum_t{block++, accumulator.result()});
+      }
+    }
+
+    auto merge(DeterministicSum const &other) -> void {
+      m_block_sums.insert(m_block_sums.end(), other.m_block_sums.cbegin(), other.m_block_sums.cend());
+      m_count += other.m_count;
+    }
+
+    auto finalize() -> void {
+      if (m_block_sums.empty()) {
+        m_result = 0;
+        return;
+      }
+      std::sort(m_block_sums.begin(), m_block_sums.end(),
+                [](block_sum_t const &lhs, block_sum_t const &rhs) { return lhs.block < rhs.block; });
+      m_result = pairwise_sum(m_block_sums.data(), m_block_sums.size());
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_DETERMINISTIC_SUM_HPP
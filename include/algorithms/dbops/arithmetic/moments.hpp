@@ -0,0 +1,301 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file moments.hpp
+ * @brief Single-pass mean, variance and covariance via per-lane Welford updates.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_MOMENTS_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_MOMENTS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief Count, means and central moments of one or two columns.
+   * @details m2 is the sum of squared deviations from the mean, co_moment the sum of the products of the deviations of
+   * both columns. The members of the second column stay 0 without hints::arithmetic::covariance.
+   */
+  template <typename T>
+  struct arithmetic_moments_t {
+    size_t count = 0;
+    T mean = 0;
+    T m2 = 0;
+    T mean_y = 0;
+    T m2_y = 0;
+    T co_moment = 0;
+
+    auto population_variance() const -> T { return m2 / count; }
+    auto sample_variance() const -> T { return m2 / (count - 1); }
+    auto population_standard_deviation() const -> T { return std::sqrt(population_variance()); }
+    auto sample_standard_deviation() const -> T { return std::sqrt(sample_variance()); }
+    auto population_covariance() const -> T { return co_moment / count; }
+    auto sample_covariance() const -> T { return co_moment / (count - 1); }
+
+    /**
+     * @brief Welford update with a single row.
+     */
+    auto update(T x, T y = 0) -> void {
+      ++count;
+      T const delta_x = x - mean;
+      mean += delta_x / count;
+      m2 += delta_x * (x - mean);
+      T const delta_y = y - mean_y;
+      mean_y += delta_y / count;
+      m2_y += delta_y * (y - mean_y);
+      co_moment += delta_x * (y - mean_y);
+    }
+
+    /**
+     * @brief Combines the moments of two disjoint sets of rows (Chan et al.).
+     */
+    auto merge(arithmetic_moments_t const &other) -> void {
+      if (other.count == 0) {
+        return;
+      }
+      if (count == 0) {
+        *this = other;
+        return;
+      }
+      T const count_a = static_cast<T>(count);
+      T const count_b = static_cast<T>(other.count);
+      T const weight = count_a * count_b / (count_a + count_b);
+      T const delta_x = other.mean - mean;
+      T const delta_y = other.mean_y - mean_y;
+      mean += delta_x * (count_b / (count_a + count_b));
+      mean_y += delta_y * (count_b / (count_a + count_b));
+      m2 += other.m2 + delta_x * delta_x * weight;
+      m2_y += other.m2_y + delta_y * delta_y * weight;
+      co_moment += other.co_moment + delta_x * delta_y * weight;
+      count += other.count;
+    }
+  };
+
+  /**
+   * @brief Streaming mean, M2 and (optionally) the co-moment with a second column in a single pass.
+   * @details Every lane runs its own Welford recurrence, which avoids the cancellation of the sum-of-squares formula.
+   * The lane counts are kept in registers of the base type, so the lanes are folded into the scalar result every
+   * BlockSize rows, while the counts are still exact. Without a selection, all lanes share the same count and the
+   * division is replaced by a multiplication with the broadcasted reciprocal. Partial results of different partitions
+   * are combined via merge().
+   *
+   * @tparam _SimdStyle A floating point processing style.
+   * @tparam HintSet intermediate::position_list (all rows) or intermediate::bit_mask (selected rows), and
+   * arithmetic::covariance to take a second column.
+   * @tparam BlockSize Rows per block, a multiple of vector_element_count().
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::intermediate::position_list>,
+            size_t BlockSize = size_t{1} << 14, typename Idof = tsl::workaround>
+  class StreamingMoments {
+   public:
+    using SimdStyle = _SimdStyle;
+    using reg_t = typename SimdStyle::register_type;
+    using base_t = typename SimdStyle::base_type;
+    using result_t = arithmetic_moments_t<base_t>;
+    static_assert(std::is_floating_point_v<base_t>, "Moments are computed on floating point columns.");
+    static_assert((BlockSize % SimdStyle::vector_element_count()) == 0,
+                  "The block size has to be a multiple of the vector element count.");
+
+   private:
+    constexpr static bool with_co_moment = has_hint<HintSet, hints::arithmetic::covariance>;
+
+    /**
+     * @brief Welford state of every lane.
+     */
+    class LaneMoments {
+      reg_t m_count;
+      reg_t m_mean;
+      reg_t m_m2;
+      reg_t m_mean_y;
+      reg_t m_m2_y;
+      reg_t m_co_moment;
+
+     public:
+      LaneMoments()
+        : m_count(tsl::set1<SimdStyle>(0)),
+          m_mean(tsl::set1<SimdStyle>(0)),
+          m_m2(tsl::set1<SimdStyle>(0)),
+          m_mean_y(tsl::set1<SimdStyle>(0)),
+          m_m2_y(tsl::set1<SimdStyle>(0)),
+          m_co_moment(tsl::set1<SimdStyle>(0)) {}
+
+      // All lanes are updated, p_reciprocal_count is 1 / (count including x).
+      TSL_FORCE_INLINE void update(reg_t x, reg_t y, reg_t p_reciprocal_count) {
+        m_count = tsl::add<SimdStyle>(m_count, tsl::set1<SimdStyle>(1));
+        auto const delta_x = tsl::sub<SimdStyle>(x, m_mean);
+        m_mean = tsl::add<SimdStyle>(m_mean, tsl::mul<SimdStyle>(delta_x, p_reciprocal_count));
+        m_m2 = tsl::add<SimdStyle>(m_m2, tsl::mul<SimdStyle>(delta_x, tsl::sub<SimdStyle>(x, m_mean)));
+        if constexpr (with_co_moment) {
+          auto const delta_y = tsl::sub<SimdStyle>(y, m_mean_y);
+          m_mean_y = tsl::add<SimdStyle>(m_mean_y, tsl::mul<SimdStyle>(delta_y, p_reciprocal_count));
+          auto const deviation_y = tsl::sub<SimdStyle>(y, m_mean_y);
+          m_m2_y = tsl::add<SimdStyle>(m_m2_y, tsl::mul<SimdStyle>(delta_y, deviation_y));
+          m_co_moment = tsl::add<SimdStyle>(m_co_moment, tsl::mul<SimdStyle>(delta_x, deviation_y));
+        }
+      }
+
+      // Only the selected lanes are updated, the others are restored via blend.
+      TSL_FORCE_INLINE void update(typename SimdStyle::mask_type valid_mask, reg_t x, reg_t y) {
+        m_count = tsl::add<SimdStyle>(valid_mask, m_count, tsl::set1<SimdStyle>(1));
+        auto const delta_x = tsl::sub<SimdStyle>(x, m_mean);
+        // Unselected lanes may divide by a count of 0, their results are discarded.
+        m_mean = tsl::blend<SimdStyle>(valid_mask, m_mean,
+                                       tsl::add<SimdStyle>(m_mean, tsl::div<SimdStyle>(delta_x, m_count)));
+        m_m2 = tsl::add<SimdStyle>(valid_mask, m_m2, tsl::mul<SimdStyle>(delta_x, tsl::sub<SimdStyle>(x, m_mean)));
+        if constexpr (with_co_moment) {
+          auto const delta_y = tsl::sub<SimdStyle>(y, m_mean_y);
+          m_mean_y = tsl::blend<SimdStyle>(valid_mask, m_mean_y,
+                                           tsl::add<SimdStyle>(m_mean_y, tsl::div<SimdStyle>(delta_y, m_count)));
+          auto const deviation_y = tsl::sub<SimdStyle>(y, m_mean_y);
+          m_m2_y = tsl::add<SimdStyle>(valid_mask, m_m2_y, tsl::mul<SimdStyle>(delta_y, deviation_y));
+          m_co_moment = tsl::add<SimdStyle>(valid_mask, m_co_moment, tsl::mul<SimdStyle>(delta_x, deviation_y));
+        }
+      }
+
+      // Folds the lanes into p_result in lane order.
+      auto fold_into(result_t &p_result) const -> void {
+        constexpr size_t lanes = SimdStyle::vector_element_count();
+        std::array<base_t, lanes> count;
+        std::array<base_t, lanes> mean;
+        std::array<base_t, lanes> m2;
+        std::array<base_t, lanes> mean_y;
+        std::array<base_t, lanes> m2_y;
+        std::array<base_t, lanes> co_moment;
+        tsl::storeu<SimdStyle>(count.data(), m_count);
+        tsl::storeu<SimdStyle>(mean.data(), m_mean);
+        tsl::storeu<SimdStyle>(m2.data(), m_m2);
+        tsl::storeu<SimdStyle>(mean_y.data(), m_mean_y);
+        tsl::storeu<SimdStyle>(m2_y.data(), m_m2_y);
+        tsl::storeu<SimdStyle>(co_moment.data(), m_co_moment);
+        for (size_t i = 0; i < lanes; ++i) {
+          p_result.merge(result_t{static_cast<size_t>(count[i]), mean[i], m2[i], mean_y[i], m2_y[i], co_moment[i]});
+        }
+      }
+    };
+
+    result_t m_result;
+
+    /**
+     * @brief Processes [p_data, p_end) block by block.
+     * @details p_data_y and p_valid_masks are only read if enabled, otherwise they are nullptr.
+     */
+    template <bool Selected>
+    auto process(auto p_data, auto p_end, auto p_data_y, auto p_valid_masks) -> void {
+      constexpr size_t lanes = SimdStyle::vector_element_count();
+      auto const end = iter_end(p_data, p_end);
+      while (p_data != end) {
+        auto const block_end = iter_end(p_data, std::min<size_t>(BlockSize, end - p_data));
+        auto const simd_end = simd_iter_end<SimdStyle>(p_data, block_end);
+        LaneMoments lane_moments;
+        size_t block_count = 0;
+        for (; p_data != simd_end; p_data += lanes) {
+          auto const x = tsl::loadu<SimdStyle>(p_data);
+          reg_t y = x;
+          if constexpr (with_co_moment) {
+            y = tsl::loadu<SimdStyle>(p_data_y);
+            p_data_y += lanes;
+          }
+          if constexpr (Selected) {
+            lane_moments.update(tsl::load_mask<SimdStyle>(p_valid_masks), x, y);
+            ++p_valid_masks;
+          } else {
+            ++block_count;
+            lane_moments.update(x, y, tsl::set1<SimdStyle>(base_t{1} / static_cast<base_t>(block_count)));
+          }
+        }
+        lane_moments.fold_into(m_result);
+        if (p_data != block_end) {
+          typename SimdStyle::imask_type valid_mask = 0;
+          if constexpr (Selected) {
+            valid_mask = tsl::load_imask<SimdStyle>(p_valid_masks);
+          }
+          for (; p_data != block_end; ++p_data) {
+            base_t y = 0;
+            if constexpr (with_co_moment) {
+              y = *p_data_y;
+              ++p_data_y;
+            }
+            if (!Selected || ((valid_mask & 0b1) == 0b1)) {
+              m_result.update(*p_data, y);
+            }
+            valid_mask >>= 1;
+          }
+        }
+      }
+    }
+
+   public:
+    explicit StreamingMoments() = default;
+    ~StreamingMoments() = default;
+
+   public:
+    auto result() const noexcept -> result_t const & { return m_result; }
+    auto count() const noexcept -> size_t { return m_result.count; }
+
+    /* Moments of all rows of a column. */
+    template <class HS = HintSet>
+      requires(!with_co_moment)
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    activate_for_position_list<HS> = {}) -> void {
+      process<false>(p_data, p_end, nullptr, nullptr);
+    }
+
+    /* Moments of the selected rows of a column. */
+    template <class HS = HintSet>
+      requires(!with_co_moment)
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                    activate_for_bit_mask<HS> = {}) -> void {
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type const *>(p_valid_masks);
+      process<true>(p_data, p_end, nullptr, valid_masks);
+    }
+
+    /* Moments and co-moment of all rows of two columns. */
+    template <class HS = HintSet>
+      requires(with_co_moment)
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_data_y,
+                    activate_for_position_list<HS> = {}) -> void {
+      process<false>(p_data, p_end, p_data_y, nullptr);
+    }
+
+    /* Moments and co-moment of the selected rows of two columns. */
+    template <class HS = HintSet>
+      requires(with_co_moment)
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_data_y,
+                    SimdOpsIterable auto p_valid_masks, activate_for_bit_mask<HS> = {}) -> void {
+      process<true>(p_data, p_end, p_data_y,
+                    reinterpret_iterable<typename SimdStyle::imask_type const *>(p_valid_masks));
+    }
+
+    auto merge(StreamingMoments const &other) -> void { m_result.merge(other.m_result); }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_ARITHMETIC_MOMENTS_HPP
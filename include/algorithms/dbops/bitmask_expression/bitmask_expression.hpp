@@ -0,0 +1,256 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file bitmask_expression.hpp
+ * @brief N-ary combination of bitmasks, described by a compile-time expression tree.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_BITMASK_EXPRESSION_BITMASK_EXPRESSION_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_BITMASK_EXPRESSION_BITMASK_EXPRESSION_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  namespace hints {
+    namespace operators {
+      namespace bitmask_expression {
+        /**
+         * @brief Tag to request the population count of the combined bitmask.
+         */
+        struct count_bits {};
+      }  // namespace bitmask_expression
+    }    // namespace operators
+  }      // namespace hints
+
+  /**
+   * @brief Nodes of a bitmask expression tree.
+   * @details A WHERE clause like (a AND b) OR (c ANDNOT d) is expressed as
+   * op_or<op_and<input<0>, input<1>>, op_andnot<input<2>, input<3>>>. The index of an input refers to the position of
+   * the corresponding bitmask in the argument list of BitmaskExpression::operator().
+   */
+  namespace bitmask_expression {
+    template <size_t Index>
+    struct input {
+      constexpr static size_t input_count = Index + 1;
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        return inputs[Index];
+      }
+    };
+
+    template <class Left, class Right, class... Rest>
+    struct op_and {
+      constexpr static size_t input_count = std::max({Left::input_count, Right::input_count, Rest::input_count...});
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        auto result = tsl::binary_and<PS, Idof>(Left::template apply<PS, Idof>(inputs),
+                                                 Right::template apply<PS, Idof>(inputs));
+        ((result = tsl::binary_and<PS, Idof>(result, Rest::template apply<PS, Idof>(inputs))), ...);
+        return result;
+      }
+    };
+
+    template <class Left, class Right, class... Rest>
+    struct op_or {
+      constexpr static size_t input_count = std::max({Left::input_count, Right::input_count, Rest::input_count...});
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        auto result = tsl::binary_or<PS, Idof>(Left::template apply<PS, Idof>(inputs),
+                                                Right::template apply<PS, Idof>(inputs));
+        ((result = tsl::binary_or<PS, Idof>(result, Rest::template apply<PS, Idof>(inputs))), ...);
+        return result;
+      }
+    };
+
+    template <class Left, class Right, class... Rest>
+    struct op_xor {
+      constexpr static size_t input_count = std::max({Left::input_count, Right::input_count, Rest::input_count...});
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        auto result = tsl::binary_xor<PS, Idof>(Left::template apply<PS, Idof>(inputs),
+                                                 Right::template apply<PS, Idof>(inputs));
+        ((result = tsl::binary_xor<PS, Idof>(result, Rest::template apply<PS, Idof>(inputs))), ...);
+        return result;
+      }
+    };
+
+    /**
+     * @brief Left AND NOT Right.
+     */
+    template <class Left, class Right>
+    struct op_andnot {
+      constexpr static size_t input_count = std::max(Left::input_count, Right::input_count);
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        return tsl::binary_and<PS, Idof>(Left::template apply<PS, Idof>(inputs),
+                                         tsl::binary_not<PS, Idof>(Right::template apply<PS, Idof>(inputs)));
+      }
+    };
+
+    template <class Operand>
+    struct op_not {
+      constexpr static size_t input_count = Operand::input_count;
+
+      template <tsl::VectorProcessingStyle PS, typename Idof, typename InputArray>
+      TSL_FORCE_INLINE static auto apply(InputArray const &inputs) noexcept {
+        return tsl::binary_not<PS, Idof>(Operand::template apply<PS, Idof>(inputs));
+      }
+    };
+  }  // namespace bitmask_expression
+
+  /**
+   * @brief Combines K bitmasks into a single bitmask in one pass.
+   * @details Instead of chaining Intersection and Union (which requires K-1 passes and K-2 intermediate bitmasks), the
+   * whole expression tree is evaluated register by register and only the final result is written. The bitmasks are
+   * interpreted as arrays of SimdStyle::base_type words, thus the operator works for both bit_mask and dense_bit_mask
+   * intermediates.
+   *
+   * @tparam _SimdStyle The TSL processing style. The base type has to be the integral word type of the bitmasks.
+   * @tparam Expression The expression tree, built from the nodes in tuddbs::bitmask_expression.
+   * @tparam HintSet Supported hints: memory::aligned, operators::bitmask_expression::count_bits.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class Expression,
+            class HintSet = OperatorHintSet<hints::intermediate::bit_mask>, typename Idof = tsl::workaround>
+  class BitmaskExpression {
+    static_assert(std::is_integral_v<typename _SimdStyle::base_type>,
+                  "Bitmasks have to be processed with an integral base type.");
+    static_assert(!has_hint<HintSet, hints::intermediate::position_list>,
+                  "Bitmask expressions can not be applied to position lists.");
+
+   public:
+    using SimdStyle = _SimdStyle;
+    using ResultType = typename SimdStyle::base_type;
+    using DataSinkType = ResultType *;
+    constexpr static size_t input_count = Expression::input_count;
+    constexpr static bool CountBits = has_hint<HintSet, hints::operators::bitmask_expression::count_bits>;
+
+   private:
+    using ScalarT = tsl::simd<ResultType, tsl::scalar>;
+    constexpr static size_t bits_per_word = sizeof(ResultType) * CHAR_BIT;
+
+    size_t const m_element_count;
+
+   public:
+    /**
+     * @param p_element_count Optional number of valid bits. If given, the padding bits of the last word are cleared,
+     * which is required for expressions that contain a top-level NOT.
+     */
+    explicit BitmaskExpression(size_t p_element_count = 0) : m_element_count(p_element_count) {}
+    ~BitmaskExpression() = default;
+
+   public:
+    constexpr size_t byte_count(SimdOpsIterable auto p_start, SimdOpsIterableOrSizeT auto p_end) {
+      auto it_end = iter_end(p_start, p_end);
+      auto dist = it_end - p_start;
+      return dist * sizeof(ResultType);
+    }
+
+    /**
+     * @brief Evaluates the expression over all input bitmasks.
+     *
+     * @param p_result Sink for the combined bitmask (same number of words as the inputs).
+     * @param p_first_data Bitmask referenced by input<0>.
+     * @param p_first_end End iterator or word count of the bitmasks.
+     * @param p_other_data Bitmasks referenced by input<1> ... input<K-1>.
+     * @return The end of the written result, paired with the population count if count_bits was requested.
+     */
+    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_first_data,
+                    SimdOpsIterableOrSizeT auto p_first_end, SimdOpsIterable auto... p_other_data) const noexcept {
+      static_assert(1 + sizeof...(p_other_data) == input_count,
+                    "The number of bitmasks does not match the number of inputs of the expression.");
+      auto const simd_end = simd_iter_end<SimdStyle>(p_first_data, p_first_end);
+      auto const end = iter_end(p_first_data, p_first_end);
+      size_t const word_count = end - p_first_data;
+      size_t const simd_word_count = simd_end - p_first_data;
+
+      std::array<ResultType const *, input_count> sources{reinterpret_iterable<ResultType const *>(p_first_data),
+                                                          reinterpret_iterable<ResultType const *>(p_other_data)...};
+      auto result = reinterpret_iterable<DataSinkType>(p_result);
+      size_t population_count = 0;
+
+      std::array<typename SimdStyle::register_type, input_count> regs;
+      size_t i = 0;
+      for (; i != simd_word_count; i += SimdStyle::vector_element_count()) {
+        for (size_t k = 0; k < input_count; ++k) {
+          if constexpr (has_hint<HintSet, hints::memory::aligned>) {
+            regs[k] = tsl::load<SimdStyle, Idof>(sources[k] + i);
+          } else {
+            regs[k] = tsl::loadu<SimdStyle, Idof>(sources[k] + i);
+          }
+        }
+        auto const combined = Expression::template apply<SimdStyle, Idof>(regs);
+        if constexpr (has_hint<HintSet, hints::memory::aligned>) {
+          tsl::store<SimdStyle, Idof>(result + i, combined);
+        } else {
+          tsl::storeu<SimdStyle, Idof>(result + i, combined);
+        }
+        if constexpr (CountBits) {
+          // The words were just written and are still in L1, counting them is cheaper than a second pass.
+          for (size_t j = 0; j < SimdStyle::vector_element_count(); ++j) {
+            population_count += std::popcount(static_cast<std::make_unsigned_t<ResultType>>(result[i + j]));
+          }
+        }
+      }
+      std::array<ResultType, input_count> words;
+      for (; i != word_count; ++i) {
+        for (size_t k = 0; k < input_count; ++k) {
+          words[k] = sources[k][i];
+        }
+        result[i] = Expression::template apply<ScalarT, Idof>(words);
+        if constexpr (CountBits) {
+          population_count += std::popcount(static_cast<std::make_unsigned_t<ResultType>>(result[i]));
+        }
+      }
+      if ((m_element_count != 0) && (word_count != 0) && ((m_element_count % bits_per_word) != 0)) {
+        auto const tail_mask = (static_cast<ResultType>(1) << (m_element_count % bits_per_word)) - 1;
+        if constexpr (CountBits) {
+          population_count -= std::popcount(static_cast<std::make_unsigned_t<ResultType>>(result[word_count - 1]));
+          population_count +=
+            std::popcount(static_cast<std::make_unsigned_t<ResultType>>(result[word_count - 1] & tail_mask));
+        }
+        result[word_count - 1] &= tail_mask;
+      }
+      if constexpr (CountBits) {
+        return std::make_tuple(result + word_count, population_count);
+      } else {
+        return result + word_count;
+      }
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_BITMASK_EXPRESSION_BITMASK_EXPRESSION_HPP
@@ -0,0 +1,194 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file hyperloglog.hpp
+ * @brief A HyperLogLog sketch to estimate the number of distinct keys, e.g. to size a hash table before its build.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_CARDINALITY_HYPERLOGLOG_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_CARDINALITY_HYPERLOGLOG_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Estimates the number of distinct keys with 2^precision one byte registers.
+   *
+   * A register of keys is hashed at once with the hasher selected by HintSet. The high precision bits of a hash select
+   * a sketch register, which keeps the maximum number of leading zeros (plus one) of the remaining hash bits. The
+   * standard error of the estimate is about 1.04 / sqrt(2^precision), e.g. 1.6% for the default precision of 12. The
+   * sketches of several threads are combined with merge().
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<>, typename Idof = tsl::workaround>
+  class HyperLogLog {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    static_assert(std::is_integral_v<KeyType> && sizeof(KeyType) >= sizeof(uint32_t),
+                  "HyperLogLog requires integral keys of at least 32 bit.");
+
+    constexpr static unsigned min_precision = 4;
+    constexpr static unsigned max_precision = 18;
+
+   private:
+    using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+    using unsigned_t = std::make_unsigned_t<KeyType>;
+    // The hashers clear the sign bit of signed types.
+    constexpr static unsigned hash_bits = sizeof(KeyType) * CHAR_BIT - (std::is_signed_v<KeyType> ? 1 : 0);
+
+    unsigned m_precision;
+    std::vector<uint8_t> m_registers;
+
+   public:
+    auto precision() const noexcept { return m_precision; }
+    auto register_count() const noexcept { return m_registers.size(); }
+    auto registers() const noexcept -> std::vector<uint8_t> const & { return m_registers; }
+
+   public:
+    /**
+     * @throws std::invalid_argument If the precision is not within [min_precision, max_precision].
+     */
+    explicit HyperLogLog(unsigned p_precision = 12) : m_precision(p_precision) {
+      if (p_precision < min_precision || p_precision > max_precision) {
+        throw std::invalid_argument("HyperLogLog: the precision has to be within [4, 18].");
+      }
+      m_registers.assign(size_t{1} << m_precision, 0);
+    }
+    ~HyperLogLog() = default;
+
+   private:
+    TSL_FORCE_INLINE auto update(KeyType const hash) noexcept -> void {
+      auto const h = static_cast<unsigned_t>(hash);
+      auto const remaining_bits = hash_bits - m_precision;
+      auto const index = static_cast<size_t>(h >> remaining_bits);
+      auto const rest = static_cast<unsigned_t>(h & ((unsigned_t{1} << remaining_bits) - 1));
+      auto const rank = static_cast<uint8_t>(remaining_bits - std::bit_width(rest) + 1);
+      m_registers[index] = std::max(m_registers[index], rank);
+    }
+
+   public:
+    /**
+     * @brief Adds keys to the sketch.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end) noexcept -> void {
+      auto const simd_end = simd_iter_end<SimdStyle>(p_data, p_end);
+      auto const end = iter_end(p_data, p_end);
+      if constexpr (RegisterHasher<hasher, SimdStyle> && (SimdStyle::vector_element_count() > 1)) {
+        alignas(64) std::array<KeyType, SimdStyle::vector_element_count()> hashes;
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count()) {
+          tsl::store<SimdStyle, Idof>(hashes.data(), hasher::hash(tsl::loadu<SimdStyle, Idof>(p_data)));
+          for (auto const hash : hashes) {
+            update(hash);
+          }
+        }
+      }
+      for (; p_data != end; ++p_data) {
+        update(hasher::hash_value(*p_data));
+      }
+    }
+
+    /**
+     * @brief Adds the keys seen by another sketch of the same precision.
+     *
+     * @throws std::invalid_argument If the precisions differ.
+     */
+    template <class OtherHintSet, typename OtherIdof>
+    auto merge(HyperLogLog<SimdStyle, OtherHintSet, OtherIdof> const &other) -> void {
+      if (other.precision() != m_precision) {
+        throw std::invalid_argument("HyperLogLog: only sketches of the same precision can be merged.");
+      }
+      auto const &other_registers = other.registers();
+      for (size_t i = 0; i < m_registers.size(); ++i) {
+        m_registers[i] = std::max(m_registers[i], other_registers[i]);
+      }
+    }
+
+    auto clear() noexcept -> void { std::fill(m_registers.begin(), m_registers.end(), 0); }
+
+    /**
+     * @brief Returns the estimated number of distinct keys, small cardinalities are estimated by linear counting.
+     */
+    auto estimate() const noexcept -> double {
+      auto const m = static_cast<double>(m_registers.size());
+      double const alpha = (m_registers.size() == 16)   ? 0.673
+                           : (m_registers.size() == 32) ? 0.697
+                           : (m_registers.size() == 64) ? 0.709
+                                                        : 0.7213 / (1.0 + 1.079 / m);
+      double inverse_sum = 0.0;
+      size_t zero_registers = 0;
+      for (auto const r : m_registers) {
+        inverse_sum += std::ldexp(1.0, -static_cast<int>(r));
+        zero_registers += (r == 0);
+      }
+      double const raw_estimate = alpha * m * m / inverse_sum;
+      if (raw_estimate <= 2.5 * m && zero_registers != 0) {
+        return m * std::log(m / static_cast<double>(zero_registers));
+      }
+      if constexpr (hash_bits <= 32) {
+        double const hash_space = std::ldexp(1.0, hash_bits);
+        if (raw_estimate > hash_space / 30.0) {
+          return -hash_space * std::log(1.0 - raw_estimate / hash_space);
+        }
+      }
+      return raw_estimate;
+    }
+
+    /**
+     * @brief Returns a bucket count for a hash table holding p_distinct_keys at a load factor of at most p_load. With
+     * hints::hashing::size_exp_2 in BucketHintSet, the count is a power of two.
+     */
+    template <class BucketHintSet = HintSet>
+    static auto bucket_count_for(double p_distinct_keys, double p_load = 0.7) noexcept -> size_t {
+      auto const buckets =
+        std::max(static_cast<size_t>(std::ceil(std::max(p_distinct_keys, 1.0) / p_load)),
+                 static_cast<size_t>(SimdStyle::vector_element_count()));
+      if constexpr (has_hint<BucketHintSet, hints::hashing::size_exp_2>) {
+        return std::bit_ceil(buckets);
+      } else {
+        return buckets;
+      }
+    }
+
+    /**
+     * @brief Returns a bucket count for a hash table holding the estimated number of distinct keys.
+     */
+    template <class BucketHintSet = HintSet>
+    auto recommended_bucket_count(double p_load = 0.7) const noexcept -> size_t {
+      return bucket_count_for<BucketHintSet>(estimate(), p_load);
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif
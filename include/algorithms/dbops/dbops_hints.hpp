@@ -52,6 +52,21 @@ namespace tuddbs {
       struct mul {};
       struct sum {};
       struct average {};
+      struct min {};
+      struct max {};
+      struct count {};
+      /**
+       * @brief Tag to compute min, max, sum and count in a single pass (see arithmetic_statistics_t).
+       */
+      struct statistics {};
+      /**
+       * @brief Tag to detect overflows of the accumulator in sums and averages.
+       */
+      struct checked {};
+      /**
+       * @brief Tag to additionally compute the co-moment with a second column (see StreamingMoments).
+       */
+      struct covariance {};
     }  // namespace arithmetic
   }  // namespace hints
 
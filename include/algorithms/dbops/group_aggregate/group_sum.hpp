@@ -28,32 +28,57 @@
 #include <type_traits>
 
 #include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
 #include "algorithms/utils/hashing.hpp"
 #include "algorithms/utils/hinting.hpp"
+#include "datastructures/compressed_bitmap.hpp"
 #include "iterable.hpp"
 #include "tsl.hpp"
 
 namespace tuddbs {
+  /**
+   * @brief Builds a hash table of per-key sums.
+   * @details The sums are stored as _AccumulatorType (e.g. int64_t for int32_t values), thus the value sink has to be
+   * an array of _AccumulatorType. With hints::arithmetic::checked, an overflow of a sum is recorded and can be queried
+   * via overflow_detected().
+   */
   template <tsl::VectorProcessingStyle _KeySimdStyle, tsl::TSLArithmetic _ValueType = typename _KeySimdStyle::base_type,
-            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround,
+            tsl::TSLArithmetic _AccumulatorType = _ValueType>
   class Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement {
    public:
     using KeySimdStyle = _KeySimdStyle;
     using KeyType = typename KeySimdStyle::base_type;
     using KeySinkType = KeyType *;
     using ValueType = _ValueType;
-    using ValueSinkType = ValueType *;
-    using AddSimdStyle = tsl::simd<_ValueType, tsl::scalar>;
+    using AccumulatorType = _AccumulatorType;
+    using ValueSinkType = AccumulatorType *;
+    using AddSimdStyle = tsl::simd<AccumulatorType, tsl::scalar>;
+    static_assert(sizeof(AccumulatorType) >= sizeof(ValueType),
+                  "The accumulator must not be narrower than the values.");
+    static_assert(!has_hint<HintSet, hints::arithmetic::checked> || std::is_integral_v<AccumulatorType>,
+                  "Overflow checks are only supported for integral accumulators.");
 
    private:
     KeySinkType m_key_sink;
     ValueSinkType m_value_sink;
 
     size_t const m_map_element_count;
+    typename normalizer<KeySimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
     size_t m_groups_count;
 
     KeyType const m_empty_bucket_value;
     bool m_empty_bucket_seen_in_keys = false;
+    bool m_overflow_detected = false;
+
+    constexpr static bool reusable = has_hint<HintSet, hints::hashing::reusable_table>;
+    DirtyBucketTracker m_dirty_buckets;
+
+    TSL_FORCE_INLINE auto mark_dirty(size_t const bucket) noexcept -> void {
+      if constexpr (reusable) {
+        m_dirty_buckets.mark(bucket);
+      }
+    }
 
    public:
     auto distinct_key_count() const noexcept {
@@ -64,10 +89,15 @@ namespace tuddbs {
       }
     }
     auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto overflow_detected() const noexcept { return m_overflow_detected; }
 
    public:
     explicit Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement(void) = delete;
 
+    /**
+     * @brief The key and value sinks hold p_map_element_count + bucket_padding<KeySimdStyle, HintSet>(
+     * p_map_element_count) entries, as the probes of the last buckets may read a register beyond them.
+     */
     explicit Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement(SimdOpsIterable auto p_key_sink,
                                                                        SimdOpsIterable auto p_value_sink,
                                                                        size_t p_map_element_count,
@@ -76,23 +106,49 @@ namespace tuddbs {
       : m_key_sink(p_key_sink),
         m_value_sink(reinterpret_iterable<ValueSinkType>(p_value_sink)),
         m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_groups_count(0),
-        m_empty_bucket_value(p_empty_bucket_value) {
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_dirty_buckets(reusable ? DirtyBucketTracker(p_map_element_count + KeySimdStyle::vector_element_count())
+                                 : DirtyBucketTracker()) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_map_element_count & (m_map_element_count - 1)) == 0);
       }
       if (initialize) {
-        for (auto i = 0; i < m_map_element_count; ++i) {
-          m_key_sink[i] = m_empty_bucket_value;
-          m_value_sink[i] = (ValueType)0;
-        }
+        initialize_sinks();
       }
     }
 
     ~Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement() = default;
 
+    /**
+     * @brief Fills the key sink with the empty bucket value and the value sink with 0, a register at a time. With
+     * p_thread_count > 1, the sinks are split into page aligned chunks that are filled concurrently. The padding behind
+     * the last bucket (bucket_padding) is probed like the buckets and filled as well.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      auto const sink_count = m_map_element_count + bucket_padding<KeySimdStyle, HintSet>(m_map_element_count);
+      fill_sink<KeySimdStyle, Idof>(m_key_sink, sink_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<KeySimdStyle, Idof>(m_value_sink, sink_count, AccumulatorType{0}, p_thread_count);
+    }
+
+    /**
+     * @brief Empties the hash table for the next aggregation by restoring only the blocks of buckets that were written.
+     */
+    template <class HS = HintSet>
+    auto reset(enable_if_has_hint_t<HS, hints::hashing::reusable_table> = {}) noexcept -> void {
+      m_dirty_buckets.for_each_dirty_range([this](size_t begin, size_t end) {
+        fill_sink<KeySimdStyle, Idof>(m_key_sink + begin, end - begin, m_empty_bucket_value);
+        fill_sink<KeySimdStyle, Idof>(m_value_sink + begin, end - begin, AccumulatorType{0});
+      });
+      m_dirty_buckets.clear();
+      m_groups_count = 0;
+      m_empty_bucket_seen_in_keys = false;
+      m_overflow_detected = false;
+    }
+
    private:
-    TSL_FORCE_INLINE auto insert(typename KeySimdStyle::base_type const key, ValueType const value,
+    TSL_FORCE_INLINE auto insert(typename KeySimdStyle::base_type const key, AccumulatorType const value,
                                  typename KeySimdStyle::imask_type const all_false_mask,
                                  typename KeySimdStyle::register_type const empty_bucket_reg) noexcept -> void {
       if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
@@ -106,7 +162,7 @@ namespace tuddbs {
       // calculate the position hint
       auto lookup_position =
         normalizer<KeySimdStyle, HintSet, Idof>::align_value(normalizer<KeySimdStyle, HintSet, Idof>::normalize_value(
-          default_hasher<KeySimdStyle, Idof>::hash_value(key), m_map_element_count));
+          hasher_t<KeySimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
       typename KeySimdStyle::register_type map_reg;
       while (true) {
         if constexpr (has_hint<HintSet, hints::memory::aligned>) {
@@ -122,7 +178,17 @@ namespace tuddbs {
         if (tsl::nequal<KeySimdStyle, Idof>(key_found_mask, all_false_mask)) {
           auto const found_position = tsl::tzc<KeySimdStyle, Idof>(key_found_mask);
           auto &value_entry = m_value_sink[lookup_position + found_position];
-          value_entry = tsl::add<AddSimdStyle, Idof>(value_entry, value);
+          if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
+            // The key equal to the empty bucket value is summed up in a bucket that may still look empty.
+            if (key == m_empty_bucket_value) {
+              mark_dirty(lookup_position + found_position);
+            }
+          }
+          if constexpr (has_hint<HintSet, hints::arithmetic::checked>) {
+            m_overflow_detected |= __builtin_add_overflow(value_entry, value, &value_entry);
+          } else {
+            value_entry = tsl::add<AddSimdStyle, Idof>(value_entry, value);
+          }
           break;
         }
         auto const empty_bucket_found_mask = tsl::equal_as_imask<KeySimdStyle, Idof>(map_reg, empty_bucket_reg);
@@ -138,6 +204,7 @@ namespace tuddbs {
             // loose any information.
             auto &value_entry = m_value_sink[lookup_position + empty_bucket_position];
             if (value_entry == 0) {
+              mark_dirty(lookup_position + empty_bucket_position);
               m_key_sink[lookup_position + empty_bucket_position] = key;
               value_entry = value;
               ++m_groups_count;
@@ -150,6 +217,7 @@ namespace tuddbs {
                 // the first occurence
                 auto updated_empty_bucket_position =
                   tsl::tzc<KeySimdStyle, Idof>(updated_empty_bucket_found_mask) + empty_bucket_position + 1;
+                mark_dirty(lookup_position + updated_empty_bucket_position);
                 m_key_sink[lookup_position + updated_empty_bucket_position] = key;
                 m_value_sink[lookup_position + updated_empty_bucket_position] = value;
                 ++m_groups_count;
@@ -157,6 +225,7 @@ namespace tuddbs {
               }
             }
           } else {
+            mark_dirty(lookup_position + empty_bucket_position);
             m_key_sink[lookup_position + empty_bucket_position] = key;
             m_value_sink[lookup_position + empty_bucket_position] = value;
             ++m_groups_count;
@@ -165,7 +234,7 @@ namespace tuddbs {
           break;
         }
         lookup_position = normalizer<KeySimdStyle, HintSet, Idof>::normalize_value(
-          lookup_position + KeySimdStyle::vector_element_count(), m_map_element_count);
+          lookup_position + KeySimdStyle::vector_element_count(), m_bucket_modulus);
       }
     }
 
@@ -183,6 +252,21 @@ namespace tuddbs {
       }
     }
 
+    /**
+     * @brief Aggregates the elements selected by a compressed bitmap.
+     */
+    template <tsl::VectorProcessingStyle BitmapSimdStyle, typename BitmapIdof>
+    auto operator()(SimdOpsIterable auto p_data, CompressedBitmap<BitmapSimdStyle, BitmapIdof> const &p_selection,
+                    SimdOpsIterable auto p_value) noexcept -> void {
+      auto const all_false_mask = tsl::integral_all_false<KeySimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<KeySimdStyle, Idof>(m_empty_bucket_value);
+      p_selection.for_each_batch([&](size_t const *positions, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+          insert(p_data[positions[i]], p_value[positions[i]], all_false_mask, empty_bucket_reg);
+        }
+      });
+    }
+
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
                     SimdOpsIterable auto p_value, activate_for_bit_mask<HS> = {}) noexcept -> void {
@@ -248,16 +332,21 @@ namespace tuddbs {
     }
 
     template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherValueType, class OtherHintSet,
-              typename OtherIdof>
+              typename OtherIdof, tsl::TSLArithmetic OtherAccumulatorType>
     auto merge(Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement<OtherSimdStlye, OtherValueType, OtherHintSet,
-                                                                         OtherIdof> const &other) noexcept -> void {
+                                                                         OtherIdof, OtherAccumulatorType> const &other)
+      noexcept -> void {
+      m_overflow_detected |= other.overflow_detected();
       auto const all_false_mask = tsl::integral_all_false<KeySimdStyle, Idof>();
       auto const empty_bucket_reg = tsl::set1<KeySimdStyle, Idof>(m_empty_bucket_value);
 
       auto const other_empty_bucket_value = other.empty_bucket_value();
       auto const &other_key_sink = other.m_key_sink;
       auto const &other_value_sink = other.m_value_sink;
-      for (size_t i = 0; i < m_map_element_count; ++i) {
+      // The last bucket group of other may reach beyond its last bucket.
+      auto const used_bucket_count =
+        other.m_map_element_count + bucket_padding<OtherSimdStlye, OtherHintSet>(other.m_map_element_count);
+      for (size_t i = 0; i < used_bucket_count; ++i) {
         if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
           auto const other_key = other_key_sink[i];
           if (other_key == other_empty_bucket_value) {
@@ -281,14 +370,15 @@ namespace tuddbs {
   };
 
   template <tsl::VectorProcessingStyle _KeySimdStyle, typename _ValueType = typename _KeySimdStyle::base_type,
-            class HintSet = OperatorHintSet<>, typename Idof = tsl::workaround>
+            class HintSet = OperatorHintSet<>, typename Idof = tsl::workaround, typename _AccumulatorType = _ValueType>
   class Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement {
    public:
     using KeySimdStyle = _KeySimdStyle;
     using KeyType = typename KeySimdStyle::base_type;
     using KeySinkType = KeyType *;
     using ValueType = _ValueType;
-    using ValueSinkType = ValueType *;
+    using AccumulatorType = _AccumulatorType;
+    using ValueSinkType = AccumulatorType *;
 
    private:
     KeySinkType m_key_sink;
@@ -311,11 +401,24 @@ namespace tuddbs {
 
     ~Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement() = default;
 
+   private:
+    /**
+     * @brief The buckets and the padding behind them, which may hold groups of the last bucket group. Dense sinks
+     * (Grouper_Aggregate_Sum_Build_Dense_SIMD) are indexed by the keys and have no padding.
+     */
+    auto used_bucket_count() const noexcept -> size_t {
+      if constexpr (has_hint<HintSet, hints::grouping::dense_keys>) {
+        return m_map_element_count;
+      } else {
+        return m_map_element_count + bucket_padding<KeySimdStyle, HintSet>(m_map_element_count);
+      }
+    }
+
    public:
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_group_key, SimdOpsIterable auto p_group_value,
                     enable_if_has_hint_t<HS, hints::hashing::keys_may_contain_zero> = {}) noexcept -> void {
-      for (size_t i = 0; i < m_map_element_count; ++i) {
+      for (size_t i = 0; i < used_bucket_count(); ++i) {
         if (m_key_sink[i] != m_empty_bucket_value) {
           *p_group_key = m_key_sink[i];
           *p_group_value = m_value_sink[i];
@@ -340,7 +443,7 @@ namespace tuddbs {
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_group_key, SimdOpsIterable auto p_group_value,
                     enable_if_has_not_hint_t<HS, hints::hashing::keys_may_contain_zero> = {}) const noexcept -> void {
-      for (size_t i = 0; i < m_map_element_count; ++i) {
+      for (size_t i = 0; i < used_bucket_count(); ++i) {
         if (m_key_sink[i] != m_empty_bucket_value) {
           *p_group_key = m_key_sink[i];
           *p_group_value = m_value_sink[i];
@@ -351,16 +454,20 @@ namespace tuddbs {
     }
 
     template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherValueType, class OtherHintSet,
-              typename OtherIdof>
+              typename OtherIdof, typename OtherAccumulatorType>
     auto merge(Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement<OtherSimdStlye, OtherValueType, OtherHintSet,
-                                                                   OtherIdof> const &other) noexcept -> void {}
+                                                                   OtherIdof, OtherAccumulatorType> const &other)
+      noexcept -> void {}
     auto finalize() const noexcept -> void {}
   };
   template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _ValueType = typename _SimdStyle::base_type,
-            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround,
+            tsl::TSLArithmetic _AccumulatorType = _ValueType>
   struct Grouper_Aggregate_SUM_SIMD_Linear_Displacement {
-    using builder_t = Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof>;
-    using grouper_t = Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof>;
+    using builder_t = Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof,
+                                                                                _AccumulatorType>;
+    using grouper_t =
+      Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof, _AccumulatorType>;
   };
 
 }  // namespace tuddbs
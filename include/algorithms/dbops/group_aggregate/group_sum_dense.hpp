@@ -0,0 +1,274 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file group_sum_dense.hpp
+ * @brief Per-key sums for keys of a small, dense range, without hashing.
+ */
+
+#ifndef SIMDOPS_INLCUDE_ALGORITHMS_DBOPS_GROUPBY_AGGREGATE_GROUP_SUM_DENSE_HPP
+#define SIMDOPS_INLCUDE_ALGORITHMS_DBOPS_GROUPBY_AGGREGATE_GROUP_SUM_DENSE_HPP
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/group_aggregate/group_sum.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "algorithms/utils/table_init.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief Builds per-key sums for keys in [min_key, min_key + map_element_count), the key is the index of its sum.
+   * @details Every lane of a register accumulates into its own copy of the sums, so equal keys within a register or in
+   * consecutive registers do not update the same accumulator. finalize() reduces the copies and writes the sinks in
+   * the layout of Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement: slot k holds min_key + k and its sum, or
+   * the empty bucket value and 0 if the key did not occur. Thus Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement
+   * reads the result, constructed with empty_bucket_value(). The empty bucket value is chosen outside of the key range,
+   * so every key, including 0, is a group. Keys outside of the range are not allowed, key_range() finds the range in a
+   * SIMD pass.
+   */
+  template <tsl::VectorProcessingStyle _KeySimdStyle, tsl::TSLArithmetic _ValueType = typename _KeySimdStyle::base_type,
+            class HintSet = OperatorHintSet<hints::grouping::dense_keys>, typename Idof = tsl::workaround,
+            tsl::TSLArithmetic _AccumulatorType = _ValueType>
+  class Grouper_Aggregate_Sum_Build_Dense_SIMD {
+   public:
+    using KeySimdStyle = _KeySimdStyle;
+    using KeyType = typename KeySimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using ValueType = _ValueType;
+    using AccumulatorType = _AccumulatorType;
+    using ValueSinkType = AccumulatorType *;
+    static_assert(std::is_integral_v<KeyType>, "Dense grouping requires integral keys.");
+    static_assert(sizeof(AccumulatorType) >= sizeof(ValueType),
+                  "The accumulator must not be narrower than the values.");
+    static_assert(!has_hint<HintSet, hints::arithmetic::checked> || std::is_integral_v<AccumulatorType>,
+                  "Overflow checks are only supported for integral accumulators.");
+
+   private:
+    constexpr static size_t lane_count = KeySimdStyle::vector_element_count();
+    using offset_t = std::make_unsigned_t<KeyType>;
+
+    KeySinkType m_key_sink;
+    ValueSinkType m_value_sink;
+
+    size_t const m_map_element_count;
+    KeyType const m_min_key;
+    size_t m_groups_count;
+
+    KeyType const m_empty_bucket_value;
+    bool m_overflow_detected = false;
+
+    // The sum of key min_key + k in lane l is m_lane_sums[k * lane_count + l].
+    std::vector<AccumulatorType> m_lane_sums;
+    std::vector<uint8_t> m_key_seen;
+
+   public:
+    auto distinct_key_count() const noexcept { return m_groups_count; }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto overflow_detected() const noexcept { return m_overflow_detected; }
+    auto min_key() const noexcept { return m_min_key; }
+    auto map_element_count() const noexcept { return m_map_element_count; }
+
+   public:
+    explicit Grouper_Aggregate_Sum_Build_Dense_SIMD(void) = delete;
+
+    /**
+     * @brief Returns a key outside of [p_min_key, p_min_key + p_map_element_count), the range must not cover all keys.
+     */
+    constexpr static auto empty_bucket_value_for(KeyType p_min_key, size_t p_map_element_count) noexcept -> KeyType {
+      assert(p_map_element_count <= static_cast<size_t>(std::numeric_limits<offset_t>::max()));
+      if (p_min_key != std::numeric_limits<KeyType>::lowest()) {
+        return static_cast<KeyType>(p_min_key - 1);
+      }
+      return static_cast<KeyType>(static_cast<offset_t>(p_min_key) + static_cast<offset_t>(p_map_element_count));
+    }
+
+    /**
+     * @param p_map_element_count The size of the key range and of the sinks.
+     * @param p_min_key The smallest key.
+     * @param initialize Flag indicating whether to initialize the sinks. Pass false to call initialize_sinks() with
+     * several threads instead.
+     */
+    explicit Grouper_Aggregate_Sum_Build_Dense_SIMD(SimdOpsIterable auto p_key_sink, SimdOpsIterable auto p_value_sink,
+                                                    size_t p_map_element_count, KeyType p_min_key,
+                                                    bool initialize = true)
+      : m_key_sink(p_key_sink),
+        m_value_sink(reinterpret_iterable<ValueSinkType>(p_value_sink)),
+        m_map_element_count(p_map_element_count),
+        m_min_key(p_min_key),
+        m_groups_count(0),
+        m_empty_bucket_value(empty_bucket_value_for(p_min_key, p_map_element_count)),
+        m_lane_sums(p_map_element_count * lane_count, 0),
+        m_key_seen(p_map_element_count, 0) {
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+
+    ~Grouper_Aggregate_Sum_Build_Dense_SIMD() = default;
+
+    /**
+     * @brief Fills the key sink with the empty bucket value and the value sink with 0, a register at a time. With
+     * p_thread_count > 1, the sinks are split into page aligned chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      fill_sink<KeySimdStyle, Idof>(m_key_sink, m_map_element_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<KeySimdStyle, Idof>(m_value_sink, m_map_element_count, AccumulatorType{0}, p_thread_count);
+    }
+
+    /**
+     * @brief Returns the smallest and the largest key, or (max, lowest) if there are no keys.
+     */
+    static auto key_range(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end) noexcept
+      -> std::pair<KeyType, KeyType> {
+      auto const simd_end = simd_iter_end<KeySimdStyle>(p_data, p_end);
+      auto const end = iter_end(p_data, p_end);
+      KeyType min = std::numeric_limits<KeyType>::max();
+      KeyType max = std::numeric_limits<KeyType>::lowest();
+      if constexpr (lane_count > 1) {
+        auto min_reg = tsl::set1<KeySimdStyle, Idof>(min);
+        auto max_reg = tsl::set1<KeySimdStyle, Idof>(max);
+        for (; p_data != simd_end; p_data += lane_count) {
+          auto const keys = tsl::loadu<KeySimdStyle, Idof>(p_data);
+          min_reg = tsl::min<KeySimdStyle, Idof>(min_reg, keys);
+          max_reg = tsl::max<KeySimdStyle, Idof>(max_reg, keys);
+        }
+        std::array<KeyType, lane_count> mins;
+        std::array<KeyType, lane_count> maxs;
+        tsl::storeu<KeySimdStyle, Idof>(mins.data(), min_reg);
+        tsl::storeu<KeySimdStyle, Idof>(maxs.data(), max_reg);
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+          min = std::min(min, mins[lane]);
+          max = std::max(max, maxs[lane]);
+        }
+      }
+      for (; p_data != end; ++p_data) {
+        min = std::min(min, static_cast<KeyType>(*p_data));
+        max = std::max(max, static_cast<KeyType>(*p_data));
+      }
+      return {min, max};
+    }
+
+   private:
+    TSL_FORCE_INLINE auto accumulate(offset_t const slot, size_t const lane, AccumulatorType const value) noexcept
+      -> void {
+      assert(slot < m_map_element_count);
+      m_key_seen[slot] = 1;
+      auto &sum = m_lane_sums[slot * lane_count + lane];
+      if constexpr (has_hint<HintSet, hints::arithmetic::checked>) {
+        m_overflow_detected |= __builtin_add_overflow(sum, value, &sum);
+      } else {
+        sum += value;
+      }
+    }
+
+   public:
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    SimdOpsIterable auto p_value) noexcept -> void {
+      auto const simd_end = simd_iter_end<KeySimdStyle>(p_data, p_end);
+      auto const end = iter_end(p_data, p_end);
+
+      if constexpr (lane_count > 1) {
+        auto const min_key_reg = tsl::set1<KeySimdStyle, Idof>(m_min_key);
+        std::array<KeyType, lane_count> slots;
+        for (; p_data != simd_end; p_data += lane_count, p_value += lane_count) {
+          // The offsets of the keys to min_key are computed a register at a time.
+          tsl::storeu<KeySimdStyle, Idof>(
+            slots.data(), tsl::sub<KeySimdStyle, Idof>(tsl::loadu<KeySimdStyle, Idof>(p_data), min_key_reg));
+          for (size_t lane = 0; lane < lane_count; ++lane) {
+            accumulate(static_cast<offset_t>(slots[lane]), lane, static_cast<AccumulatorType>(p_value[lane]));
+          }
+        }
+      }
+      for (; p_data != end; ++p_data, ++p_value) {
+        accumulate(static_cast<offset_t>(static_cast<offset_t>(*p_data) - static_cast<offset_t>(m_min_key)), 0,
+                   static_cast<AccumulatorType>(*p_value));
+      }
+    }
+
+    /**
+     * @brief Adds the sums of another builder over the same key range, e.g. one that was filled by another thread.
+     */
+    template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherValueType, class OtherHintSet,
+              typename OtherIdof, tsl::TSLArithmetic OtherAccumulatorType>
+    auto merge(Grouper_Aggregate_Sum_Build_Dense_SIMD<OtherSimdStlye, OtherValueType, OtherHintSet, OtherIdof,
+                                                      OtherAccumulatorType> const &other) noexcept -> void {
+      assert(other.min_key() == m_min_key && other.map_element_count() == m_map_element_count);
+      m_overflow_detected |= other.overflow_detected();
+      auto const &other_sums = other.lane_sums();
+      auto const other_lane_count = other_sums.size() / m_map_element_count;
+      for (size_t slot = 0; slot < m_map_element_count; ++slot) {
+        if (other.keys_seen()[slot] != 0) {
+          for (size_t lane = 0; lane < other_lane_count; ++lane) {
+            accumulate(slot, lane % lane_count,
+                       static_cast<AccumulatorType>(other_sums[slot * other_lane_count + lane]));
+          }
+        }
+      }
+    }
+
+    auto lane_sums() const noexcept -> std::vector<AccumulatorType> const & { return m_lane_sums; }
+    auto keys_seen() const noexcept -> std::vector<uint8_t> const & { return m_key_seen; }
+
+    /**
+     * @brief Reduces the lane copies into the sinks.
+     */
+    auto finalize() noexcept -> void {
+      m_groups_count = 0;
+      for (size_t slot = 0; slot < m_map_element_count; ++slot) {
+        AccumulatorType sum = 0;
+        for (size_t lane = 0; lane < lane_count; ++lane) {
+          if constexpr (has_hint<HintSet, hints::arithmetic::checked>) {
+            m_overflow_detected |= __builtin_add_overflow(sum, m_lane_sums[slot * lane_count + lane], &sum);
+          } else {
+            sum += m_lane_sums[slot * lane_count + lane];
+          }
+        }
+        if (m_key_seen[slot] != 0) {
+          m_key_sink[slot] = static_cast<KeyType>(static_cast<offset_t>(m_min_key) + static_cast<offset_t>(slot));
+          m_value_sink[slot] = sum;
+          ++m_groups_count;
+        } else {
+          m_key_sink[slot] = m_empty_bucket_value;
+          m_value_sink[slot] = (AccumulatorType)0;
+        }
+      }
+    }
+  };
+
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _ValueType = typename _SimdStyle::base_type,
+            class HintSet = OperatorHintSet<hints::grouping::dense_keys>, typename Idof = tsl::workaround,
+            tsl::TSLArithmetic _AccumulatorType = _ValueType>
+  struct Grouper_Aggregate_SUM_Dense_SIMD {
+    using builder_t = Grouper_Aggregate_Sum_Build_Dense_SIMD<_SimdStyle, _ValueType, HintSet, Idof, _AccumulatorType>;
+    using grouper_t =
+      Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof, _AccumulatorType>;
+  };
+
+}  // namespace tuddbs
+
+#endif
@@ -25,8 +25,16 @@
 
 #include "algorithms/dbops/dbops_hints.hpp"
 #include "algorithms/dbops/group_aggregate/group_sum.hpp"
+#include "algorithms/dbops/group_aggregate/group_sum_dense.hpp"
+#include "algorithms/dbops/groupby/groupby_composite.hpp"
+#include "algorithms/dbops/groupby/groupby_concurrent.hpp"
+#include "algorithms/dbops/groupby/groupby_growable.hpp"
 #include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_partitioned.hpp"
+#include "algorithms/dbops/groupby/groupby_simd_interleaved.hpp"
 #include "algorithms/dbops/groupby/groupby_simd_linear_displacement.hpp"
+#include "algorithms/dbops/groupby/groupby_sort.hpp"
+#include "algorithms/dbops/groupby/groupby_spilling.hpp"
 #include "algorithms/utils/hashing.hpp"
 #include "tsl.hpp"
 
@@ -36,22 +44,52 @@ namespace tuddbs {
             class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>,
             typename Idof = tsl::workaround>
   struct Group {
+    using base_class = std::conditional_t<
+      has_hint<HintSet, hints::grouping::sort_based>, Grouper_SIMD_Sort<_SimdStyle, _PositionType, HintSet, Idof>,
+      std::conditional_t<
+        has_hint<HintSet, hints::hashing::interleaved_buckets>,
+        Grouper_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>,
+        std::conditional_t<has_hints<HintSet, hints::hashing::linear_displacement> &&
+                             !has_hint<HintSet, hints::hashing::refill>,
+                           Grouper_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>, void>>>;
+    using builder_t = typename base_class::builder_t;
+    using grouper_t = typename base_class::grouper_t;
+    using growable_builder_t =
+      Growable_Grouper_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>;
+    using partitioned_builder_t =
+      Partitioned_Grouper_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>;
+    using concurrent_builder_t =
+      Concurrent_Grouper_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>;
+    using spilling_builder_t =
+      Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>;
+  };
+
+  /**
+   * @brief Grouping on ColumnCount key columns. If the columns fit into one key, packer_t packs them for Group and
+   * GroupAggregate_Sum, otherwise builder_t and grouper_t probe all key columns.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType, size_t ColumnCount,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>,
+            typename Idof = tsl::workaround>
+  struct GroupComposite {
     using base_class =
-      std::conditional_t<has_hints<HintSet, hints::hashing::linear_displacement> &&
-                           !has_hint<HintSet, hints::hashing::refill>,
-                         Grouper_SIMD_Linear_Displacement<_SimdStyle, _PositionType, HintSet, Idof>, void>;
+      Grouper_SIMD_Linear_Displacement_Composite<_SimdStyle, _PositionType, ColumnCount, HintSet, Idof>;
     using builder_t = typename base_class::builder_t;
     using grouper_t = typename base_class::grouper_t;
+    template <typename ColumnType = typename _SimdStyle::base_type>
+    using packer_t = CompositeKeyPacker<_SimdStyle, ColumnCount, ColumnType, Idof>;
   };
 
   template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _ValueType = typename _SimdStyle::base_type,
             class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>,
-            typename Idof = tsl::workaround>
+            typename Idof = tsl::workaround, tsl::TSLArithmetic _AccumulatorType = _ValueType>
   struct GroupAggregate_Sum {
-    using base_class =
-      std::conditional_t<has_hints<HintSet, hints::hashing::linear_displacement> &&
-                           !has_hint<HintSet, hints::hashing::refill>,
-                         Grouper_Aggregate_SUM_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof>, void>;
+    using base_class = std::conditional_t<
+      has_hint<HintSet, hints::grouping::dense_keys>,
+      Grouper_Aggregate_SUM_Dense_SIMD<_SimdStyle, _ValueType, HintSet, Idof, _AccumulatorType>,
+      std::conditional_t<
+        has_hints<HintSet, hints::hashing::linear_displacement> && !has_hint<HintSet, hints::hashing::refill>,
+        Grouper_Aggregate_SUM_SIMD_Linear_Displacement<_SimdStyle, _ValueType, HintSet, Idof, _AccumulatorType>, void>>;
     using builder_t = typename base_class::builder_t;
     using grouper_t = typename base_class::grouper_t;
   };
@@ -0,0 +1,502 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_composite.hpp
+ * @brief Grouping on composite keys of multiple columns.
+ *
+ * If the bit widths of all key columns fit into one key, CompositeKeyPacker packs them and the single-column
+ * operators (grouping, group sums) are used. Otherwise the composite hash table stores every key column separately
+ * (SoA) and compares all of them when probing.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_COMPOSITE_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_COMPOSITE_HPP
+
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Packs multiple key columns into a single key column, each column using a fixed number of bits.
+   *
+   * The first column occupies the lowest bits. The packed keys have the base type of SimdStyle, the columns may be
+   * narrower (e.g. two uint32_t dictionary codes packed into an uint64_t key). Columns of the packed type are packed
+   * with SIMD, narrower ones are widened element-wise. Values that do not fit into the bit width of their column throw
+   * std::out_of_range, as they would silently collide otherwise.
+   *
+   * @tparam SimdStyle The SIMD processing style of the packed keys.
+   * @tparam ColumnCount The number of key columns.
+   * @tparam ColumnType The type of the key columns.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, size_t ColumnCount,
+            typename ColumnType = typename _SimdStyle::base_type, typename Idof = tsl::workaround>
+  class CompositeKeyPacker {
+   public:
+    using SimdStyle = _SimdStyle;
+    using base_t = typename SimdStyle::base_type;
+    static_assert(std::is_unsigned_v<base_t> && std::is_unsigned_v<ColumnType>,
+                  "Keys are packed into unsigned integers.");
+    static_assert(sizeof(ColumnType) <= sizeof(base_t));
+    static_assert(ColumnCount > 0);
+
+   private:
+    constexpr static unsigned bits = sizeof(base_t) * CHAR_BIT;
+    std::array<unsigned, ColumnCount> const m_bit_widths;
+    std::array<unsigned, ColumnCount> m_offsets;
+
+    static auto checked_bit_widths(std::array<unsigned, ColumnCount> const &p_bit_widths)
+      -> std::array<unsigned, ColumnCount> {
+      if (!fits(p_bit_widths)) {
+        throw std::invalid_argument("The key columns do not fit into a single key.");
+      }
+      return p_bit_widths;
+    }
+
+    auto column_mask(size_t column) const noexcept -> base_t {
+      return (m_bit_widths[column] == bits) ? std::numeric_limits<base_t>::max()
+                                            : static_cast<base_t>((base_t{1} << m_bit_widths[column]) - 1);
+    }
+
+   public:
+    /**
+     * @brief Whether columns of the given bit widths can be packed into one key.
+     */
+    constexpr static auto fits(std::array<unsigned, ColumnCount> const &p_bit_widths) noexcept -> bool {
+      unsigned sum = 0;
+      for (auto width : p_bit_widths) {
+        if (width == 0) {
+          return false;
+        }
+        sum += width;
+      }
+      return sum <= bits;
+    }
+
+    explicit CompositeKeyPacker(std::array<unsigned, ColumnCount> const &p_bit_widths)
+      : m_bit_widths(checked_bit_widths(p_bit_widths)) {
+      unsigned offset = 0;
+      for (size_t column = 0; column < ColumnCount; ++column) {
+        m_offsets[column] = offset;
+        offset += m_bit_widths[column];
+      }
+    }
+
+    /**
+     * @brief Packs the key columns into p_result.
+     *
+     * @param p_result The packed keys.
+     * @param p_columns The key columns.
+     * @param p_count The number of keys.
+     */
+    auto operator()(base_t *p_result, std::array<ColumnType const *, ColumnCount> const &p_columns,
+                    size_t p_count) const -> void {
+      base_t out_of_range_bits = 0;
+      size_t i = 0;
+      if constexpr (std::is_same_v<ColumnType, base_t>) {
+        constexpr auto lanes = SimdStyle::vector_element_count();
+        std::array<typename SimdStyle::register_type, ColumnCount> masks;
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          masks[column] = tsl::set1<SimdStyle, Idof>(static_cast<base_t>(~column_mask(column)));
+        }
+        // Bits outside of the width of a column are collected and checked once.
+        auto out_of_range = tsl::set1<SimdStyle, Idof>(0);
+        for (; i + lanes <= p_count; i += lanes) {
+          auto packed = tsl::set1<SimdStyle, Idof>(0);
+          for (size_t column = 0; column < ColumnCount; ++column) {
+            auto const values = tsl::loadu<SimdStyle, Idof>(p_columns[column] + i);
+            out_of_range =
+              tsl::binary_or<SimdStyle, Idof>(out_of_range, tsl::binary_and<SimdStyle, Idof>(values, masks[column]));
+            packed = tsl::binary_or<SimdStyle, Idof>(
+              packed, tsl::shift_left<SimdStyle, Idof>(values, static_cast<int>(m_offsets[column])));
+          }
+          tsl::storeu<SimdStyle, Idof>(p_result + i, packed);
+        }
+        alignas(64) std::array<base_t, lanes> out_of_range_lanes;
+        tsl::store<SimdStyle, Idof>(out_of_range_lanes.data(), out_of_range);
+        for (auto lane : out_of_range_lanes) {
+          out_of_range_bits |= lane;
+        }
+      }
+      for (; i < p_count; ++i) {
+        base_t packed = 0;
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          auto const value = static_cast<base_t>(p_columns[column][i]);
+          out_of_range_bits |= static_cast<base_t>(value & ~column_mask(column));
+          packed |= static_cast<base_t>(value << m_offsets[column]);
+        }
+        p_result[i] = packed;
+      }
+      if (out_of_range_bits != 0) {
+        throw std::out_of_range("A key does not fit into the bit width of its column.");
+      }
+    }
+
+    /**
+     * @brief Splits packed keys (e.g. the keys of the groups) into their columns.
+     */
+    auto unpack(std::array<ColumnType *, ColumnCount> const &p_columns, base_t const *p_packed, size_t p_count) const
+      -> void {
+      size_t i = 0;
+      if constexpr (std::is_same_v<ColumnType, base_t>) {
+        constexpr auto lanes = SimdStyle::vector_element_count();
+        for (; i + lanes <= p_count; i += lanes) {
+          auto const packed = tsl::loadu<SimdStyle, Idof>(p_packed + i);
+          for (size_t column = 0; column < ColumnCount; ++column) {
+            auto const shifted = tsl::shift_right<SimdStyle, Idof>(packed, static_cast<int>(m_offsets[column]));
+            tsl::storeu<SimdStyle, Idof>(
+              p_columns[column] + i,
+              tsl::binary_and<SimdStyle, Idof>(shifted, tsl::set1<SimdStyle, Idof>(column_mask(column))));
+          }
+        }
+      }
+      for (; i < p_count; ++i) {
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          p_columns[column][i] = static_cast<ColumnType>((p_packed[i] >> m_offsets[column]) & column_mask(column));
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Hashes composite keys by combining the hashes of the columns: h = hash(h * c ^ key[column]).
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, class HintSet, size_t ColumnCount, typename Idof>
+  class composite_hasher {
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = std::make_unsigned_t<base_t>;
+    using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+    constexpr static unsigned_t combine_multiplier = static_cast<unsigned_t>(0x9E3779B97F4A7C15ull);
+
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(std::array<base_t, ColumnCount> const &keys) -> base_t {
+      auto h = hasher::hash_value(keys[0]);
+      for (size_t column = 1; column < ColumnCount; ++column) {
+        auto const combined = static_cast<unsigned_t>(static_cast<unsigned_t>(h) * combine_multiplier) ^
+                              static_cast<unsigned_t>(keys[column]);
+        h = hasher::hash_value(static_cast<base_t>(combined));
+      }
+      return h;
+    }
+  };
+
+  /**
+   * @brief A hash table for grouping on ColumnCount key columns of the same type.
+   *
+   * Every key column has its own sink (SoA). A bucket is empty if its group id is invalid, thus keys may take any
+   * value. Probing loads a register of buckets of every key column and combines the comparisons of all columns into
+   * a single mask. Like Grouper_Build_Hash_SIMD_Linear_Displacement, the group ids are dense and the first position of
+   * every group is stored at its group id.
+   *
+   * @tparam _SimdStyle The SIMD processing style, its base type is the type of all key columns and of the group ids.
+   * @tparam _PositionType The type of the first positions.
+   * @tparam ColumnCount The number of key columns.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType, size_t ColumnCount,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Grouper_Build_Hash_SIMD_Linear_Displacement_Composite {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using GroupIdType = typename SimdStyle::base_type;
+    using GroupIdSinkType = GroupIdType *;
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+    using hasher = composite_hasher<SimdStyle, HintSet, ColumnCount, Idof>;
+    static_assert(ColumnCount > 1, "Use Grouper_Build_Hash_SIMD_Linear_Displacement for a single key column.");
+
+   private:
+    std::array<KeySinkType, ColumnCount> m_key_sinks;
+    GroupIdSinkType m_group_id_sink;
+    PositionSinkType m_original_positions_sink;
+
+    size_t const m_map_element_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
+    size_t m_group_id_count;
+
+    PositionType const m_invalid_position;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    auto distinct_key_count() const noexcept { return m_group_id_count; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto invalid_gid() const noexcept { return m_invalid_gid; }
+
+   public:
+    explicit Grouper_Build_Hash_SIMD_Linear_Displacement_Composite(void) = delete;
+    /**
+     * @brief Constructs a composite grouping hash table.
+     *
+     * @param p_key_sinks One sink per key column, followed by bucket_padding<SimdStyle, HintSet>(p_map_element_count)
+     * entries of padding. The group id sink is padded alike.
+     * @param p_group_id_sink The group ids of the buckets, an invalid group id marks an empty bucket.
+     * @param p_original_first_occurence_position_sink The first position of every group.
+     * @param p_map_element_count The number of buckets.
+     * @param initialize Flag indicating whether to initialize the hash table with empty buckets. Pass false to call
+     * initialize_sinks() with several threads instead.
+     */
+    explicit Grouper_Build_Hash_SIMD_Linear_Displacement_Composite(
+      std::array<KeySinkType, ColumnCount> const &p_key_sinks, SimdOpsIterable auto p_group_id_sink,
+      SimdOpsIterable auto p_original_first_occurence_position_sink, size_t p_map_element_count,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max(),
+      GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max(), bool initialize = true)
+      : m_key_sinks(p_key_sinks),
+        m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
+        m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
+        m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
+        m_group_id_count(0),
+        m_invalid_position(p_invalid_position),
+        m_invalid_gid(p_invalid_gid) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_map_element_count & (m_map_element_count - 1)) == 0);
+      }
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+
+    /**
+     * @brief Fills the key sinks with 0, the group ids with the invalid group id and the positions with the invalid
+     * position, a register at a time. The registers loaded at the last buckets may reach into the padding
+     * (bucket_padding), which is emptied as well. With p_thread_count > 1, the sinks are split into page aligned
+     * chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      auto const sink_count = m_map_element_count + bucket_padding<SimdStyle, HintSet>(m_map_element_count);
+      for (auto key_sink : m_key_sinks) {
+        fill_sink<SimdStyle, Idof>(key_sink, sink_count, KeyType{0}, p_thread_count);
+      }
+      fill_sink<SimdStyle, Idof>(m_group_id_sink, sink_count, m_invalid_gid, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_map_element_count, m_invalid_position, p_thread_count);
+    }
+
+    ~Grouper_Build_Hash_SIMD_Linear_Displacement_Composite() = default;
+
+   private:
+    /**
+     * @brief Inserts a composite key, every key column is compared with a register of buckets.
+     */
+    TSL_FORCE_INLINE auto insert(std::array<KeyType, ColumnCount> const &key, PositionType const key_position_in_data,
+                                 typename SimdStyle::imask_type const all_false_mask,
+                                 typename SimdStyle::register_type const invalid_gid_reg) noexcept -> void {
+      std::array<typename SimdStyle::register_type, ColumnCount> keys_reg;
+      for (size_t column = 0; column < ColumnCount; ++column) {
+        keys_reg[column] = tsl::set1<SimdStyle, Idof>(key[column]);
+      }
+      auto lookup_position = normalizer<SimdStyle, HintSet, Idof>::align_value(
+        normalizer<SimdStyle, HintSet, Idof>::normalize_value(hasher::hash_value(key), m_bucket_modulus));
+      while (true) {
+        auto const empty_bucket_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(m_group_id_sink + lookup_position), invalid_gid_reg);
+        auto key_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(m_key_sinks[0] + lookup_position), keys_reg[0]);
+        for (size_t column = 1; column < ColumnCount; ++column) {
+          key_found_mask = key_found_mask & tsl::equal_as_imask<SimdStyle, Idof>(
+                                              tsl::loadu<SimdStyle, Idof>(m_key_sinks[column] + lookup_position),
+                                              keys_reg[column]);
+        }
+        key_found_mask = key_found_mask & ~empty_bucket_mask;
+        if (tsl::nequal<SimdStyle, Idof>(key_found_mask, all_false_mask)) {
+          if constexpr (has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+            auto const group_id = m_group_id_sink[lookup_position + tsl::tzc<SimdStyle, Idof>(key_found_mask)];
+            if (m_original_positions_sink[group_id] > key_position_in_data) {
+              m_original_positions_sink[group_id] = key_position_in_data;
+            }
+          }
+          return;
+        }
+        if (tsl::nequal<SimdStyle, Idof>(empty_bucket_mask, all_false_mask)) {
+          auto const bucket = lookup_position + tsl::tzc<SimdStyle, Idof>(empty_bucket_mask);
+          for (size_t column = 0; column < ColumnCount; ++column) {
+            m_key_sinks[column][bucket] = key[column];
+          }
+          m_group_id_sink[bucket] = m_group_id_count;
+          m_original_positions_sink[m_group_id_count++] = key_position_in_data;
+          return;
+        }
+        lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
+      }
+    }
+
+   public:
+    /**
+     * @brief Inserts the composite keys given by the key columns.
+     *
+     * @param p_columns The key columns.
+     * @param p_count The number of keys.
+     * @param start_position The position of the first key.
+     */
+    auto operator()(std::array<KeyType const *, ColumnCount> const &p_columns, size_t p_count,
+                    PositionType start_position = 0) noexcept -> void {
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const invalid_gid_reg = tsl::set1<SimdStyle, Idof>(m_invalid_gid);
+      std::array<KeyType, ColumnCount> key;
+      for (size_t i = 0; i < p_count; ++i, ++start_position) {
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          key[column] = p_columns[column][i];
+        }
+        insert(key, start_position, all_false_mask, invalid_gid_reg);
+      }
+    }
+
+    /**
+     * @brief Merges another composite hash table into this one.
+     */
+    template <bool NeedsPosition = has_hint<HintSet, hints::grouping::global_first_occurence_required>>
+    auto merge(Grouper_Build_Hash_SIMD_Linear_Displacement_Composite const &other) noexcept -> void {
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const invalid_gid_reg = tsl::set1<SimdStyle, Idof>(m_invalid_gid);
+      // The last bucket group of other may reach beyond its last bucket.
+      auto const used_bucket_count =
+        other.m_map_element_count + bucket_padding<SimdStyle, HintSet>(other.m_map_element_count);
+      std::array<KeyType, ColumnCount> key;
+      for (size_t i = 0; i < used_bucket_count; ++i) {
+        auto const gid = other.m_group_id_sink[i];
+        if (gid == other.m_invalid_gid) {
+          continue;
+        }
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          key[column] = other.m_key_sinks[column][i];
+        }
+        insert(key, NeedsPosition ? other.m_original_positions_sink[gid] : 0, all_false_mask, invalid_gid_reg);
+      }
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  /**
+   * @brief Looks up the group ids of composite keys in a table built by
+   * Grouper_Build_Hash_SIMD_Linear_Displacement_Composite.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType, size_t ColumnCount,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Grouper_Hash_SIMD_Linear_Displacement_Composite {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using GroupIdType = typename SimdStyle::base_type;
+    using GroupIdSinkType = GroupIdType *;
+    using PositionType = _PositionType;
+    using hasher = composite_hasher<SimdStyle, HintSet, ColumnCount, Idof>;
+
+   private:
+    std::array<KeySinkType, ColumnCount> m_key_sinks;
+    GroupIdSinkType m_group_id_sink;
+    size_t const m_map_element_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    explicit Grouper_Hash_SIMD_Linear_Displacement_Composite(
+      std::array<KeySinkType, ColumnCount> const &p_key_sinks, SimdOpsIterable auto p_group_id_sink,
+      size_t p_map_element_count, GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max())
+      : m_key_sinks(p_key_sinks),
+        m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
+        m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
+        m_invalid_gid(p_invalid_gid) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_map_element_count & (m_map_element_count - 1)) == 0);
+      }
+    }
+
+   private:
+    TSL_FORCE_INLINE auto lookup(std::array<KeyType, ColumnCount> const &key,
+                                 typename SimdStyle::imask_type const all_false_mask,
+                                 typename SimdStyle::register_type const invalid_gid_reg) const noexcept
+      -> GroupIdType {
+      std::array<typename SimdStyle::register_type, ColumnCount> keys_reg;
+      for (size_t column = 0; column < ColumnCount; ++column) {
+        keys_reg[column] = tsl::set1<SimdStyle, Idof>(key[column]);
+      }
+      auto lookup_position = normalizer<SimdStyle, HintSet, Idof>::align_value(
+        normalizer<SimdStyle, HintSet, Idof>::normalize_value(hasher::hash_value(key), m_bucket_modulus));
+      while (true) {
+        auto const empty_bucket_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(m_group_id_sink + lookup_position), invalid_gid_reg);
+        auto key_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(m_key_sinks[0] + lookup_position), keys_reg[0]);
+        for (size_t column = 1; column < ColumnCount; ++column) {
+          key_found_mask = key_found_mask & tsl::equal_as_imask<SimdStyle, Idof>(
+                                              tsl::loadu<SimdStyle, Idof>(m_key_sinks[column] + lookup_position),
+                                              keys_reg[column]);
+        }
+        key_found_mask = key_found_mask & ~empty_bucket_mask;
+        if (tsl::nequal<SimdStyle, Idof>(key_found_mask, all_false_mask)) {
+          return m_group_id_sink[lookup_position + tsl::tzc<SimdStyle, Idof>(key_found_mask)];
+        }
+        if (tsl::nequal<SimdStyle, Idof>(empty_bucket_mask, all_false_mask)) {
+          // The key was not inserted.
+          return m_invalid_gid;
+        }
+        lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
+      }
+    }
+
+   public:
+    /**
+     * @brief Writes the group id of every composite key, keys that are not in the table get the invalid group id.
+     */
+    auto operator()(SimdOpsIterable auto p_output_gids, std::array<KeyType const *, ColumnCount> const &p_columns,
+                    size_t p_count) const noexcept -> void {
+      auto output_gids = reinterpret_iterable<GroupIdSinkType>(p_output_gids);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const invalid_gid_reg = tsl::set1<SimdStyle, Idof>(m_invalid_gid);
+      std::array<KeyType, ColumnCount> key;
+      for (size_t i = 0; i < p_count; ++i) {
+        for (size_t column = 0; column < ColumnCount; ++column) {
+          key[column] = p_columns[column][i];
+        }
+        output_gids[i] = lookup(key, all_false_mask, invalid_gid_reg);
+      }
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType, size_t ColumnCount,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  struct Grouper_SIMD_Linear_Displacement_Composite {
+    using builder_t =
+      Grouper_Build_Hash_SIMD_Linear_Displacement_Composite<_SimdStyle, _PositionType, ColumnCount, HintSet, Idof>;
+    using grouper_t =
+      Grouper_Hash_SIMD_Linear_Displacement_Composite<_SimdStyle, _PositionType, ColumnCount, HintSet, Idof>;
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_COMPOSITE_HPP
@@ -0,0 +1,286 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_concurrent.hpp
+ * @brief A grouping hash table that many threads build in place without locks.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_CONCURRENT_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_CONCURRENT_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief The concurrent counterpart of Grouper_Build_Hash_SIMD_Linear_Displacement.
+   *
+   * All threads insert into the same sinks, which have the layout of the serial table, so
+   * Grouper_Hash_SIMD_Linear_Displacement looks up the group ids afterwards. A register of buckets is loaded to find
+   * the key or empty buckets, the candidates are then confirmed with atomic accesses:
+   * - A new key claims the first empty bucket of its probing sequence with a CAS on the key slot. If the CAS observes
+   *   the same key, another thread inserted it concurrently, otherwise the next empty bucket is tried.
+   * - The winner draws its group id from an atomic counter, stores its position and then publishes the group id with
+   *   release semantics. Threads that found the key wait for the group id to be published.
+   * - With global_first_occurence_required, the first positions are lowered with a CAS loop.
+   * - With keys_may_contain_zero, the key equal to the empty bucket value cannot claim a bucket via its key slot. It
+   *   gets its group id via a CAS on a separate slot and is placed into the table by finalize().
+   *
+   * Slots are claimed once and never freed, which keeps the probing sequences of the serial table. Without
+   * global_first_occurence_required, the position of a group is the one of the thread that inserted it first.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Concurrent_Grouper_Build_Hash_SIMD_Linear_Displacement {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using GroupIdType = typename SimdStyle::base_type;
+    using GroupIdSinkType = GroupIdType *;
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+
+   private:
+    KeySinkType m_key_sink;
+    GroupIdSinkType m_group_id_sink;
+    PositionSinkType m_original_positions_sink;
+
+    size_t const m_map_element_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
+    std::atomic<size_t> m_group_id_count;
+    // Group id of the key that equals the empty bucket value (keys_may_contain_zero only).
+    std::atomic<GroupIdType> m_empty_value_group_id;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    auto distinct_key_count() const noexcept { return m_group_id_count.load(std::memory_order_acquire); }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto invalid_gid() const noexcept { return m_invalid_gid; }
+
+   public:
+    explicit Concurrent_Grouper_Build_Hash_SIMD_Linear_Displacement(void) = delete;
+    /**
+     * @brief Constructs a table on sinks that are shared by all inserting threads.
+     *
+     * @param p_key_sink The keys of the buckets, followed by bucket_padding<SimdStyle, HintSet>(p_map_element_count)
+     * entries of padding.
+     * @param p_group_id_sink The group ids of the buckets, padded like the keys.
+     * @param p_original_first_occurence_position_sink The first position of every group.
+     * @param p_map_element_count The number of buckets.
+     * @param initialize Flag indicating whether to initialize the hash table with empty buckets. Pass false to call
+     * initialize_sinks() with several threads instead.
+     */
+    explicit Concurrent_Grouper_Build_Hash_SIMD_Linear_Displacement(
+      SimdOpsIterable auto p_key_sink, SimdOpsIterable auto p_group_id_sink,
+      SimdOpsIterable auto p_original_first_occurence_position_sink, size_t p_map_element_count,
+      KeyType p_empty_bucket_value = 0, PositionType p_invalid_position = std::numeric_limits<PositionType>::max(),
+      GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max(), bool initialize = true)
+      : m_key_sink(reinterpret_iterable<KeySinkType>(p_key_sink)),
+        m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
+        m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
+        m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
+        m_group_id_count(0),
+        m_empty_value_group_id(p_invalid_gid),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position),
+        m_invalid_gid(p_invalid_gid) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_map_element_count & (m_map_element_count - 1)) == 0);
+      }
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+
+    ~Concurrent_Grouper_Build_Hash_SIMD_Linear_Displacement() = default;
+
+    /**
+     * @brief Fills the buckets and their padding with the empty bucket value and the invalid group id, and the
+     * positions with the invalid position. Has to finish before the first insert.
+     *
+     * A bucket of the padding is claimed like any other one, so its group id has to read invalid until the group id
+     * is published. With p_thread_count > 1, the sinks are split into page aligned chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      auto const sink_count = m_map_element_count + bucket_padding<SimdStyle, HintSet>(m_map_element_count);
+      fill_sink<SimdStyle, Idof>(m_key_sink, sink_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_group_id_sink, sink_count, m_invalid_gid, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_map_element_count, m_invalid_position, p_thread_count);
+    }
+
+   private:
+    TSL_FORCE_INLINE auto new_group(PositionType const key_position_in_data) noexcept -> GroupIdType {
+      auto const group_id = static_cast<GroupIdType>(m_group_id_count.fetch_add(1, std::memory_order_relaxed));
+      std::atomic_ref<PositionType>(m_original_positions_sink[group_id])
+        .store(key_position_in_data, std::memory_order_relaxed);
+      return group_id;
+    }
+
+    TSL_FORCE_INLINE auto lower_position(GroupIdType const group_id,
+                                         PositionType const key_position_in_data) noexcept -> void {
+      if constexpr (has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+        std::atomic_ref<PositionType> position(m_original_positions_sink[group_id]);
+        auto current = position.load(std::memory_order_relaxed);
+        while (key_position_in_data < current &&
+               !position.compare_exchange_weak(current, key_position_in_data, std::memory_order_relaxed)) {
+        }
+      }
+    }
+
+    /**
+     * @brief Waits until the thread that claimed the bucket has published its group id.
+     */
+    TSL_FORCE_INLINE auto published_group_id(size_t const bucket) const noexcept -> GroupIdType {
+      std::atomic_ref<GroupIdType> group_id_slot(m_group_id_sink[bucket]);
+      auto group_id = group_id_slot.load(std::memory_order_acquire);
+      while (group_id == m_invalid_gid) {
+        group_id = group_id_slot.load(std::memory_order_acquire);
+      }
+      return group_id;
+    }
+
+    TSL_FORCE_INLINE auto insert_empty_value(PositionType const key_position_in_data) noexcept -> void {
+      auto group_id = m_empty_value_group_id.load(std::memory_order_acquire);
+      if (group_id == m_invalid_gid) {
+        // Claim the group id slot with a placeholder, so that only one thread draws a group id.
+        auto const claimed = static_cast<GroupIdType>(m_invalid_gid - 1);
+        if (m_empty_value_group_id.compare_exchange_strong(group_id, claimed, std::memory_order_acq_rel)) {
+          m_empty_value_group_id.store(new_group(key_position_in_data), std::memory_order_release);
+          return;
+        }
+      }
+      while (group_id == static_cast<GroupIdType>(m_invalid_gid - 1)) {
+        group_id = m_empty_value_group_id.load(std::memory_order_acquire);
+      }
+      lower_position(group_id, key_position_in_data);
+    }
+
+    TSL_FORCE_INLINE auto insert(KeyType const key, PositionType const key_position_in_data,
+                                 typename SimdStyle::imask_type const all_false_mask,
+                                 typename SimdStyle::register_type const empty_bucket_reg) noexcept -> void {
+      if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
+        if (key == m_empty_bucket_value) {
+          insert_empty_value(key_position_in_data);
+          return;
+        }
+      }
+      auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+      auto lookup_position =
+        normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
+      while (true) {
+        // The register only filters candidate buckets, claimed key slots never change.
+        auto const map_reg = tsl::loadu<SimdStyle, Idof>(m_key_sink + lookup_position);
+        auto const key_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(map_reg, keys_reg);
+        if (tsl::nequal<SimdStyle, Idof>(key_found_mask, all_false_mask)) {
+          auto const group_id = published_group_id(lookup_position + tsl::tzc<SimdStyle, Idof>(key_found_mask));
+          lower_position(group_id, key_position_in_data);
+          return;
+        }
+        auto empty_bucket_mask = tsl::equal_as_imask<SimdStyle, Idof>(map_reg, empty_bucket_reg);
+        while (tsl::nequal<SimdStyle, Idof>(empty_bucket_mask, all_false_mask)) {
+          auto const lane = tsl::tzc<SimdStyle, Idof>(empty_bucket_mask);
+          auto const bucket = lookup_position + lane;
+          auto expected = m_empty_bucket_value;
+          if (std::atomic_ref<KeyType>(m_key_sink[bucket])
+                .compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+            std::atomic_ref<GroupIdType>(m_group_id_sink[bucket])
+              .store(new_group(key_position_in_data), std::memory_order_release);
+            return;
+          }
+          if (expected == key) {
+            // Another thread inserted the key into this bucket in the meantime.
+            lower_position(published_group_id(bucket), key_position_in_data);
+            return;
+          }
+          empty_bucket_mask = static_cast<typename SimdStyle::imask_type>(
+            empty_bucket_mask & ~(static_cast<typename SimdStyle::imask_type>(1) << lane));
+        }
+        lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
+      }
+    }
+
+   public:
+    /**
+     * @brief Inserts keys into the shared table, may be called by many threads concurrently.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param start_position The position of the first key.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    PositionType start_position = 0) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      for (; p_data != end; ++p_data, ++start_position) {
+        insert(*p_data, start_position, all_false_mask, empty_bucket_reg);
+      }
+    }
+
+    /**
+     * @brief Completes the table once all threads have finished inserting. With keys_may_contain_zero, the key that
+     * equals the empty bucket value is placed where the serial table would put it: into the first bucket of its
+     * probing sequence that holds the empty bucket value. The probe passes over the table once, if no bucket is empty
+     * the key gets no bucket and lookups cannot find it.
+     */
+    auto finalize() noexcept -> void {
+      if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
+        auto const group_id = m_empty_value_group_id.load(std::memory_order_acquire);
+        if (group_id == m_invalid_gid) {
+          return;
+        }
+        auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+        auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+        auto lookup_position =
+          normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+            hasher_t<SimdStyle, HintSet, Idof>::hash_value(m_empty_bucket_value), m_bucket_modulus));
+        for (size_t probed = 0; probed < m_map_element_count; probed += SimdStyle::vector_element_count()) {
+          auto const empty_bucket_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+            tsl::loadu<SimdStyle, Idof>(m_key_sink + lookup_position), empty_bucket_reg);
+          if (tsl::nequal<SimdStyle, Idof>(empty_bucket_mask, all_false_mask)) {
+            m_group_id_sink[lookup_position + tsl::tzc<SimdStyle, Idof>(empty_bucket_mask)] = group_id;
+            return;
+          }
+          lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+            lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
+        }
+      }
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_CONCURRENT_HPP
@@ -0,0 +1,239 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_growable.hpp
+ * @brief A grouping hash table that owns its memory and grows with the number of groups.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_GROWABLE_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_GROWABLE_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "algorithms/dbops/groupby/groupby_simd_linear_displacement.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "datastructures/aligned_buffer.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Builds a grouping hash table whose size does not have to be known up front.
+   *
+   * The keys, group ids and first positions are stored in aligned memory owned by this class (2 MiB aligned and
+   * advised to use huge pages with hints::memory::huge_pages). The input is inserted in chunks that cannot exceed the
+   * maximum load factor. When it is reached, the bucket count is doubled and all groups are moved into the new table
+   * via Grouper_Build_Hash_SIMD_Linear_Displacement::rehash, which keeps the group ids stable.
+   *
+   * @tparam _SimdStyle The SIMD processing style used to probe the table.
+   * @tparam _PositionType The type of the first positions.
+   * @tparam HintSet The hints of the underlying table, size_exp_2 rounds the initial bucket count up to a power of two.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Growable_Grouper_Build_Hash_SIMD_Linear_Displacement {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using GroupIdType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using table_t = Grouper_Build_Hash_SIMD_Linear_Displacement<SimdStyle, PositionType, HintSet, Idof>;
+    using grouper_t = Grouper_Hash_SIMD_Linear_Displacement<SimdStyle, PositionType, HintSet, Idof>;
+
+   private:
+    constexpr static bool use_huge_pages = has_hint<HintSet, hints::memory::huge_pages>;
+    // Bucket groups may start at the last bucket if the bucket count is not a power of two.
+    constexpr static size_t padding = SimdStyle::vector_element_count();
+
+    double const m_max_load_factor;
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+    GroupIdType const m_invalid_gid;
+
+    struct storage_t {
+      size_t bucket_count;
+      AlignedBuffer<KeyType> key_sink;
+      AlignedBuffer<GroupIdType> group_id_sink;
+      AlignedBuffer<PositionType> original_positions_sink;
+      std::unique_ptr<table_t> table;
+    };
+    storage_t m_storage;
+    size_t m_rehash_count = 0;
+
+   private:
+    /**
+     * @brief Allocates the memory for p_bucket_count buckets and creates an empty table on it.
+     */
+    auto allocate(size_t p_bucket_count) const -> storage_t {
+      storage_t storage{p_bucket_count, AlignedBuffer<KeyType>(p_bucket_count + padding, use_huge_pages),
+                        AlignedBuffer<GroupIdType>(p_bucket_count + padding, use_huge_pages),
+                        AlignedBuffer<PositionType>(p_bucket_count + padding, use_huge_pages), nullptr};
+      for (size_t i = p_bucket_count; i < p_bucket_count + padding; ++i) {
+        storage.key_sink[i] = m_empty_bucket_value;
+        storage.group_id_sink[i] = m_invalid_gid;
+      }
+      storage.table = std::make_unique<table_t>(storage.key_sink.data(), storage.group_id_sink.data(),
+                                                storage.original_positions_sink.data(), p_bucket_count,
+                                                m_empty_bucket_value, m_invalid_position, m_invalid_gid);
+      return storage;
+    }
+
+    /**
+     * @brief The number of groups that can be stored without exceeding the maximum load factor. At least one bucket
+     * stays empty, otherwise probing for a new key would not terminate.
+     */
+    auto max_group_count() const noexcept -> size_t {
+      return std::min(static_cast<size_t>(m_max_load_factor * m_storage.bucket_count), m_storage.bucket_count - 1);
+    }
+
+    static auto checked_load_factor(double p_max_load_factor) -> double {
+      if (!(p_max_load_factor > 0.0 && p_max_load_factor < 1.0)) {
+        throw std::invalid_argument("The maximum load factor has to be in (0, 1).");
+      }
+      return p_max_load_factor;
+    }
+
+    static auto initial_bucket_count(size_t p_bucket_count) noexcept -> size_t {
+      auto const bucket_count = std::max(p_bucket_count, 2 * SimdStyle::vector_element_count());
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        return std::bit_ceil(bucket_count);
+      } else {
+        return bucket_count;
+      }
+    }
+
+   public:
+    /**
+     * @brief Constructs an empty table.
+     *
+     * @param p_initial_bucket_count The number of buckets before the first resize.
+     * @param p_max_load_factor The ratio of groups to buckets that triggers a resize, has to be in (0, 1).
+     */
+    explicit Growable_Grouper_Build_Hash_SIMD_Linear_Displacement(
+      size_t p_initial_bucket_count = 1024, double p_max_load_factor = 0.7, KeyType p_empty_bucket_value = 0,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max(),
+      GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max())
+      : m_max_load_factor(checked_load_factor(p_max_load_factor)),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position),
+        m_invalid_gid(p_invalid_gid),
+        m_storage(allocate(initial_bucket_count(p_initial_bucket_count))) {}
+
+    auto distinct_key_count() const noexcept { return m_storage.table->distinct_key_count(); }
+    auto bucket_count() const noexcept { return m_storage.bucket_count; }
+    /**
+     * @brief The number of entries of the key and group id sinks. Beyond bucket_count(), they hold the groups of the
+     * last bucket group if the bucket count is not a power of two.
+     */
+    auto sink_size() const noexcept -> size_t { return m_storage.bucket_count + padding; }
+    auto load_factor() const noexcept -> double {
+      return static_cast<double>(distinct_key_count()) / static_cast<double>(m_storage.bucket_count);
+    }
+    auto rehash_count() const noexcept { return m_rehash_count; }
+
+    auto key_sink() const noexcept { return m_storage.key_sink.data(); }
+    auto group_id_sink() const noexcept { return m_storage.group_id_sink.data(); }
+    auto original_positions_sink() const noexcept { return m_storage.original_positions_sink.data(); }
+
+    /**
+     * @brief A grouper that looks up group ids in the current table. It is invalidated by a resize.
+     */
+    auto grouper() const -> grouper_t {
+      return grouper_t(key_sink(), group_id_sink(), original_positions_sink(), bucket_count());
+    }
+
+    /**
+     * @brief Doubles the bucket count and moves all groups into the new buckets.
+     */
+    auto grow() -> void {
+      auto storage = allocate(2 * m_storage.bucket_count);
+      storage.table->rehash(*m_storage.table);
+      m_storage = std::move(storage);
+      ++m_rehash_count;
+    }
+
+    /**
+     * @brief Inserts the keys into the table, growing it as needed.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param start_position The position of the first key.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0)
+      -> void {
+      auto const end = iter_end(p_data, p_end);
+      while (p_data != end) {
+        auto const headroom = max_group_count() - distinct_key_count();
+        if (headroom == 0) {
+          grow();
+          continue;
+        }
+        // A chunk cannot add more groups than it has keys.
+        auto const chunk = std::min<size_t>(headroom, static_cast<size_t>(end - p_data));
+        (*m_storage.table)(p_data, chunk, start_position);
+        p_data += chunk;
+        start_position += chunk;
+      }
+    }
+
+    /**
+     * @brief Inserts keys whose positions are given explicitly, growing the table as needed.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param p_positions The position of every key.
+     */
+    auto insert_at_positions(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                             SimdOpsIterable auto p_positions) -> void {
+      auto const end = iter_end(p_data, p_end);
+      while (p_data != end) {
+        auto const headroom = max_group_count() - distinct_key_count();
+        if (headroom == 0) {
+          grow();
+          continue;
+        }
+        auto const chunk = std::min<size_t>(headroom, static_cast<size_t>(end - p_data));
+        m_storage.table->insert_at_positions(p_data, chunk, p_positions);
+        p_data += chunk;
+        p_positions += chunk;
+      }
+    }
+
+    /**
+     * @brief Merges the groups of another growable table into this one, growing it beforehand if necessary.
+     */
+    auto merge(Growable_Grouper_Build_Hash_SIMD_Linear_Displacement const &other) -> void {
+      while (distinct_key_count() + other.distinct_key_count() > max_group_count()) {
+        grow();
+      }
+      m_storage.table->merge(*other.m_storage.table);
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_GROWABLE_HPP
@@ -28,6 +28,24 @@ namespace tuddbs {
   namespace hints {
     namespace grouping {
       struct global_first_occurence_required {};
+      /**
+       * @brief Build the hash table a register of keys at a time: every lane probes its own bucket via gather and
+       * in-register conflicts are resolved before new groups are inserted.
+       */
+      struct batched_insert {};
+      /**
+       * @brief Group by sorting the keys instead of hashing them, which keeps the accesses sequential if almost every
+       * key is its own group.
+       */
+      struct sort_based {};
+      /**
+       * @brief The keys are integers of a small, known range [min, min + K), which directly index the groups.
+       */
+      struct dense_keys {};
+      /**
+       * @brief Write the runs of a spilling grouping with O_DIRECT, so that they do not evict the page cache.
+       */
+      struct spill_direct_io {};
     }  // namespace grouping
   }    // namespace hints
 
@@ -0,0 +1,325 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_partitioned.hpp
+ * @brief Radix-partitioned grouping, where every partition is built into its own table by one worker.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_PARTITIONED_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_PARTITIONED_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/groupby/groupby_growable.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  namespace details {
+    /**
+     * @brief Computes the partition of p_count keys from p_radix_bits bits of their hashes, starting at bit p_shift.
+     */
+    template <tsl::VectorProcessingStyle SimdStyle, class HintSet, typename Idof, typename KeyType>
+    auto hash_partitions(KeyType const *p_keys, size_t p_count, unsigned p_shift, unsigned p_radix_bits,
+                         KeyType *p_partitions) noexcept -> void {
+      using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+      auto const partition_mask = static_cast<KeyType>((KeyType{1} << p_radix_bits) - 1);
+      size_t i = 0;
+      if constexpr (RegisterHasher<hasher, SimdStyle>) {
+        auto const partition_mask_reg = tsl::set1<SimdStyle, Idof>(partition_mask);
+        for (; i + SimdStyle::vector_element_count() <= p_count; i += SimdStyle::vector_element_count()) {
+          auto const hashes = hasher::hash(tsl::loadu<SimdStyle, Idof>(p_keys + i));
+          auto const high_bits = tsl::shift_right<SimdStyle, Idof>(hashes, static_cast<int>(p_shift));
+          tsl::storeu<SimdStyle, Idof>(p_partitions + i,
+                                       tsl::binary_and<SimdStyle, Idof>(high_bits, partition_mask_reg));
+        }
+      }
+      for (; i < p_count; ++i) {
+        auto const hash = static_cast<std::make_unsigned_t<KeyType>>(hasher::hash_value(p_keys[i]));
+        p_partitions[i] = static_cast<KeyType>((hash >> p_shift) & partition_mask);
+      }
+    }
+  }  // namespace details
+
+  /**
+   * @brief Groups keys in three phases that can run in parallel without a serial merge.
+   *
+   * 1. Every thread radix-partitions its input with its own partitioner_t by the high bits of the key hashes.
+   * 2. Every partition is built by one worker (build_partition) from that partition of all partitioners. Partitions
+   *    are disjoint in their keys, thus the workers need no synchronization. The tables use the low bits of the same
+   *    hash and grow as needed, a partition count that keeps every table in cache can be chosen with radix_bits_for.
+   * 3. finalize() assigns every partition a consecutive range of group ids and collects the first positions.
+   *
+   * The group ids are dense over all partitions and the first positions are global, if the partitioners are passed
+   * to build_partition in input order or the global_first_occurence_required hint is set.
+   *
+   * @tparam _SimdStyle The SIMD processing style of the keys and group ids.
+   * @tparam _PositionType The type of the first positions.
+   * @tparam HintSet The hints of the partition tables.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Partitioned_Grouper_Build_Hash_SIMD_Linear_Displacement {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using GroupIdType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using table_t = Growable_Grouper_Build_Hash_SIMD_Linear_Displacement<SimdStyle, PositionType, HintSet, Idof>;
+    using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+    static_assert(std::is_integral_v<KeyType>, "Keys are partitioned by the bits of their hash.");
+
+   private:
+    // Hashes of signed keys have a cleared sign bit.
+    constexpr static unsigned hash_bits = sizeof(KeyType) * CHAR_BIT - (std::is_signed_v<KeyType> ? 1 : 0);
+    // Number of keys whose partitions are computed at once.
+    constexpr static size_t partition_batch_size = 1024;
+
+    static auto checked_radix_bits(unsigned p_radix_bits) -> unsigned {
+      if (p_radix_bits == 0 || p_radix_bits >= hash_bits) {
+        throw std::invalid_argument("The number of radix bits has to be in [1, bits of the hash).");
+      }
+      return p_radix_bits;
+    }
+
+    /**
+     * @brief Computes the partition of p_count keys from the high bits of their hashes.
+     */
+    static auto partition_of(KeyType const *p_keys, size_t p_count, unsigned p_radix_bits,
+                             KeyType *p_partitions) noexcept -> void {
+      details::hash_partitions<SimdStyle, HintSet, Idof>(p_keys, p_count, hash_bits - p_radix_bits, p_radix_bits,
+                                                          p_partitions);
+    }
+
+   public:
+    /**
+     * @brief Radix-partitions the keys of one thread together with their positions.
+     */
+    class partitioner_t {
+      unsigned const m_radix_bits;
+      std::vector<std::vector<KeyType>> m_keys;
+      std::vector<std::vector<PositionType>> m_positions;
+
+     public:
+      explicit partitioner_t(unsigned p_radix_bits)
+        : m_radix_bits(checked_radix_bits(p_radix_bits)),
+          m_keys(size_t{1} << p_radix_bits),
+          m_positions(size_t{1} << p_radix_bits) {}
+
+      auto partition_count() const noexcept -> size_t { return m_keys.size(); }
+      auto keys(size_t p_partition) const noexcept -> std::vector<KeyType> const & { return m_keys[p_partition]; }
+      auto positions(size_t p_partition) const noexcept -> std::vector<PositionType> const & {
+        return m_positions[p_partition];
+      }
+
+      /**
+       * @brief Appends the keys to their partitions.
+       *
+       * @param p_data The keys.
+       * @param p_end The end of the keys or their number.
+       * @param start_position The position of the first key.
+       */
+      auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0)
+        -> void {
+        auto const end = iter_end(p_data, p_end);
+        alignas(64) std::array<KeyType, partition_batch_size> partitions;
+        while (p_data != end) {
+          auto const count = std::min<size_t>(partition_batch_size, static_cast<size_t>(end - p_data));
+          partition_of(&p_data[0], count, m_radix_bits, partitions.data());
+          for (size_t i = 0; i < count; ++i) {
+            m_keys[partitions[i]].push_back(p_data[i]);
+            m_positions[partitions[i]].push_back(start_position + static_cast<PositionType>(i));
+          }
+          p_data += count;
+          start_position += static_cast<PositionType>(count);
+        }
+      }
+    };
+
+    /**
+     * @brief Looks up group ids. The keys are partitioned, so every partition table is probed while it is cached.
+     */
+    class grouper_t {
+      unsigned const m_radix_bits;
+      std::vector<typename table_t::grouper_t> m_groupers;
+      std::vector<GroupIdType> m_group_id_offsets;
+
+     public:
+      grouper_t(unsigned p_radix_bits, std::vector<typename table_t::grouper_t> &&p_groupers,
+                std::vector<GroupIdType> p_group_id_offsets)
+        : m_radix_bits(p_radix_bits),
+          m_groupers(std::move(p_groupers)),
+          m_group_id_offsets(std::move(p_group_id_offsets)) {}
+
+      auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                      SimdOpsIterableOrSizeT auto p_end) const -> void {
+        auto const end = iter_end(p_data, p_end);
+        auto const partition_count = m_groupers.size();
+        alignas(64) std::array<KeyType, partition_batch_size> partitions;
+        std::vector<KeyType> keys(partition_batch_size);
+        std::vector<GroupIdType> gids(partition_batch_size);
+        std::vector<size_t> indices(partition_batch_size);
+        std::vector<size_t> partition_begin(partition_count + 1);
+        while (p_data != end) {
+          auto const count = std::min<size_t>(partition_batch_size, static_cast<size_t>(end - p_data));
+          partition_of(&p_data[0], count, m_radix_bits, partitions.data());
+          // Counting sort of the keys by their partition.
+          std::fill(partition_begin.begin(), partition_begin.end(), 0);
+          for (size_t i = 0; i < count; ++i) {
+            ++partition_begin[partitions[i] + 1];
+          }
+          for (size_t p = 0; p < partition_count; ++p) {
+            partition_begin[p + 1] += partition_begin[p];
+          }
+          for (size_t i = 0; i < count; ++i) {
+            auto const slot = partition_begin[partitions[i]]++;
+            keys[slot] = p_data[i];
+            indices[slot] = i;
+          }
+          // partition_begin now holds the end of every partition.
+          size_t first = 0;
+          for (size_t p = 0; p < partition_count; ++p) {
+            auto const last = partition_begin[p];
+            if (last != first) {
+              m_groupers[p](gids.data() + first, keys.data() + first, last - first);
+              for (size_t slot = first; slot < last; ++slot) {
+                p_output_gids[indices[slot]] = gids[slot] + m_group_id_offsets[p];
+              }
+            }
+            first = last;
+          }
+          p_data += count;
+          p_output_gids += count;
+        }
+      }
+    };
+
+   private:
+    unsigned const m_radix_bits;
+    std::vector<std::unique_ptr<table_t>> m_partitions;
+    std::vector<GroupIdType> m_group_id_offsets;
+    std::vector<PositionType> m_original_positions;
+
+   public:
+    /**
+     * @brief The smallest number of radix bits such that the expected groups of a partition fit into p_cache_bytes.
+     */
+    static auto radix_bits_for(size_t p_expected_group_count, size_t p_cache_bytes = size_t{256} << 10,
+                               double p_max_load_factor = 0.7) noexcept -> unsigned {
+      constexpr size_t bucket_bytes = sizeof(KeyType) + sizeof(GroupIdType) + sizeof(PositionType);
+      auto const groups_per_partition =
+        std::max<size_t>(1, static_cast<size_t>(p_max_load_factor * static_cast<double>(p_cache_bytes / bucket_bytes)));
+      auto const partitions = std::bit_ceil((p_expected_group_count + groups_per_partition - 1) / groups_per_partition);
+      return std::clamp<unsigned>(static_cast<unsigned>(std::countr_zero(partitions)), 1, hash_bits - 1);
+    }
+
+    /**
+     * @brief Constructs empty partition tables.
+     *
+     * @param p_radix_bits The number of hash bits that select the partition, there are 2^p_radix_bits partitions.
+     * @param p_initial_bucket_count The initial number of buckets of every partition table.
+     * @param p_max_load_factor The load factor at which a partition table grows.
+     */
+    explicit Partitioned_Grouper_Build_Hash_SIMD_Linear_Displacement(unsigned p_radix_bits,
+                                                                     size_t p_initial_bucket_count = 1024,
+                                                                     double p_max_load_factor = 0.7)
+      : m_radix_bits(checked_radix_bits(p_radix_bits)) {
+      m_partitions.reserve(size_t{1} << m_radix_bits);
+      for (size_t p = 0; p < (size_t{1} << m_radix_bits); ++p) {
+        m_partitions.push_back(std::make_unique<table_t>(p_initial_bucket_count, p_max_load_factor));
+      }
+    }
+
+    auto radix_bits() const noexcept { return m_radix_bits; }
+    auto partition_count() const noexcept -> size_t { return m_partitions.size(); }
+    auto partition(size_t p_partition) const noexcept -> table_t const & { return *m_partitions[p_partition]; }
+
+    auto make_partitioner() const -> partitioner_t { return partitioner_t(m_radix_bits); }
+
+    /**
+     * @brief Builds one partition table from that partition of all partitioners. Different partitions may be built
+     * concurrently.
+     */
+    auto build_partition(size_t p_partition, std::span<partitioner_t const> p_partitioners) -> void {
+      auto &table = *m_partitions[p_partition];
+      for (auto const &partitioner : p_partitioners) {
+        auto const &keys = partitioner.keys(p_partition);
+        if (!keys.empty()) {
+          table.insert_at_positions(keys.data(), keys.size(), partitioner.positions(p_partition).data());
+        }
+      }
+    }
+
+    /**
+     * @brief Assigns the group id ranges of the partitions and collects the first positions in group id order.
+     */
+    auto finalize() -> void {
+      m_group_id_offsets.assign(partition_count() + 1, 0);
+      for (size_t p = 0; p < partition_count(); ++p) {
+        m_group_id_offsets[p + 1] =
+          m_group_id_offsets[p] + static_cast<GroupIdType>(m_partitions[p]->distinct_key_count());
+      }
+      m_original_positions.resize(distinct_key_count());
+      for (size_t p = 0; p < partition_count(); ++p) {
+        auto const positions = m_partitions[p]->original_positions_sink();
+        std::copy(positions, positions + m_partitions[p]->distinct_key_count(),
+                  m_original_positions.begin() + m_group_id_offsets[p]);
+      }
+    }
+
+    /**
+     * @brief The number of groups, valid after finalize().
+     */
+    auto distinct_key_count() const noexcept -> size_t {
+      return m_group_id_offsets.empty() ? 0 : static_cast<size_t>(m_group_id_offsets.back());
+    }
+    auto group_id_offset(size_t p_partition) const noexcept { return m_group_id_offsets[p_partition]; }
+    /**
+     * @brief The first position of every group, indexed by the global group id. Valid after finalize().
+     */
+    auto original_positions_sink() const noexcept { return m_original_positions.data(); }
+
+    /**
+     * @brief A grouper that maps keys to global group ids. Requires finalize().
+     */
+    auto grouper() const -> grouper_t {
+      std::vector<typename table_t::grouper_t> groupers;
+      groupers.reserve(partition_count());
+      for (auto const &table : m_partitions) {
+        groupers.push_back(table->grouper());
+      }
+      return grouper_t(m_radix_bits, std::move(groupers), m_group_id_offsets);
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_PARTITIONED_HPP
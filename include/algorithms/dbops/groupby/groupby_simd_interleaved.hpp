@@ -0,0 +1,480 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_simd_interleaved.hpp
+ * @brief Grouping with a hash table whose bucket groups hold a register of keys followed by their group ids.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SIMD_INTERLEAVED_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SIMD_INTERLEAVED_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <limits>
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Builds a grouping hash table of InterleavedBucketGroup.
+   *
+   * A key hashes to a bucket group, full groups are probed linearly. The keys of a group are compared with one aligned
+   * SIMD load, the group id of a hit is read from the same bucket group, so a probe touches one cache line instead of a
+   * line in the key sink and one in the group id sink. The position of the first occurrence of a
+   * group is stored in a separate sink indexed by the group id, which lookups do not touch. Keys equal to the empty
+   * bucket value (hints::hashing::keys_may_contain_zero) are told apart from empty buckets by their group id.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  class Grouper_Build_Hash_SIMD_Interleaved {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using GroupIdType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+    using BucketGroupType = InterleavedBucketGroup<SimdStyle, GroupIdType>;
+    using BucketSinkType = BucketGroupType *;
+
+   private:
+    using imask_t = typename SimdStyle::imask_type;
+    constexpr static size_t buckets_per_group = BucketGroupType::bucket_count;
+    constexpr static bool keys_may_contain_zero = has_hint<HintSet, hints::hashing::keys_may_contain_zero>;
+
+    BucketSinkType m_bucket_sink;
+    PositionSinkType m_original_positions_sink;
+
+    size_t const m_group_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_group_modulus;
+    size_t m_group_id_count;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    /**
+     * @brief Returns the number of bucket groups for p_map_element_count buckets. The bucket sink holds this many
+     * groups, the position sink this many times BucketGroupType::bucket_count positions.
+     */
+    constexpr static auto bucket_group_count(size_t p_map_element_count) noexcept -> size_t {
+      return (p_map_element_count + buckets_per_group - 1) / buckets_per_group;
+    }
+
+    auto distinct_key_count() const noexcept { return m_group_id_count; }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto invalid_gid() const noexcept { return m_invalid_gid; }
+    auto group_count() const noexcept { return m_group_count; }
+    auto bucket_sink() const noexcept -> BucketGroupType const * { return m_bucket_sink; }
+    auto position_sink() const noexcept -> PositionType const * { return m_original_positions_sink; }
+
+   public:
+    explicit Grouper_Build_Hash_SIMD_Interleaved(void) = delete;
+
+    /**
+     * @param p_bucket_sink bucket_group_count(p_map_element_count) bucket groups.
+     * @param p_original_first_occurence_position_sink The position of the first occurrence of every group.
+     * @param p_map_element_count The number of buckets, rounded up to whole bucket groups.
+     * @param initialize Flag indicating whether to initialize the hash table with empty values.
+     */
+    explicit Grouper_Build_Hash_SIMD_Interleaved(
+      BucketSinkType p_bucket_sink, SimdOpsIterable auto p_original_first_occurence_position_sink,
+      size_t p_map_element_count, KeyType p_empty_bucket_value = 0,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max(),
+      GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max(), bool initialize = true)
+      : m_bucket_sink(p_bucket_sink),
+        m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
+        m_group_count(bucket_group_count(p_map_element_count)),
+        m_group_modulus(bucket_group_count(p_map_element_count)),
+        m_group_id_count(0),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position),
+        m_invalid_gid(p_invalid_gid) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_group_count & (m_group_count - 1)) == 0);
+      }
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+
+    ~Grouper_Build_Hash_SIMD_Interleaved() = default;
+
+    /**
+     * @brief Fills the keys with the empty bucket value, the group ids with the invalid group id and the positions with
+     * the invalid position.
+     */
+    auto initialize_sinks() noexcept -> void {
+      for (size_t group = 0; group < m_group_count; ++group) {
+        fill_sink<SimdStyle, Idof>(m_bucket_sink[group].keys.data(), buckets_per_group, m_empty_bucket_value);
+        fill_sink<SimdStyle, Idof>(m_bucket_sink[group].payloads.data(), buckets_per_group, m_invalid_gid);
+      }
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_group_count * buckets_per_group, m_invalid_position);
+    }
+
+   private:
+    TSL_FORCE_INLINE auto first_group(KeyType const key) const noexcept -> size_t {
+      return static_cast<size_t>(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+        hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_group_modulus));
+    }
+
+    TSL_FORCE_INLINE auto next_group(size_t const group) const noexcept -> size_t {
+      return (group + 1 == m_group_count) ? 0 : group + 1;
+    }
+
+    /**
+     * @brief Inserts a key, or finds it, and returns its group id.
+     *
+     * As buckets are never emptied, a group with an empty bucket ends the probing sequence: a key that is not in this
+     * group is not in any later group either.
+     */
+    TSL_FORCE_INLINE auto insert(KeyType const key, PositionType const key_position_in_data,
+                                 typename SimdStyle::register_type const empty_bucket_reg) noexcept -> GroupIdType {
+      auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+      for (auto group = first_group(key);; group = next_group(group)) {
+        auto &bucket_group = m_bucket_sink[group];
+        auto const map_reg = bucket_group.template load_keys<Idof>();
+        auto found = static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, keys_reg) &
+                                          BucketGroupType::bucket_lanes());
+        auto empty = static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, empty_bucket_reg) &
+                                          BucketGroupType::bucket_lanes());
+        if constexpr (keys_may_contain_zero) {
+          if (key == m_empty_bucket_value) {
+            found = bucket_group.template occupied_lanes<Idof>(found, m_invalid_gid);
+            empty = static_cast<imask_t>(empty & ~found);
+          } else if (empty != 0) {
+            empty = static_cast<imask_t>(empty & ~bucket_group.template occupied_lanes<Idof>(empty, m_invalid_gid));
+          }
+        }
+        if (found != 0) {
+          auto const group_id = bucket_group.payloads[tsl::tzc<SimdStyle, Idof>(found)];
+          if constexpr (has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+            if (m_original_positions_sink[group_id] > key_position_in_data) {
+              m_original_positions_sink[group_id] = key_position_in_data;
+            }
+          }
+          return group_id;
+        }
+        if (empty != 0) {
+          auto const lane = tsl::tzc<SimdStyle, Idof>(empty);
+          auto const group_id = static_cast<GroupIdType>(m_group_id_count++);
+          bucket_group.keys[lane] = key;
+          bucket_group.payloads[lane] = group_id;
+          m_original_positions_sink[group_id] = key_position_in_data;
+          return group_id;
+        }
+      }
+    }
+
+    /**
+     * @brief Inserts the keys for which p_is_valid(i) holds. With hints::operators::preserve_original_positions, the
+     * position of a key is its index in p_data, otherwise the valid keys are numbered consecutively.
+     */
+    TSL_FORCE_INLINE auto insert_selected(KeyType const *p_data, size_t const p_count, PositionType start_position,
+                                          auto &&p_is_valid) noexcept -> void {
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      for (size_t i = 0; i < p_count; ++i) {
+        if (p_is_valid(i)) {
+          insert(p_data[i], start_position, empty_bucket_reg);
+          if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            ++start_position;
+          }
+        }
+        if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+          ++start_position;
+        }
+      }
+    }
+
+   public:
+    /**
+     * @brief Inserts elements into the hash table.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    PositionType start_position = 0) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      for (; p_data != end; ++p_data, ++start_position) {
+        insert(*p_data, start_position, empty_bucket_reg);
+      }
+    }
+
+    /**
+     * @brief Inserts the elements that are valid according to a bitmask of a mask per register.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                    PositionType start_position = 0, activate_for_bit_mask<HS> = {}) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      if (p_data == end) {
+        return;
+      }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      insert_selected(&p_data[0], static_cast<size_t>(end - p_data), start_position, [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(
+          tsl::load_imask<SimdStyle, Idof>(valid_masks + i / SimdStyle::vector_element_count()),
+          i % SimdStyle::vector_element_count());
+      });
+    }
+
+    /**
+     * @brief Inserts the elements that are valid according to a dense bitmask.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                    PositionType start_position = 0, activate_for_dense_bit_mask<HS> = {}) noexcept -> void {
+      constexpr auto const bits_per_mask = sizeof(typename SimdStyle::imask_type) * CHAR_BIT;
+      auto const end = iter_end(p_data, p_end);
+      if (p_data == end) {
+        return;
+      }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      insert_selected(&p_data[0], static_cast<size_t>(end - p_data), start_position, [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(tsl::load_imask<SimdStyle, Idof>(valid_masks + i / bits_per_mask),
+                                               i % bits_per_mask);
+      });
+    }
+
+    /**
+     * @brief Inserts elements and writes the group id of every key to p_output_gids, indexed like p_data.
+     */
+    auto build_with_gids(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                         SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      for (; p_data != end; ++p_data, ++p_output_gids, ++start_position) {
+        *p_output_gids = insert(*p_data, start_position, empty_bucket_reg);
+      }
+    }
+
+    /**
+     * @brief Merges another hash table into this hash table.
+     */
+    template <bool NeedsPosition = has_hint<HintSet, hints::grouping::global_first_occurence_required>,
+              tsl::TSLArithmetic OtherPositionType, class OtherHintSet, typename OtherIdof>
+    auto merge(Grouper_Build_Hash_SIMD_Interleaved<SimdStyle, OtherPositionType, OtherHintSet, OtherIdof> const &other)
+      noexcept -> void {
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      auto const other_invalid_gid = other.invalid_gid();
+      for (size_t group = 0; group < other.group_count(); ++group) {
+        auto const &bucket_group = other.bucket_sink()[group];
+        for (size_t lane = 0; lane < buckets_per_group; ++lane) {
+          auto const gid = bucket_group.payloads[lane];
+          if (gid != other_invalid_gid) {
+            if constexpr (NeedsPosition) {
+              insert(bucket_group.keys[lane], other.position_sink()[gid], empty_bucket_reg);
+            } else {
+              insert(bucket_group.keys[lane], 0, empty_bucket_reg);
+            }
+          }
+        }
+      }
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  /**
+   * @brief Looks up the group ids of keys in a table built by Grouper_Build_Hash_SIMD_Interleaved. The keys are looked
+   * up in batches whose bucket groups are prefetched ahead of their probes.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  class Grouper_Hash_SIMD_Interleaved {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using GroupIdType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using BucketGroupType = InterleavedBucketGroup<SimdStyle, GroupIdType>;
+    using BucketSinkType = BucketGroupType const *;
+
+   private:
+    using imask_t = typename SimdStyle::imask_type;
+    using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+    constexpr static size_t lane_count = SimdStyle::vector_element_count();
+    constexpr static bool hash_registers = std::is_integral_v<KeyType> && RegisterHasher<hasher, SimdStyle>;
+    // Number of registers of keys whose bucket groups are prefetched ahead of their lookup.
+    constexpr static size_t lookup_prefetch_distance = 4;
+    constexpr static size_t lookup_batch_size = lookup_prefetch_distance * lane_count;
+
+    BucketSinkType m_bucket_sink;
+    size_t const m_group_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_group_modulus;
+    KeyType const m_empty_bucket_value;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    explicit Grouper_Hash_SIMD_Interleaved(BucketSinkType p_bucket_sink, size_t p_map_element_count,
+                                           KeyType p_empty_bucket_value = 0,
+                                           GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max())
+      : m_bucket_sink(p_bucket_sink),
+        m_group_count(Grouper_Build_Hash_SIMD_Interleaved<SimdStyle, PositionType, HintSet, Idof>::bucket_group_count(
+          p_map_element_count)),
+        m_group_modulus(m_group_count),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_gid(p_invalid_gid) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_group_count & (m_group_count - 1)) == 0);
+      }
+    }
+    ~Grouper_Hash_SIMD_Interleaved() = default;
+
+   private:
+    /**
+     * @brief Probes the bucket groups for key, starting at group. The key has to be in the table.
+     */
+    TSL_FORCE_INLINE auto probe(KeyType const key, size_t group) const noexcept -> GroupIdType {
+      auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+      while (true) {
+        auto const &bucket_group = m_bucket_sink[group];
+        auto found = static_cast<imask_t>(
+          tsl::equal_as_imask<SimdStyle, Idof>(bucket_group.template load_keys<Idof>(), keys_reg) &
+          BucketGroupType::bucket_lanes());
+        if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
+          if (key == m_empty_bucket_value) {
+            found = bucket_group.template occupied_lanes<Idof>(found, m_invalid_gid);
+          }
+        }
+        if (found != 0) {
+          return bucket_group.payloads[tsl::tzc<SimdStyle, Idof>(found)];
+        }
+        group = (group + 1 == m_group_count) ? 0 : group + 1;
+      }
+    }
+
+    template <class IsValid>
+    TSL_FORCE_INLINE auto prepare_batch(KeyType const *p_keys, size_t p_count, size_t *p_groups,
+                                        IsValid &&is_valid) const noexcept -> void {
+      alignas(64) std::array<KeyType, lookup_batch_size> hashes;
+      size_t i = 0;
+      if constexpr (hash_registers) {
+        for (; i + lane_count <= p_count; i += lane_count) {
+          tsl::store<SimdStyle, Idof>(hashes.data() + i, hasher::hash(tsl::loadu<SimdStyle, Idof>(p_keys + i)));
+        }
+      }
+      for (; i < p_count; ++i) {
+        hashes[i] = hasher::hash_value(p_keys[i]);
+      }
+      for (i = 0; i < p_count; ++i) {
+        p_groups[i] =
+          static_cast<size_t>(normalizer<SimdStyle, HintSet, Idof>::normalize_value(hashes[i], m_group_modulus));
+        if (is_valid(i)) {
+          __builtin_prefetch(m_bucket_sink + p_groups[i]);
+        }
+      }
+    }
+
+    template <class IsValid>
+    auto lookup_batched(SimdOpsIterable auto p_output_gids, KeyType const *p_keys, size_t p_count,
+                        IsValid &&is_valid) const noexcept -> void {
+      std::array<size_t, lookup_batch_size> groups[2];
+      size_t current = 0;
+      prepare_batch(p_keys, std::min(lookup_batch_size, p_count), groups[current].data(), is_valid);
+      for (size_t first = 0; first < p_count; first += lookup_batch_size, current ^= 1) {
+        auto const next_first = first + lookup_batch_size;
+        if (next_first < p_count) {
+          prepare_batch(p_keys + next_first, std::min(lookup_batch_size, p_count - next_first),
+                        groups[current ^ 1].data(), [&](size_t i) { return is_valid(next_first + i); });
+        }
+        auto const batch_end = std::min(lookup_batch_size, p_count - first);
+        for (size_t i = 0; i < batch_end; ++i) {
+          if (is_valid(first + i)) {
+            p_output_gids[first + i] = probe(p_keys[first + i], groups[current][i]);
+          }
+        }
+      }
+    }
+
+   public:
+    /**
+     * @brief Writes the group id of every key.
+     */
+    auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end) const noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      if (p_data == end) {
+        return;
+      }
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [](size_t) { return true; });
+    }
+
+    /**
+     * @brief Writes the group ids of the keys that are valid according to a bitmask of a mask per register.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    SimdOpsIterable auto p_valid_masks, activate_for_bit_mask<HS> = {}) const noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      if (p_data == end) {
+        return;
+      }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(tsl::load_imask<SimdStyle, Idof>(valid_masks + i / lane_count),
+                                               i % lane_count);
+      });
+    }
+
+    /**
+     * @brief Writes the group ids of the keys that are valid according to a dense bitmask.
+     */
+    template <class HS = HintSet>
+    auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    SimdOpsIterable auto p_valid_masks, activate_for_dense_bit_mask<HS> = {}) const noexcept -> void {
+      constexpr auto const bits_per_mask = sizeof(typename SimdStyle::imask_type) * CHAR_BIT;
+      auto const end = iter_end(p_data, p_end);
+      if (p_data == end) {
+        return;
+      }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(tsl::load_imask<SimdStyle, Idof>(valid_masks + i / bits_per_mask),
+                                               i % bits_per_mask);
+      });
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherPositionType, class OtherHintSet,
+              typename OtherIdof>
+    auto merge(Grouper_Hash_SIMD_Interleaved<OtherSimdStlye, OtherPositionType, OtherHintSet, OtherIdof> const &other)
+      const noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  struct Grouper_SIMD_Interleaved {
+    using builder_t = Grouper_Build_Hash_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>;
+    using grouper_t = Grouper_Hash_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>;
+  };
+}  // namespace tuddbs
+#endif
@@ -24,13 +24,17 @@
 #ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SIMD_LINEAR_DISPLACEMENT_HPP
 #define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SIMD_LINEAR_DISPLACEMENT_HPP
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <climits>
 #include <type_traits>
 
 #include "algorithms/dbops/dbops_hints.hpp"
 #include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/utils/conflict_detection.hpp"
 #include "algorithms/utils/hashing.hpp"
+#include "datastructures/compressed_bitmap.hpp"
 #include "iterable.hpp"
 #include "static/utils/type_concepts.hpp"
 #include "tsl.hpp"
@@ -70,12 +74,29 @@ namespace tuddbs {
     PositionSinkType m_original_positions_sink;
 
     size_t const m_map_element_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
     size_t m_group_id_count;
 
     KeyType const m_empty_bucket_value;
     PositionType const m_invalid_position;
     GroupIdType const m_invalid_gid;
 
+    // Lanes narrower than 32 bit cannot be gathered.
+    constexpr static bool gather_probing = (SimdStyle::vector_element_count() > 1) && std::is_integral_v<KeyType> &&
+                                           (sizeof(KeyType) >= sizeof(uint32_t));
+    // Keys that equal the empty bucket value need the scalar special cases.
+    constexpr static bool batched_insert = has_hint<HintSet, hints::grouping::batched_insert> &&
+                                           !has_hint<HintSet, hints::hashing::keys_may_contain_zero> && gather_probing;
+
+    constexpr static bool reusable = has_hint<HintSet, hints::hashing::reusable_table>;
+    DirtyBucketTracker m_dirty_buckets;
+
+    TSL_FORCE_INLINE auto mark_dirty(size_t const bucket) noexcept -> void {
+      if constexpr (reusable) {
+        m_dirty_buckets.mark(bucket);
+      }
+    }
+
    public:
     auto distinct_key_count() const noexcept { return m_group_id_count; }
     auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
@@ -87,11 +108,16 @@ namespace tuddbs {
     /**
      * @brief Constructs a Grouper_Build_Hash_SIMD_Linear_Displacement object.
      *
+     * The key and group id sinks hold p_map_element_count + bucket_padding<SimdStyle, HintSet>(p_map_element_count)
+     * entries: if the bucket count is neither a power of two (size_exp_2) nor a multiple of vector_element_count(), the
+     * probes of the last buckets read a register of padding behind them.
+     *
      * @param p_key_sink Pointer to the memory location where the keys will be stored.
      * @param p_group_id_sink Pointer to the memory location where the group IDs will be stored.
      * @param p_overall_key_count The total number of keys to be inserted into the hash table.
      * @param p_map_element_count The number of elements in the hash table.
-     * @param initialize Flag indicating whether to initialize the hash table with empty values.
+     * @param initialize Flag indicating whether to initialize the hash table with empty values. Pass false to call
+     * initialize_sinks() with several threads instead.
      */
     explicit Grouper_Build_Hash_SIMD_Linear_Displacement(
       SimdOpsIterable auto p_key_sink, SimdOpsIterable auto p_group_id_sink,
@@ -102,19 +128,18 @@ namespace tuddbs {
         m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
         m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
         m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_group_id_count(0),
         m_empty_bucket_value(p_empty_bucket_value),
         m_invalid_position(p_invalid_position),
-        m_invalid_gid(p_invalid_gid) {
+        m_invalid_gid(p_invalid_gid),
+        m_dirty_buckets(reusable ? DirtyBucketTracker(p_map_element_count + SimdStyle::vector_element_count())
+                                 : DirtyBucketTracker()) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_map_element_count & (m_map_element_count - 1)) == 0);
       }
       if (initialize) {
-        for (auto i = 0; i < m_map_element_count; ++i) {
-          m_key_sink[i] = m_empty_bucket_value;
-          m_group_id_sink[i] = m_invalid_gid;
-          m_original_positions_sink[i] = m_invalid_position;
-        }
+        initialize_sinks();
       }
     }
     template <tsl::VectorProcessingStyle OtherSimdStlye, typename OtherPositionType, class OtherHintSet,
@@ -128,18 +153,17 @@ namespace tuddbs {
         m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
         m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
         m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_group_id_count(0),
         m_empty_bucket_value(other.empty_bucket_value()),
         m_invalid_position(other.invalid_position()),
-        m_invalid_gid(other.invalid_gid()) {
+        m_invalid_gid(other.invalid_gid()),
+        m_dirty_buckets(reusable ? DirtyBucketTracker(p_map_element_count + SimdStyle::vector_element_count())
+                                 : DirtyBucketTracker()) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_map_element_count & (m_map_element_count - 1)) == 0);
       }
-      for (auto i = 0; i < m_map_element_count; ++i) {
-        m_key_sink[i] = m_empty_bucket_value;
-        m_group_id_sink[i] = m_invalid_gid;
-        m_original_positions_sink[i] = m_invalid_position;
-      }
+      initialize_sinks();
       merge<true>(other);
     }
 
@@ -148,6 +172,37 @@ namespace tuddbs {
      */
     ~Grouper_Build_Hash_SIMD_Linear_Displacement() = default;
 
+    /**
+     * @brief Fills the sinks with the empty bucket value, the invalid group id and the invalid position.
+     *
+     * The sinks are written a register at a time, large sinks with non-temporal stores. With p_thread_count > 1, the
+     * sinks are split into page aligned chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      fill_sink<SimdStyle, Idof>(m_key_sink, m_map_element_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_group_id_sink, m_map_element_count, m_invalid_gid, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_map_element_count, m_invalid_position, p_thread_count);
+      // The registers loaded at the last buckets may reach into the padding, which has to be empty as well.
+      auto const padding = bucket_padding<SimdStyle, HintSet>(m_map_element_count);
+      fill_sink<SimdStyle, Idof>(m_key_sink + m_map_element_count, padding, m_empty_bucket_value);
+      fill_sink<SimdStyle, Idof>(m_group_id_sink + m_map_element_count, padding, m_invalid_gid);
+    }
+
+    /**
+     * @brief Empties the hash table for the next build. Only the blocks of buckets that were written and the positions
+     * of the groups are restored, thus the cost depends on the number of groups instead of the size of the table.
+     */
+    template <class HS = HintSet>
+    auto reset(enable_if_has_hint_t<HS, hints::hashing::reusable_table> = {}) noexcept -> void {
+      m_dirty_buckets.for_each_dirty_range([this](size_t begin, size_t end) {
+        fill_sink<SimdStyle, Idof>(m_key_sink + begin, end - begin, m_empty_bucket_value);
+        fill_sink<SimdStyle, Idof>(m_group_id_sink + begin, end - begin, m_invalid_gid);
+      });
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_group_id_count, m_invalid_position);
+      m_dirty_buckets.clear();
+      m_group_id_count = 0;
+    }
+
    private:
     /**
      * @brief Inserts a key into the hash table using SIMD and linear displacement.
@@ -160,16 +215,17 @@ namespace tuddbs {
      * @param key The key to insert into the hash table.
      * @param all_false_mask The SIMD mask representing all false values.
      * @param empty_bucket_reg The SIMD register containing the value representing an empty bucket.
+     * @return The group id of the key.
      */
     TSL_FORCE_INLINE auto insert(typename SimdStyle::base_type const key, PositionType const key_position_in_data,
                                  typename SimdStyle::imask_type const all_false_mask,
-                                 typename SimdStyle::register_type const empty_bucket_reg) noexcept -> void {
+                                 typename SimdStyle::register_type const empty_bucket_reg) noexcept -> GroupIdType {
       // broadcast the key to all lanes
       auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
       // calculate the position hint
       auto lookup_position =
         normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          default_hasher<SimdStyle, Idof>::hash_value(key), m_map_element_count));
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
 
       typename SimdStyle::register_type map_reg;
       while (true) {
@@ -194,6 +250,8 @@ namespace tuddbs {
               // invalid, we did not see the key before and have to insert it. Otherwise we have to check, whether the
               // current key position is smaller than the original position of the key.
               if (group_id == m_invalid_gid) {
+                mark_dirty(lookup_position + found_position);
+                group_id = m_group_id_count;
                 m_group_id_sink[lookup_position + found_position] = m_group_id_count;
                 m_original_positions_sink[m_group_id_count++] = key_position_in_data;
               } else {
@@ -217,41 +275,230 @@ namespace tuddbs {
               }
             }
           }
-          break;
+          return group_id;
         }
         // if the key is not found, we have to check if there is an empty bucket in the map
         auto const empty_bucket_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(map_reg, empty_bucket_reg);
         if (tsl::nequal<SimdStyle, Idof>(empty_bucket_found_mask, all_false_mask)) {
           size_t empty_bucket_position = tsl::tzc<SimdStyle, Idof>(empty_bucket_found_mask);
+          auto const new_group_id = static_cast<GroupIdType>(m_group_id_count);
 
+          bool insert_here = true;
           if constexpr (has_hint<HintSet, hints::hashing::keys_may_contain_zero>) {
-            auto group_id = m_group_id_sink[lookup_position + empty_bucket_position];
-            if (group_id != m_invalid_gid) {
-              auto updated_empty_bucket_found_mask =
-                tsl::shift_right<SimdStyle, false, Idof>(empty_bucket_found_mask, empty_bucket_position + 1);
-              if (tsl::nequal<SimdStyle, Idof>(updated_empty_bucket_found_mask, all_false_mask)) {
-                // As there can be only a single occurence of the key that equals an empty bucket, we only have to use
-                // the first occurence
-                auto updated_empty_bucket_position =
-                  tsl::tzc<SimdStyle, Idof>(updated_empty_bucket_found_mask) + empty_bucket_position + 1;
-                m_key_sink[lookup_position + updated_empty_bucket_position] = key;
-                m_group_id_sink[lookup_position + updated_empty_bucket_position] = m_group_id_count;
-                m_original_positions_sink[m_group_id_count++] = key_position_in_data;
+            if (m_group_id_sink[lookup_position + empty_bucket_position] != m_invalid_gid) {
+              // The first "empty" bucket holds the key that equals the empty bucket value. As there is only a single
+              // such bucket, the next empty bucket of the register (if any) is really empty.
+              using imask_t = typename SimdStyle::imask_type;
+              auto const remaining_empty_bucket_mask = static_cast<imask_t>(
+                empty_bucket_found_mask & ~(static_cast<imask_t>(1) << empty_bucket_position));
+              insert_here = tsl::nequal<SimdStyle, Idof>(remaining_empty_bucket_mask, all_false_mask);
+              if (insert_here) {
+                empty_bucket_position = tsl::tzc<SimdStyle, Idof>(remaining_empty_bucket_mask);
               }
-            } else {
-              m_key_sink[lookup_position + empty_bucket_position] = key;
-              m_group_id_sink[lookup_position + empty_bucket_position] = m_group_id_count;
-              m_original_positions_sink[m_group_id_count++] = key_position_in_data;
             }
-          } else {
+          }
+          if (insert_here) {
+            mark_dirty(lookup_position + empty_bucket_position);
             m_key_sink[lookup_position + empty_bucket_position] = key;
             m_group_id_sink[lookup_position + empty_bucket_position] = m_group_id_count;
             m_original_positions_sink[m_group_id_count++] = key_position_in_data;
+            return new_group_id;
           }
-          break;
+          // Otherwise, the register is full and the probing continues with the next one.
         }
         lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          lookup_position + SimdStyle::vector_element_count(), m_map_element_count);
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
+      }
+    }
+
+    TSL_FORCE_INLINE auto normalize_positions(typename SimdStyle::register_type const position_hints) const noexcept {
+      if constexpr (std::is_same_v<typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t, KeyType>) {
+        return normalizer<SimdStyle, HintSet, Idof>::normalize(position_hints,
+                                                                tsl::set1<SimdStyle, Idof>(m_bucket_modulus));
+      } else {
+        return normalizer<SimdStyle, HintSet, Idof>::normalize(position_hints, m_bucket_modulus);
+      }
+    }
+
+    /**
+     * @brief Inserts a register of keys into the hash table.
+     *
+     * Every lane walks the same buckets as insert() would, one bucket per round: The keys in the current buckets are
+     * gathered and compared against the lane's key and the empty bucket value. Lanes that found their key are done,
+     * lanes that found a different key move on to the next bucket. Of all lanes that found an empty bucket, only the
+     * lowest lane per bucket inserts its key, the others retry the same bucket in the next round and either find the
+     * key that was just inserted (duplicates within the register) or move on. Group ids stay dense but are assigned in
+     * insertion order, which may differ from the lane order within a register.
+     *
+     * @param keys_reg The keys to insert.
+     * @param first_key_position The position of the key in the first lane, the other lanes follow consecutively.
+     * @param p_gids If WriteGids, receives the group id of every lane.
+     */
+    template <bool WriteGids = false>
+    TSL_FORCE_INLINE auto insert_batch(typename SimdStyle::register_type const keys_reg,
+                                       PositionType const first_key_position,
+                                       typename SimdStyle::register_type const empty_bucket_reg,
+                                       GroupIdType *p_gids = nullptr) noexcept -> void {
+      using imask_t = typename SimdStyle::imask_type;
+      alignas(64) std::array<KeyType, SimdStyle::vector_element_count()> keys;
+      alignas(64) std::array<KeyType, SimdStyle::vector_element_count()> buckets;
+
+      // Like insert(), every lane starts at the beginning of the aligned bucket group of its key.
+      auto const position_hints = normalize_positions(hasher_t<SimdStyle, HintSet, Idof>::hash(keys_reg));
+      auto bucket_groups = tsl::sub<SimdStyle, Idof>(
+        position_hints, tsl::binary_and<SimdStyle, Idof>(
+                          position_hints, tsl::set1<SimdStyle, Idof>(SimdStyle::vector_element_count() - 1)));
+      auto offsets = tsl::set1<SimdStyle, Idof>(0);
+      bool keys_stored = false;
+
+      imask_t active = all_lanes_imask<SimdStyle>();
+      while (active != 0) {
+        auto const buckets_reg = tsl::add<SimdStyle, Idof>(bucket_groups, offsets);
+        auto const map_reg = tsl::gather<SimdStyle, Idof>(m_key_sink, buckets_reg);
+        auto const found =
+          static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, keys_reg) & active);
+        auto const empty =
+          static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, empty_bucket_reg) & active & ~found);
+        auto const inserting = static_cast<imask_t>(empty & ~conflicting_lanes<SimdStyle, Idof>(buckets_reg, empty));
+
+        if constexpr (WriteGids || has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+          if (found != 0) {
+            tsl::store<SimdStyle, Idof>(buckets.data(), buckets_reg);
+            for (imask_t lanes = found; lanes != 0; lanes = static_cast<imask_t>(lanes & (lanes - 1))) {
+              auto const lane = tsl::tzc<SimdStyle, Idof>(lanes);
+              auto const group_id = m_group_id_sink[buckets[lane]];
+              if constexpr (WriteGids) {
+                p_gids[lane] = group_id;
+              }
+              if constexpr (has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+                if (m_original_positions_sink[group_id] > first_key_position + lane) {
+                  m_original_positions_sink[group_id] = first_key_position + lane;
+                }
+              }
+            }
+          }
+        }
+        if (inserting != 0) {
+          if (!keys_stored) {
+            tsl::store<SimdStyle, Idof>(keys.data(), keys_reg);
+            keys_stored = true;
+          }
+          tsl::store<SimdStyle, Idof>(buckets.data(), buckets_reg);
+          // Scatter the new groups, the buckets are distinct after the conflict detection.
+          for (imask_t lanes = inserting; lanes != 0; lanes = static_cast<imask_t>(lanes & (lanes - 1))) {
+            auto const lane = tsl::tzc<SimdStyle, Idof>(lanes);
+            mark_dirty(buckets[lane]);
+            if constexpr (WriteGids) {
+              p_gids[lane] = static_cast<GroupIdType>(m_group_id_count);
+            }
+            m_key_sink[buckets[lane]] = keys[lane];
+            m_group_id_sink[buckets[lane]] = m_group_id_count;
+            m_original_positions_sink[m_group_id_count++] = first_key_position + lane;
+          }
+        }
+
+        // Lanes that hit a different key advance to the next bucket.
+        advance_lanes(bucket_groups, offsets, static_cast<imask_t>(active & ~found & ~empty));
+        active = static_cast<imask_t>(active & ~found & ~inserting);
+      }
+    }
+
+    /**
+     * @brief Moves the advancing lanes to their next bucket, crossing into the next bucket group like insert().
+     */
+    TSL_FORCE_INLINE auto advance_lanes(typename SimdStyle::register_type &bucket_groups,
+                                        typename SimdStyle::register_type &offsets,
+                                        typename SimdStyle::imask_type const advancing) const noexcept -> void {
+      using imask_t = typename SimdStyle::imask_type;
+      if (advancing == 0) {
+        return;
+      }
+      auto const bucket_group_size_reg = tsl::set1<SimdStyle, Idof>(SimdStyle::vector_element_count());
+      auto const advancing_mask = tsl::load_mask<SimdStyle, Idof>(&advancing);
+      auto const next_offsets = tsl::add<SimdStyle, Idof>(offsets, tsl::set1<SimdStyle, Idof>(1));
+      offsets = tsl::blend<SimdStyle, Idof>(advancing_mask, offsets, next_offsets);
+      imask_t const next_group =
+        static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(offsets, bucket_group_size_reg) & advancing);
+      if (next_group != 0) {
+        auto const next_group_mask = tsl::load_mask<SimdStyle, Idof>(&next_group);
+        bucket_groups = tsl::blend<SimdStyle, Idof>(
+          next_group_mask, bucket_groups,
+          normalize_positions(tsl::add<SimdStyle, Idof>(bucket_groups, bucket_group_size_reg)));
+        offsets = tsl::blend<SimdStyle, Idof>(next_group_mask, offsets, tsl::set1<SimdStyle, Idof>(0));
+      }
+    }
+
+    /**
+     * @brief Moves a register of groups of another table into this one, see rehash().
+     *
+     * Like insert_batch(), every active lane walks the buckets of its key one per round. As the keys are distinct, a
+     * lane only looks for a free bucket, i.e. one with an invalid group id, which also covers the key that equals the
+     * empty bucket value. Of all lanes that found the same free bucket, the lowest one takes it.
+     *
+     * @param keys_reg The keys of the groups.
+     * @param gids_reg The group ids of the groups, they are kept.
+     * @param active The lanes that hold a group.
+     */
+    TSL_FORCE_INLINE auto rehash_batch(typename SimdStyle::register_type const keys_reg,
+                                       typename SimdStyle::register_type const gids_reg,
+                                       typename SimdStyle::imask_type active) noexcept -> void {
+      using imask_t = typename SimdStyle::imask_type;
+      alignas(64) std::array<KeyType, SimdStyle::vector_element_count()> keys;
+      alignas(64) std::array<GroupIdType, SimdStyle::vector_element_count()> gids;
+      alignas(64) std::array<KeyType, SimdStyle::vector_element_count()> buckets;
+      tsl::store<SimdStyle, Idof>(keys.data(), keys_reg);
+      tsl::store<SimdStyle, Idof>(gids.data(), gids_reg);
+
+      auto const invalid_gid_reg = tsl::set1<SimdStyle, Idof>(m_invalid_gid);
+      auto const position_hints = normalize_positions(hasher_t<SimdStyle, HintSet, Idof>::hash(keys_reg));
+      auto bucket_groups = tsl::sub<SimdStyle, Idof>(
+        position_hints, tsl::binary_and<SimdStyle, Idof>(
+                          position_hints, tsl::set1<SimdStyle, Idof>(SimdStyle::vector_element_count() - 1)));
+      auto offsets = tsl::set1<SimdStyle, Idof>(0);
+      while (active != 0) {
+        auto const buckets_reg = tsl::add<SimdStyle, Idof>(bucket_groups, offsets);
+        auto const free = static_cast<imask_t>(
+          tsl::equal_as_imask<SimdStyle, Idof>(tsl::gather<SimdStyle, Idof>(m_group_id_sink, buckets_reg),
+                                               invalid_gid_reg) &
+          active);
+        auto const inserting = static_cast<imask_t>(free & ~conflicting_lanes<SimdStyle, Idof>(buckets_reg, free));
+        if (inserting != 0) {
+          tsl::store<SimdStyle, Idof>(buckets.data(), buckets_reg);
+          for (imask_t lanes = inserting; lanes != 0; lanes = static_cast<imask_t>(lanes & (lanes - 1))) {
+            auto const lane = tsl::tzc<SimdStyle, Idof>(lanes);
+            mark_dirty(buckets[lane]);
+            m_key_sink[buckets[lane]] = keys[lane];
+            m_group_id_sink[buckets[lane]] = gids[lane];
+          }
+        }
+        // Lanes that lost a free bucket to a lower lane retry it and find it taken in the next round.
+        advance_lanes(bucket_groups, offsets, static_cast<imask_t>(active & ~free));
+        active = static_cast<imask_t>(active & ~inserting);
+      }
+    }
+
+    /**
+     * @brief Moves a single group of another table into this one, see rehash().
+     */
+    TSL_FORCE_INLINE auto rehash_insert(KeyType const key, GroupIdType const gid,
+                                        typename SimdStyle::imask_type const all_false_mask,
+                                        typename SimdStyle::register_type const invalid_gid_reg) noexcept -> void {
+      auto lookup_position =
+        normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
+      while (true) {
+        // A key equal to the empty bucket value occupies a bucket that looks empty but has a valid group id.
+        auto const free_bucket_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(m_group_id_sink + lookup_position), invalid_gid_reg);
+        if (tsl::nequal<SimdStyle, Idof>(free_bucket_mask, all_false_mask)) {
+          auto const bucket = lookup_position + tsl::tzc<SimdStyle, Idof>(free_bucket_mask);
+          mark_dirty(bucket);
+          m_key_sink[bucket] = key;
+          m_group_id_sink[bucket] = gid;
+          return;
+        }
+        lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
       }
     }
 
@@ -260,7 +507,8 @@ namespace tuddbs {
      * @brief Inserts elements into the hash table.
      *
      * This function inserts elements into the hash table by iterating over the input data and calling the insert
-     * function for each element. It uses SIMD instructions to process multiple elements in parallel.
+     * function for each element. It uses SIMD instructions to process multiple elements in parallel. With
+     * hints::grouping::batched_insert, full registers are inserted by insert_batch().
      *
      * @param p_data The input data to insert into the hash table.
      * @param p_end The end iterator of the input data.
@@ -273,6 +521,13 @@ namespace tuddbs {
       auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
       auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
 
+      if constexpr (batched_insert) {
+        auto const simd_end = simd_iter_end<SimdStyle>(p_data, p_end);
+        for (; p_data != simd_end;
+             p_data += SimdStyle::vector_element_count(), start_position += SimdStyle::vector_element_count()) {
+          insert_batch(tsl::loadu<SimdStyle, Idof>(p_data), start_position, empty_bucket_reg);
+        }
+      }
       for (; p_data != end; ++p_data, ++start_position) {
         auto key = *p_data;
         insert(key, start_position, all_false_mask, empty_bucket_reg);
@@ -297,11 +552,11 @@ namespace tuddbs {
           if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
             auto key = p_data[i];
             insert(key, start_position, all_false_mask, empty_bucket_reg);
-            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           } else {
-            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           }
@@ -314,11 +569,11 @@ namespace tuddbs {
           if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
             auto key = *p_data;
             insert(key, start_position, all_false_mask, empty_bucket_reg);
-            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           } else {
-            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           }
@@ -326,6 +581,46 @@ namespace tuddbs {
       }
     }
 
+    /**
+     * @brief Inserts the elements selected by a compressed bitmap into the hash table.
+     *
+     * @param p_data The input data (the positions of the bitmap refer to this column).
+     * @param p_selection The selected positions.
+     * @param start_position The position of the first selected element, used if original positions are not preserved.
+     */
+    template <tsl::VectorProcessingStyle BitmapSimdStyle, typename BitmapIdof>
+    auto operator()(SimdOpsIterable auto p_data, CompressedBitmap<BitmapSimdStyle, BitmapIdof> const &p_selection,
+                    PositionType start_position = 0) noexcept -> void {
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      p_selection.for_each_batch([&](size_t const *positions, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+          if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            insert(p_data[positions[i]], static_cast<PositionType>(positions[i]), all_false_mask, empty_bucket_reg);
+          } else {
+            insert(p_data[positions[i]], start_position++, all_false_mask, empty_bucket_reg);
+          }
+        }
+      });
+    }
+
+    /**
+     * @brief Inserts keys whose positions are given explicitly instead of being consecutive, e.g. a radix partition.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param p_positions The position of every key.
+     */
+    auto insert_at_positions(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                             SimdOpsIterable auto p_positions) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      for (; p_data != end; ++p_data, ++p_positions) {
+        insert(*p_data, static_cast<PositionType>(*p_positions), all_false_mask, empty_bucket_reg);
+      }
+    }
+
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
                     PositionType start_position = 0, activate_for_dense_bit_mask<HS> = {}) noexcept -> void {
@@ -345,11 +640,11 @@ namespace tuddbs {
           if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
             auto key = p_data[i];
             insert(key, start_position, all_false_mask, empty_bucket_reg);
-            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           } else {
-            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           }
@@ -362,11 +657,11 @@ namespace tuddbs {
           if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
             auto key = *p_data;
             insert(key, start_position, all_false_mask, empty_bucket_reg);
-            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           } else {
-            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>()) {
+            if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
               ++start_position;
             }
           }
@@ -374,6 +669,139 @@ namespace tuddbs {
       }
     }
 
+    /**
+     * @brief Inserts elements like operator() and writes the group id of every key to p_output_gids.
+     *
+     * The group ids are known when a key is inserted or found, so this saves the second pass of
+     * Grouper_Hash_SIMD_Linear_Displacement, which hashes and probes every key again. Aggregates can be computed
+     * afterwards by indexing arrays with the group ids. With hints::grouping::batched_insert, the group ids of a
+     * register are collected by insert_batch().
+     *
+     * @param p_output_gids The group id of every key, indexed like p_data.
+     * @param p_data The input data to insert into the hash table.
+     * @param p_end The end iterator of the input data.
+     */
+    auto build_with_gids(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                         SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0) noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+
+      if constexpr (batched_insert) {
+        alignas(64) std::array<GroupIdType, SimdStyle::vector_element_count()> gids;
+        auto const simd_end = simd_iter_end<SimdStyle>(p_data, p_end);
+        for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(),
+                                   p_output_gids += SimdStyle::vector_element_count(),
+                                   start_position += SimdStyle::vector_element_count()) {
+          insert_batch<true>(tsl::loadu<SimdStyle, Idof>(p_data), start_position, empty_bucket_reg, gids.data());
+          for (size_t lane = 0; lane < SimdStyle::vector_element_count(); ++lane) {
+            p_output_gids[lane] = gids[lane];
+          }
+        }
+      }
+      for (; p_data != end; ++p_data, ++p_output_gids, ++start_position) {
+        *p_output_gids = insert(*p_data, start_position, all_false_mask, empty_bucket_reg);
+      }
+    }
+
+    /**
+     * @brief Inserts the elements that are valid according to a bitmask of a mask per register and writes their group
+     * ids to p_output_gids. The group ids of invalid keys are not written.
+     */
+    template <class HS = HintSet>
+    auto build_with_gids(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                         SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                         PositionType start_position = 0, activate_for_bit_mask<HS> = {}) noexcept -> void {
+      // Get the end of the SIMD iteration
+      auto const simd_end = simd_iter_end<SimdStyle>(p_data, p_end);
+      // Get the end of the data
+      auto const end = iter_end(p_data, p_end);
+
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+
+      for (; p_data != simd_end;
+           p_data += SimdStyle::vector_element_count(), p_output_gids += SimdStyle::vector_element_count(),
+           ++valid_masks) {
+        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        for (size_t i = 0; i < SimdStyle::vector_element_count(); ++i) {
+          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
+            p_output_gids[i] = insert(p_data[i], start_position, all_false_mask, empty_bucket_reg);
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
+              ++start_position;
+            }
+          }
+          if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            ++start_position;
+          }
+        }
+      }
+      if (p_data != end) {
+        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        for (size_t i = 0; p_data != end; ++p_data, ++p_output_gids, ++i) {
+          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
+            *p_output_gids = insert(*p_data, start_position, all_false_mask, empty_bucket_reg);
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
+              ++start_position;
+            }
+          }
+          if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            ++start_position;
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief Inserts the elements that are valid according to a dense bitmask and writes their group ids to
+     * p_output_gids. The group ids of invalid keys are not written.
+     */
+    template <class HS = HintSet>
+    auto build_with_gids(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                         SimdOpsIterableOrSizeT auto p_end, SimdOpsIterable auto p_valid_masks,
+                         PositionType start_position = 0, activate_for_dense_bit_mask<HS> = {}) noexcept -> void {
+      constexpr auto const bits_per_mask = sizeof(typename SimdStyle::imask_type) * CHAR_BIT;
+      // Get the end of the SIMD iteration
+      auto const batched_end_end = batched_iter_end<bits_per_mask>(p_data, p_end);
+      // Get the end of the data
+      auto const end = iter_end(p_data, p_end);
+
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+
+      for (; p_data != batched_end_end; p_data += bits_per_mask, p_output_gids += bits_per_mask, ++valid_masks) {
+        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        for (size_t i = 0; i < bits_per_mask; ++i) {
+          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
+            p_output_gids[i] = insert(p_data[i], start_position, all_false_mask, empty_bucket_reg);
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
+              ++start_position;
+            }
+          }
+          if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            ++start_position;
+          }
+        }
+      }
+      if (p_data != end) {
+        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
+        for (size_t i = 0; p_data != end; ++p_data, ++p_output_gids, ++i) {
+          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
+            *p_output_gids = insert(*p_data, start_position, all_false_mask, empty_bucket_reg);
+            if constexpr (!has_hint<HintSet, hints::operators::preserve_original_positions>) {
+              ++start_position;
+            }
+          }
+          if constexpr (has_hint<HintSet, hints::operators::preserve_original_positions>) {
+            ++start_position;
+          }
+        }
+      }
+    }
+
     /**
      * @brief Merges another hash table into this hash table.
      *
@@ -394,7 +822,10 @@ namespace tuddbs {
       auto const &other_gid_sink = other.m_group_id_sink;
       auto const &other_key_sink = other.m_key_sink;
       auto const &other_position_sink = other.m_original_positions_sink;
-      for (auto i = 0; i < other.m_map_element_count; ++i) {
+      // The last bucket group of other may reach beyond its last bucket.
+      auto const used_bucket_count =
+        other.m_map_element_count + bucket_padding<OtherSimdStlye, OtherHintSet>(other.m_map_element_count);
+      for (size_t i = 0; i < used_bucket_count; ++i) {
         auto const gid = other_gid_sink[i];
         if (gid != other_invalid_gid) {
           auto const key = other_key_sink[i];
@@ -408,6 +839,49 @@ namespace tuddbs {
       }
     }
 
+    /**
+     * @brief Moves all groups of another hash table into this empty one, keeping their group ids and first positions.
+     *
+     * This is used to grow a hash table. As the keys of other are distinct, every key is placed into the first free
+     * bucket of its probing sequence without comparing keys. The buckets of other are read a register at a time and
+     * their groups are reinserted together via gathers (rehash_batch), unless the keys are narrower than 32 bit. The
+     * sinks of both tables have to be padded by bucket_padding() entries, like for building.
+     *
+     * @param other The hash table to take the groups from, usually smaller than this one.
+     */
+    auto rehash(Grouper_Build_Hash_SIMD_Linear_Displacement const &other) noexcept -> void {
+      assert(m_group_id_count == 0);
+      assert(other.m_group_id_count < m_map_element_count);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const invalid_gid_reg = tsl::set1<SimdStyle, Idof>(m_invalid_gid);
+      // The last bucket group of other may reach beyond its last bucket.
+      auto const used_bucket_count =
+        other.m_map_element_count + bucket_padding<SimdStyle, HintSet>(other.m_map_element_count);
+      size_t i = 0;
+      if constexpr (gather_probing) {
+        using imask_t = typename SimdStyle::imask_type;
+        auto const other_invalid_gid_reg = tsl::set1<SimdStyle, Idof>(other.m_invalid_gid);
+        for (; i + SimdStyle::vector_element_count() <= used_bucket_count; i += SimdStyle::vector_element_count()) {
+          auto const gids_reg = tsl::loadu<SimdStyle, Idof>(other.m_group_id_sink + i);
+          auto const occupied = static_cast<imask_t>(
+            ~tsl::equal_as_imask<SimdStyle, Idof>(gids_reg, other_invalid_gid_reg) & all_lanes_imask<SimdStyle>());
+          if (occupied != 0) {
+            rehash_batch(tsl::loadu<SimdStyle, Idof>(other.m_key_sink + i), gids_reg, occupied);
+          }
+        }
+      }
+      for (; i < used_bucket_count; ++i) {
+        auto const gid = other.m_group_id_sink[i];
+        if (gid != other.m_invalid_gid) {
+          rehash_insert(other.m_key_sink[i], gid, all_false_mask, invalid_gid_reg);
+        }
+      }
+      for (size_t gid = 0; gid < other.m_group_id_count; ++gid) {
+        m_original_positions_sink[gid] = other.m_original_positions_sink[gid];
+      }
+      m_group_id_count = other.m_group_id_count;
+    }
+
     /**
      * @brief Finalizes the hash table.
      *
@@ -432,6 +906,7 @@ namespace tuddbs {
     KeySinkType m_key_sink;
     GroupIdSinkType m_group_id_sink;
     size_t const m_map_element_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
 
    public:
     explicit Grouper_Hash_SIMD_Linear_Displacement(KeySinkType p_key_sink, GroupIdSinkType p_group_id_sink,
@@ -439,7 +914,8 @@ namespace tuddbs {
                                                    size_t p_map_element_count)
       : m_key_sink(reinterpret_iterable<KeySinkType>(p_key_sink)),
         m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
-        m_map_element_count(p_map_element_count) {
+        m_map_element_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_map_element_count & (m_map_element_count - 1)) == 0);
       }
@@ -447,15 +923,29 @@ namespace tuddbs {
     ~Grouper_Hash_SIMD_Linear_Displacement() = default;
 
    private:
-    TSL_FORCE_INLINE auto lookup(typename SimdStyle::base_type const key,
-                                 typename SimdStyle::imask_type const all_false_mask) const noexcept -> GroupIdType {
+    // Number of registers of keys whose buckets are prefetched ahead of their lookup.
+    constexpr static size_t lookup_prefetch_distance = 4;
+    constexpr static size_t lookup_batch_size = lookup_prefetch_distance * SimdStyle::vector_element_count();
+
+    using hasher = hasher_t<SimdStyle, HintSet, Idof>;
+    constexpr static bool hash_registers = std::is_integral_v<KeyType> && RegisterHasher<hasher, SimdStyle>;
+
+    TSL_FORCE_INLINE auto normalize_positions(typename SimdStyle::register_type const position_hints) const noexcept {
+      if constexpr (std::is_same_v<typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t, KeyType>) {
+        return normalizer<SimdStyle, HintSet, Idof>::normalize(position_hints,
+                                                                tsl::set1<SimdStyle, Idof>(m_bucket_modulus));
+      } else {
+        return normalizer<SimdStyle, HintSet, Idof>::normalize(position_hints, m_bucket_modulus);
+      }
+    }
+
+    /**
+     * @brief Probes the buckets for key, starting at the aligned bucket group lookup_position.
+     */
+    TSL_FORCE_INLINE auto probe(typename SimdStyle::base_type const key, size_t lookup_position,
+                                typename SimdStyle::imask_type const all_false_mask) const noexcept -> GroupIdType {
       // broadcast the key to all lanes
       auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
-      // calculate the position hint
-      auto lookup_position =
-        normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          default_hasher<SimdStyle, Idof>::hash_value(key), m_map_element_count));
-      // std::cout << "Search Key: " << key << "\n";
       while (true) {
         // load N values from the map
         auto map_reg = tsl::loadu<SimdStyle, Idof>(m_key_sink + lookup_position);
@@ -466,84 +956,128 @@ namespace tuddbs {
           return m_group_id_sink[lookup_position + position];
         }
         lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          lookup_position + SimdStyle::vector_element_count(), m_map_element_count);
+          lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
       }
       // this should never be reached
       return 0;
     }
 
+    /**
+     * @brief Computes the first bucket group of p_count keys and prefetches it for the keys that are looked up.
+     *
+     * @param p_keys The keys, contiguous in memory.
+     * @param p_bucket_groups The aligned first bucket group of every key.
+     * @param is_valid Whether the key at an index is looked up at all.
+     */
+    template <class IsValid>
+    TSL_FORCE_INLINE auto prepare_batch(KeyType const *p_keys, size_t p_count, size_t *p_bucket_groups,
+                                        IsValid &&is_valid) const noexcept -> void {
+      alignas(64) std::array<KeyType, lookup_batch_size> position_hints;
+      size_t i = 0;
+      if constexpr (hash_registers) {
+        for (; i + SimdStyle::vector_element_count() <= p_count; i += SimdStyle::vector_element_count()) {
+          tsl::store<SimdStyle, Idof>(position_hints.data() + i,
+                                      normalize_positions(hasher::hash(tsl::loadu<SimdStyle, Idof>(p_keys + i))));
+        }
+      }
+      for (; i < p_count; ++i) {
+        position_hints[i] = normalizer<SimdStyle, HintSet, Idof>::normalize_value(hasher::hash_value(p_keys[i]),
+                                                                                  m_bucket_modulus);
+      }
+      for (i = 0; i < p_count; ++i) {
+        p_bucket_groups[i] = normalizer<SimdStyle, HintSet, Idof>::align_value(position_hints[i]);
+        if (is_valid(i)) {
+          __builtin_prefetch(m_key_sink + p_bucket_groups[i]);
+          __builtin_prefetch(m_group_id_sink + p_bucket_groups[i]);
+        }
+      }
+    }
+
+    /**
+     * @brief Looks up the group ids of p_count keys with group prefetching.
+     *
+     * The keys are processed in batches of lookup_batch_size. While the keys of one batch are probed, the hashes of the
+     * next batch are computed a register at a time and its bucket groups are prefetched, so the cache misses of a
+     * whole batch overlap instead of stalling every probe.
+     *
+     * @param p_output_gids The group ids, only written for valid keys.
+     * @param p_keys The keys, contiguous in memory.
+     * @param is_valid Whether the key at an index (relative to p_keys) is looked up.
+     */
+    template <class IsValid>
+    auto lookup_batched(SimdOpsIterable auto p_output_gids, KeyType const *p_keys, size_t p_count,
+                        IsValid &&is_valid) const noexcept -> void {
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      std::array<size_t, lookup_batch_size> bucket_groups[2];
+      size_t current = 0;
+      prepare_batch(p_keys, std::min(lookup_batch_size, p_count), bucket_groups[current].data(), is_valid);
+      for (size_t first = 0; first < p_count; first += lookup_batch_size, current ^= 1) {
+        auto const next_first = first + lookup_batch_size;
+        if (next_first < p_count) {
+          prepare_batch(p_keys + next_first, std::min(lookup_batch_size, p_count - next_first),
+                        bucket_groups[current ^ 1].data(), [&](size_t i) { return is_valid(next_first + i); });
+        }
+        auto const batch_end = std::min(lookup_batch_size, p_count - first);
+        for (size_t i = 0; i < batch_end; ++i) {
+          if (is_valid(first + i)) {
+            p_output_gids[first + i] = probe(p_keys[first + i], bucket_groups[current][i], all_false_mask);
+          }
+        }
+      }
+    }
+
    public:
+    /**
+     * @brief Writes the group id of every key.
+     */
     auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
                     SimdOpsIterableOrSizeT auto p_end) const noexcept -> void {
       // Get the end of the data
       auto const end = iter_end(p_data, p_end);
-
-      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
-
-      for (; p_data != end; ++p_data, ++p_output_gids) {
-        auto key = *p_data;
-        *p_output_gids = lookup(key, all_false_mask);
+      if (p_data == end) {
+        return;
       }
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [](size_t) { return true; });
     }
 
+    /**
+     * @brief Writes the group ids of the keys that are valid according to a bitmask of a mask per register. The group
+     * ids of invalid keys are not written.
+     */
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
                     SimdOpsIterable auto p_valid_masks, activate_for_bit_mask<HS> = {}) const noexcept -> void {
-      // Get the end of the SIMD iteration
-      auto const simd_end = simd_iter_end<SimdStyle>(p_data, p_end);
       // Get the end of the data
       auto const end = iter_end(p_data, p_end);
-
-      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
-
-      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
-
-      for (; p_data != simd_end; p_data += SimdStyle::vector_element_count(), ++valid_masks) {
-        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
-        for (size_t i = 0; i < SimdStyle::vector_element_count(); ++i, ++p_output_gids) {
-          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
-            auto key = *p_data;
-            *p_output_gids = lookup(key, all_false_mask);
-          }
-        }
-      }
-      for (; p_data != end; ++p_data, ++p_output_gids) {
-        auto key = *p_data;
-        *p_output_gids = lookup(key, all_false_mask);
+      if (p_data == end) {
+        return;
       }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(
+          tsl::load_imask<SimdStyle, Idof>(valid_masks + i / SimdStyle::vector_element_count()),
+          i % SimdStyle::vector_element_count());
+      });
     }
 
+    /**
+     * @brief Writes the group ids of the keys that are valid according to a dense bitmask. The group ids of invalid
+     * keys are not written.
+     */
     template <class HS = HintSet>
     auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
                     SimdOpsIterable auto p_valid_masks, activate_for_dense_bit_mask<HS> = {}) const noexcept -> void {
       constexpr auto const bits_per_mask = sizeof(typename SimdStyle::imask_type) * CHAR_BIT;
-      // Get the end of the SIMD iteration
-      auto const batched_end_end = batched_iter_end<bits_per_mask>(p_data, p_end);
       // Get the end of the data
       auto const end = iter_end(p_data, p_end);
-
-      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
-      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
-
-      for (; p_data != batched_end_end; p_data += bits_per_mask, ++valid_masks) {
-        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
-        for (size_t i = 0; i < bits_per_mask; ++i, ++p_output_gids) {
-          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
-            auto key = p_data[i];
-            *p_output_gids = lookup(key, all_false_mask);
-          }
-        }
-      }
-      if (p_data != end) {
-        auto valid_mask = tsl::load_imask<SimdStyle, Idof>(valid_masks);
-        int i = 0;
-        for (; p_data != end; ++p_data, ++i, ++p_output_gids) {
-          if (tsl::test_mask<SimdStyle, Idof>(valid_mask, i)) {
-            auto key = *p_data;
-            *p_output_gids = lookup(key, all_false_mask);
-          }
-        }
+      if (p_data == end) {
+        return;
       }
+      auto valid_masks = reinterpret_iterable<typename SimdStyle::imask_type *>(p_valid_masks);
+      lookup_batched(p_output_gids, &p_data[0], static_cast<size_t>(end - p_data), [&](size_t i) {
+        return tsl::test_mask<SimdStyle, Idof>(tsl::load_imask<SimdStyle, Idof>(valid_masks + i / bits_per_mask),
+                                               i % bits_per_mask);
+      });
     }
 
     template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherPositionType, class OtherHintSet,
@@ -0,0 +1,359 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_sort.hpp
+ * @brief Sort-based grouping, for inputs where almost every key is its own group.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SORT_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/dbops/sort/sort.hpp"
+#include "algorithms/dbops/sort/sort_utils.hpp"
+#include "algorithms/utils/sorthints.hpp"
+#include "algorithms/utils/table_init.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Groups keys by sorting them, with the builder/grouper interface of the hash based grouping.
+   *
+   * The keys and their positions are collected by operator() and merge(). finalize() sorts them with
+   * SingleColumnSortIndirectInplace (the positions are the index column) and detects the runs of equal keys by
+   * comparing every register with the register shifted by one key. The group id of a key is the rank of its run, so
+   * after finalize()
+   * - the key sink holds the distinct keys in ascending order, padded with the largest key up to the sink size,
+   * - the group id sink holds the group id of every key slot (invalid_gid for the padding),
+   * - the position sink holds the first occurence of every group, indexed by group id.
+   * Every run is a contiguous range of the sorted keys, so group_ids() and sum() write per-row group ids and
+   * per-group aggregates without probing.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::grouping::sort_based>, typename Idof = tsl::workaround>
+  class Grouper_Build_Sort_SIMD {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using GroupIdType = typename SimdStyle::base_type;
+    using GroupIdSinkType = GroupIdType *;
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+    using IndexStyle = tsl::simd<PositionType, typename SimdStyle::target_extension>;
+
+   private:
+    using sorter_t = typename SingleColumnSort<SimdStyle, TSL_SORT_ORDER::ASC,
+                                               OperatorHintSet<hints::sort::indirect_inplace>, IndexStyle>::sorter_t;
+
+    KeySinkType m_key_sink;
+    GroupIdSinkType m_group_id_sink;
+    PositionSinkType m_original_positions_sink;
+
+    size_t const m_map_element_count;
+    size_t m_group_id_count;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+    GroupIdType const m_invalid_gid;
+
+    // The collected keys and their positions, sorted by finalize().
+    std::vector<KeyType> m_keys;
+    std::vector<PositionType> m_positions;
+    // Group g covers the sorted keys [m_run_starts[g], m_run_starts[g + 1]).
+    std::vector<size_t> m_run_starts;
+
+   public:
+    auto distinct_key_count() const noexcept { return m_group_id_count; }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto invalid_gid() const noexcept { return m_invalid_gid; }
+    auto row_count() const noexcept { return m_keys.size(); }
+
+   public:
+    explicit Grouper_Build_Sort_SIMD(void) = delete;
+    /**
+     * @brief Constructs a sort-based group builder with the sinks of Grouper_Build_Hash_SIMD_Linear_Displacement.
+     *
+     * @param p_map_element_count The size of the sinks, i.e. the maximum number of groups.
+     * @param initialize Flag indicating whether to initialize the sinks. Pass false to call initialize_sinks() with
+     * several threads instead.
+     */
+    explicit Grouper_Build_Sort_SIMD(
+      SimdOpsIterable auto p_key_sink, SimdOpsIterable auto p_group_id_sink,
+      SimdOpsIterable auto p_original_first_occurence_position_sink, size_t p_map_element_count,
+      KeyType p_empty_bucket_value = 0, PositionType p_invalid_position = std::numeric_limits<PositionType>::max(),
+      GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max(), bool initialize = true)
+      : m_key_sink(reinterpret_iterable<KeySinkType>(p_key_sink)),
+        m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
+        m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_original_first_occurence_position_sink)),
+        m_map_element_count(p_map_element_count),
+        m_group_id_count(0),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position),
+        m_invalid_gid(p_invalid_gid) {
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+    ~Grouper_Build_Sort_SIMD() = default;
+
+    /**
+     * @brief Fills the sinks with the empty bucket value, the invalid group id and the invalid position, a register at
+     * a time. With p_thread_count > 1, the sinks are split into page aligned chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      fill_sink<SimdStyle, Idof>(m_key_sink, m_map_element_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_group_id_sink, m_map_element_count, m_invalid_gid, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_map_element_count, m_invalid_position, p_thread_count);
+    }
+
+   private:
+    /**
+     * @brief Collects the start of every run of equal keys. A key starts a run if it differs from its predecessor,
+     * which is compared a register at a time.
+     */
+    auto detect_runs() -> void {
+      using imask_t = typename SimdStyle::imask_type;
+      m_run_starts.clear();
+      size_t const count = m_keys.size();
+      if (count == 0) {
+        m_run_starts.push_back(0);
+        return;
+      }
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      auto const keys = m_keys.data();
+      m_run_starts.push_back(0);
+      size_t i = 1;
+      for (; i + SimdStyle::vector_element_count() <= count; i += SimdStyle::vector_element_count()) {
+        auto run_start_mask = tsl::mask_binary_not<SimdStyle, Idof>(tsl::equal_as_imask<SimdStyle, Idof>(
+          tsl::loadu<SimdStyle, Idof>(keys + i), tsl::loadu<SimdStyle, Idof>(keys + i - 1)));
+        while (tsl::nequal<SimdStyle, Idof>(run_start_mask, all_false_mask)) {
+          m_run_starts.push_back(i + tsl::tzc<SimdStyle, Idof>(run_start_mask));
+          run_start_mask = static_cast<imask_t>(run_start_mask & (run_start_mask - 1));
+        }
+      }
+      for (; i < count; ++i) {
+        if (keys[i] != keys[i - 1]) {
+          m_run_starts.push_back(i);
+        }
+      }
+      m_run_starts.push_back(count);
+    }
+
+   public:
+    /**
+     * @brief Collects keys, the key at p_data[i] has the position start_position + i.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0)
+      -> void {
+      auto const end = iter_end(p_data, p_end);
+      for (; p_data != end; ++p_data, ++start_position) {
+        m_keys.push_back(*p_data);
+        m_positions.push_back(start_position);
+      }
+    }
+
+    /**
+     * @brief Collects the keys of another builder that was not finalized yet, e.g. one that was filled by another
+     * thread.
+     */
+    template <tsl::VectorProcessingStyle OtherSimdStyle, tsl::TSLArithmetic OtherPositionType, class OtherHintSet,
+              typename OtherIdof>
+    auto merge(Grouper_Build_Sort_SIMD<OtherSimdStyle, OtherPositionType, OtherHintSet, OtherIdof> const &other)
+      -> void {
+      m_keys.insert(m_keys.end(), other.keys().begin(), other.keys().end());
+      m_positions.insert(m_positions.end(), other.positions().begin(), other.positions().end());
+    }
+
+    /**
+     * @brief Sorts the collected keys, assigns the group ids and writes the sinks.
+     *
+     * @throws std::length_error If there are more groups than the sinks can hold.
+     */
+    auto finalize() -> void {
+      if (m_keys.size() > 1) {
+        // The pivot selection of the sorter reads keys at the values of its index column. Thus, the index column holds
+        // 0..n-1 instead of the positions, which may start anywhere, and the positions are permuted afterwards.
+        std::vector<PositionType> order(m_keys.size());
+        std::iota(order.begin(), order.end(), PositionType{0});
+        sorter_t sorter(m_keys.data(), order.data());
+        sorter(0, m_keys.size());
+        std::vector<PositionType> sorted_positions(m_keys.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+          sorted_positions[i] = m_positions[order[i]];
+        }
+        m_positions = std::move(sorted_positions);
+      }
+      detect_runs();
+      m_group_id_count = m_run_starts.size() - 1;
+      if (m_group_id_count > m_map_element_count) {
+        throw std::length_error("Grouper_Build_Sort_SIMD: more groups than the sinks can hold.");
+      }
+      for (size_t gid = 0; gid < m_group_id_count; ++gid) {
+        auto const run_begin = m_positions.begin() + m_run_starts[gid];
+        auto const run_end = m_positions.begin() + m_run_starts[gid + 1];
+        m_key_sink[gid] = m_keys[m_run_starts[gid]];
+        m_group_id_sink[gid] = static_cast<GroupIdType>(gid);
+        // The sort is not stable, so the first occurence is the smallest position of the run.
+        m_original_positions_sink[gid] = *std::min_element(run_begin, run_end);
+      }
+      // The padding keeps the key sink sorted, the grouper finds the first slot of a key.
+      auto const padding_key = (m_group_id_count == 0) ? m_empty_bucket_value : m_keys.back();
+      for (size_t i = m_group_id_count; i < m_map_element_count; ++i) {
+        m_key_sink[i] = padding_key;
+        m_group_id_sink[i] = m_invalid_gid;
+        m_original_positions_sink[i] = m_invalid_position;
+      }
+    }
+
+    /**
+     * @brief Writes the group id of every collected key to p_output_gids[position], without probing.
+     */
+    auto group_ids(SimdOpsIterable auto p_output_gids) const noexcept -> void {
+      auto output = reinterpret_iterable<GroupIdSinkType>(p_output_gids);
+      for (size_t gid = 0; gid < m_group_id_count; ++gid) {
+        for (size_t i = m_run_starts[gid]; i < m_run_starts[gid + 1]; ++i) {
+          output[m_positions[i]] = static_cast<GroupIdType>(gid);
+        }
+      }
+    }
+
+    /**
+     * @brief Sums the values of every group into p_sums[gid], the value of the key with position p is p_values[p].
+     */
+    template <tsl::TSLArithmetic AccumulatorType = KeyType>
+    auto sum(SimdOpsIterable auto p_values, SimdOpsIterable auto p_sums) const noexcept -> void {
+      auto sums = reinterpret_iterable<AccumulatorType *>(p_sums);
+      for (size_t gid = 0; gid < m_group_id_count; ++gid) {
+        AccumulatorType group_sum = 0;
+        for (size_t i = m_run_starts[gid]; i < m_run_starts[gid + 1]; ++i) {
+          group_sum += static_cast<AccumulatorType>(p_values[m_positions[i]]);
+        }
+        sums[gid] = group_sum;
+      }
+    }
+
+    auto keys() const noexcept -> std::vector<KeyType> const & { return m_keys; }
+    auto positions() const noexcept -> std::vector<PositionType> const & { return m_positions; }
+  };
+
+  /**
+   * @brief Looks up the group ids of keys in the sinks written by Grouper_Build_Sort_SIMD.
+   *
+   * Every key is searched with a branchless binary search. A batch of keys advances in lockstep, so the loads of
+   * independent searches overlap instead of waiting for each other. Keys without a group get invalid_gid.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::grouping::sort_based>, typename Idof = tsl::workaround>
+  class Grouper_Sort_SIMD {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+    using GroupIdType = typename SimdStyle::base_type;
+    using GroupIdSinkType = GroupIdType *;
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+
+   private:
+    constexpr static size_t lookup_batch_size = 4 * SimdStyle::vector_element_count();
+
+    KeySinkType m_key_sink;
+    GroupIdSinkType m_group_id_sink;
+    size_t const m_map_element_count;
+    GroupIdType const m_invalid_gid;
+
+   public:
+    explicit Grouper_Sort_SIMD(KeySinkType p_key_sink, GroupIdSinkType p_group_id_sink,
+                               PositionSinkType p_original_positions_sink, size_t p_map_element_count,
+                               GroupIdType p_invalid_gid = std::numeric_limits<GroupIdType>::max())
+      : m_key_sink(reinterpret_iterable<KeySinkType>(p_key_sink)),
+        m_group_id_sink(reinterpret_iterable<GroupIdSinkType>(p_group_id_sink)),
+        m_map_element_count(p_map_element_count),
+        m_invalid_gid(p_invalid_gid) {}
+    ~Grouper_Sort_SIMD() = default;
+
+   private:
+    auto lookup_batch(GroupIdSinkType p_output_gids, KeyType const *p_keys, size_t const count) const noexcept
+      -> void {
+      size_t lower_bound[lookup_batch_size] = {};
+      for (size_t length = m_map_element_count; length > 1;) {
+        size_t const half = length / 2;
+        for (size_t i = 0; i < count; ++i) {
+          lower_bound[i] = (m_key_sink[lower_bound[i] + half] < p_keys[i]) ? lower_bound[i] + half : lower_bound[i];
+        }
+        length -= half;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        auto const slot = lower_bound[i] + static_cast<size_t>(m_key_sink[lower_bound[i]] < p_keys[i]);
+        p_output_gids[i] =
+          (slot < m_map_element_count && m_key_sink[slot] == p_keys[i]) ? m_group_id_sink[slot] : m_invalid_gid;
+      }
+    }
+
+   public:
+    /**
+     * @brief Writes the group id of every key.
+     */
+    auto operator()(SimdOpsIterable auto p_output_gids, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end) const noexcept -> void {
+      auto const end = iter_end(p_data, p_end);
+      auto output = reinterpret_iterable<GroupIdSinkType>(p_output_gids);
+      if (m_map_element_count == 0) {
+        for (; p_data != end; ++p_data, ++output) {
+          *output = m_invalid_gid;
+        }
+        return;
+      }
+      while (p_data != end) {
+        auto const count = std::min(lookup_batch_size, static_cast<size_t>(end - p_data));
+        lookup_batch(output, &p_data[0], count);
+        p_data += count;
+        output += count;
+      }
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStyle, tsl::TSLArithmetic OtherPositionType, class OtherHintSet,
+              typename OtherIdof>
+    auto merge(Grouper_Sort_SIMD<OtherSimdStyle, OtherPositionType, OtherHintSet, OtherIdof> const &other)
+      const noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType,
+            class HintSet = OperatorHintSet<hints::grouping::sort_based>, typename Idof = tsl::workaround>
+  struct Grouper_SIMD_Sort {
+    using builder_t = Grouper_Build_Sort_SIMD<_SimdStyle, _PositionType, HintSet, Idof>;
+    using grouper_t = Grouper_Sort_SIMD<_SimdStyle, _PositionType, HintSet, Idof>;
+  };
+}  // namespace tuddbs
+#endif
@@ -0,0 +1,352 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file groupby_spilling.hpp
+ * @brief Hybrid hash grouping that spills partitions exceeding a memory budget to the local disk.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SPILLING_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SPILLING_HPP
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms/dbops/groupby/groupby_growable.hpp"
+#include "algorithms/dbops/groupby/groupby_hints.hpp"
+#include "algorithms/dbops/groupby/groupby_partitioned.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "algorithms/utils/spill_file.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Groups more distinct keys than fit into memory.
+   *
+   * The keys are partitioned by radix_bits bits of their hashes, every partition is grouped in its own growable table.
+   * Whenever the tables exceed the memory budget, the largest resident table that holds groups is spilled: its groups
+   * are written as (key, first position) pairs to a SpillRun in the spill directory and all further keys of that
+   * partition are appended to the run, every distinct key of a batch once with its smallest position. finalize() emits
+   * the groups of the resident partitions, frees them and then groups every spilled run recursively by the next
+   * radix_bits bits of the hashes, with the same budget.
+   *
+   * The budget is checked after every batch of keys, so a table may exceed it by one resize. The block buffer of every
+   * spilled run (run_t::block_bytes) is not part of the budget, otherwise a budget below a few blocks would spill all
+   * partitions. Once the hash bits are used up, partitions are no longer spilled. The first positions are global, if
+   * the keys are inserted in input order or the global_first_occurence_required hint is set. With
+   * hints::grouping::spill_direct_io, the runs are written with O_DIRECT where the file system supports it.
+   *
+   * @tparam _SimdStyle The SIMD processing style of the keys.
+   * @tparam _PositionType The type of the first positions.
+   * @tparam HintSet The hints of the partition tables.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using GroupIdType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using table_t = Growable_Grouper_Build_Hash_SIMD_Linear_Displacement<SimdStyle, PositionType, HintSet, Idof>;
+    using run_t = SpillRun<KeyType, PositionType>;
+    static_assert(std::is_integral_v<KeyType>, "Keys are partitioned by the bits of their hash.");
+
+   private:
+    // Hashes of signed keys have a cleared sign bit.
+    constexpr static unsigned hash_bits = sizeof(KeyType) * CHAR_BIT - (std::is_signed_v<KeyType> ? 1 : 0);
+    // Number of keys whose partitions are computed at once.
+    constexpr static size_t partition_batch_size = 1024;
+    constexpr static size_t bucket_bytes = sizeof(KeyType) + sizeof(GroupIdType) + sizeof(PositionType);
+    constexpr static bool direct_io = has_hint<HintSet, hints::grouping::spill_direct_io>;
+
+    struct partition_t {
+      std::unique_ptr<table_t> table;
+      std::unique_ptr<run_t> run;
+    };
+
+    std::filesystem::path const m_spill_directory;
+    size_t const m_memory_budget;
+    unsigned const m_radix_bits;
+    unsigned const m_level;
+    size_t const m_initial_bucket_count;
+    double const m_max_load_factor;
+    std::vector<partition_t> m_partitions;
+    size_t m_spilled_partition_count = 0;
+    size_t m_spilled_bytes = 0;
+
+    static auto checked_radix_bits(unsigned p_radix_bits) -> unsigned {
+      if (p_radix_bits == 0 || p_radix_bits >= hash_bits) {
+        throw std::invalid_argument("The number of radix bits has to be in [1, bits of the hash).");
+      }
+      return p_radix_bits;
+    }
+
+    Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement(std::filesystem::path p_spill_directory,
+                                                         size_t p_memory_budget, unsigned p_radix_bits,
+                                                         unsigned p_level, size_t p_initial_bucket_count,
+                                                         double p_max_load_factor)
+      : m_spill_directory(std::move(p_spill_directory)),
+        m_memory_budget(p_memory_budget),
+        m_radix_bits(checked_radix_bits(p_radix_bits)),
+        m_level(p_level),
+        m_initial_bucket_count(p_initial_bucket_count),
+        m_max_load_factor(p_max_load_factor),
+        m_partitions(size_t{1} << p_radix_bits) {
+      for (auto &partition : m_partitions) {
+        partition.table = std::make_unique<table_t>(m_initial_bucket_count, m_max_load_factor);
+      }
+    }
+
+    /**
+     * @brief Whether the partitions of this level can be partitioned once more by the hash bits below them.
+     */
+    auto may_spill() const noexcept -> bool { return (m_level + 2) * m_radix_bits <= hash_bits; }
+
+    /**
+     * @brief The bytes of the resident tables, including the buckets of empty ones.
+     */
+    auto table_bytes() const noexcept -> size_t {
+      size_t bytes = 0;
+      for (auto const &partition : m_partitions) {
+        if (partition.table) {
+          bytes += partition.table->sink_size() * bucket_bytes;
+        }
+      }
+      return bytes;
+    }
+
+    /**
+     * @brief Calls p_fun(key, first position) for every group of a table.
+     */
+    template <class Fun>
+    static auto for_each_group(table_t const &p_table, Fun &&p_fun) -> void {
+      auto const keys = p_table.key_sink();
+      auto const gids = p_table.group_id_sink();
+      auto const positions = p_table.original_positions_sink();
+      auto const invalid_gid = std::numeric_limits<GroupIdType>::max();
+      for (size_t bucket = 0; bucket < p_table.sink_size(); ++bucket) {
+        if (gids[bucket] != invalid_gid) {
+          p_fun(keys[bucket], positions[gids[bucket]]);
+        }
+      }
+    }
+
+    /**
+     * @brief Writes the groups of the largest resident table to its run and frees the table. Empty tables are not
+     * spilled, as freeing them would only trade their buckets for a block buffer.
+     */
+    auto spill_largest() -> bool {
+      partition_t *largest = nullptr;
+      for (auto &partition : m_partitions) {
+        if (partition.table && partition.table->distinct_key_count() > 0 &&
+            (largest == nullptr || partition.table->bucket_count() > largest->table->bucket_count())) {
+          largest = &partition;
+        }
+      }
+      if (largest == nullptr) {
+        return false;
+      }
+      largest->run = std::make_unique<run_t>(m_spill_directory, direct_io);
+      for_each_group(*largest->table, [run = largest->run.get()](KeyType key, PositionType position) {
+        run->append(key, position);
+      });
+      largest->table.reset();
+      ++m_spilled_partition_count;
+      return true;
+    }
+
+    /**
+     * @brief Appends the keys of a batch to the run of a spilled partition, every distinct key once with its smallest
+     * position.
+     */
+    static auto append_aggregated(run_t &p_run, KeyType *p_keys, PositionType *p_positions, size_t p_count) -> void {
+      static_assert(partition_batch_size <= std::numeric_limits<uint16_t>::max() + size_t{1});
+      std::array<uint16_t, partition_batch_size> order;
+      std::iota(order.begin(), order.begin() + p_count, uint16_t{0});
+      std::sort(order.begin(), order.begin() + p_count, [p_keys, p_positions](uint16_t lhs, uint16_t rhs) {
+        return p_keys[lhs] < p_keys[rhs] || (p_keys[lhs] == p_keys[rhs] && p_positions[lhs] < p_positions[rhs]);
+      });
+      for (size_t i = 0; i < p_count; ++i) {
+        if (i == 0 || p_keys[order[i]] != p_keys[order[i - 1]]) {
+          p_run.append(p_keys[order[i]], p_positions[order[i]]);
+        }
+      }
+    }
+
+    auto insert_batch(KeyType const *p_keys, PositionType const *p_positions, size_t p_count) -> void {
+      alignas(64) std::array<KeyType, partition_batch_size> partitions;
+      std::array<KeyType, partition_batch_size> keys;
+      std::array<PositionType, partition_batch_size> positions;
+      auto const partition_count = m_partitions.size();
+      details::hash_partitions<SimdStyle, HintSet, Idof>(
+        p_keys, p_count, hash_bits - (m_level + 1) * m_radix_bits, m_radix_bits, partitions.data());
+      // Counting sort of the keys by their partition, so that every table gets one contiguous chunk.
+      std::vector<size_t> partition_end(partition_count + 1, 0);
+      for (size_t i = 0; i < p_count; ++i) {
+        ++partition_end[partitions[i] + 1];
+      }
+      for (size_t p = 0; p < partition_count; ++p) {
+        partition_end[p + 1] += partition_end[p];
+      }
+      for (size_t i = 0; i < p_count; ++i) {
+        auto const slot = partition_end[partitions[i]]++;
+        keys[slot] = p_keys[i];
+        positions[slot] = p_positions[i];
+      }
+      size_t first = 0;
+      for (size_t p = 0; p < partition_count; ++p) {
+        auto const last = partition_end[p];
+        auto &partition = m_partitions[p];
+        if (last == first) {
+          continue;
+        }
+        if (partition.table) {
+          partition.table->insert_at_positions(keys.data() + first, last - first, positions.data() + first);
+        } else {
+          append_aggregated(*partition.run, keys.data() + first, positions.data() + first, last - first);
+        }
+        first = last;
+      }
+      if (may_spill()) {
+        while (table_bytes() > m_memory_budget && spill_largest()) {
+        }
+      }
+    }
+
+   public:
+    /**
+     * @brief Constructs empty partition tables.
+     *
+     * @param p_spill_directory A directory on the local disk that holds the spilled runs while the builder exists.
+     * @param p_memory_budget_bytes The bytes the partition tables of one level may occupy.
+     * @param p_radix_bits The number of hash bits that select the partition on every level.
+     * @param p_initial_bucket_count The initial number of buckets of every partition table.
+     * @param p_max_load_factor The load factor at which a partition table grows.
+     */
+    explicit Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement(std::filesystem::path p_spill_directory,
+                                                                  size_t p_memory_budget_bytes,
+                                                                  unsigned p_radix_bits = 4,
+                                                                  size_t p_initial_bucket_count = 1024,
+                                                                  double p_max_load_factor = 0.7)
+      : Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement(std::move(p_spill_directory), p_memory_budget_bytes,
+                                                             p_radix_bits, 0, p_initial_bucket_count,
+                                                             p_max_load_factor) {}
+
+    auto radix_bits() const noexcept { return m_radix_bits; }
+    auto partition_count() const noexcept -> size_t { return m_partitions.size(); }
+    /**
+     * @brief The number of partitions of the first level that were spilled.
+     */
+    auto spilled_partition_count() const noexcept { return m_spilled_partition_count; }
+    /**
+     * @brief The bytes written to spill files by finalize(), including all recursion levels.
+     */
+    auto spilled_bytes() const noexcept { return m_spilled_bytes; }
+
+    /**
+     * @brief Inserts the keys.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param start_position The position of the first key.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end, PositionType start_position = 0)
+      -> void {
+      auto const end = iter_end(p_data, p_end);
+      std::array<PositionType, partition_batch_size> positions;
+      while (p_data != end) {
+        auto const count = std::min<size_t>(partition_batch_size, static_cast<size_t>(end - p_data));
+        for (size_t i = 0; i < count; ++i) {
+          positions[i] = start_position + static_cast<PositionType>(i);
+        }
+        insert_batch(&p_data[0], positions.data(), count);
+        p_data += count;
+        start_position += static_cast<PositionType>(count);
+      }
+    }
+
+    /**
+     * @brief Inserts keys whose positions are given explicitly.
+     *
+     * @param p_data The keys to insert.
+     * @param p_end The end of the keys or their number.
+     * @param p_positions The position of every key.
+     */
+    auto insert_at_positions(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                             SimdOpsIterable auto p_positions) -> void {
+      auto const end = iter_end(p_data, p_end);
+      while (p_data != end) {
+        auto const count = std::min<size_t>(partition_batch_size, static_cast<size_t>(end - p_data));
+        insert_batch(&p_data[0], &p_positions[0], count);
+        p_data += count;
+        p_positions += count;
+      }
+    }
+
+    /**
+     * @brief Calls p_consumer(key, first position) once for every group and returns the number of groups.
+     *
+     * The resident partitions are emitted first, then every spilled run is read back and grouped recursively. The
+     * builder is consumed, finalize() may only be called once.
+     */
+    template <class Consumer>
+    auto finalize(Consumer &&p_consumer) -> size_t {
+      size_t group_count = 0;
+      for (auto &partition : m_partitions) {
+        if (partition.table) {
+          group_count += partition.table->distinct_key_count();
+          for_each_group(*partition.table, p_consumer);
+          partition.table.reset();
+        }
+      }
+      for (auto &partition : m_partitions) {
+        if (!partition.run) {
+          continue;
+        }
+        Spilling_Grouper_Build_Hash_SIMD_Linear_Displacement child(m_spill_directory, m_memory_budget, m_radix_bits,
+                                                                   m_level + 1, m_initial_bucket_count,
+                                                                   m_max_load_factor);
+        partition.run->for_each_block([&child](KeyType const *p_keys, PositionType const *p_positions, size_t p_count) {
+          child.insert_at_positions(p_keys, p_count, p_positions);
+        });
+        m_spilled_bytes += partition.run->file_bytes();
+        partition.run.reset();
+        group_count += child.finalize(p_consumer);
+        m_spilled_bytes += child.spilled_bytes();
+      }
+      return group_count;
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_GROUPBY_GROUPBY_SPILLING_HPP
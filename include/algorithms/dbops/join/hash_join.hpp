@@ -24,7 +24,9 @@
 #define SIMDOPS_INCLUE_ALGORITHMS_DBOPS_JOIN_HASH_JOIN_HPP
 
 #include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/join/hash_join_concurrent.hpp"
 #include "algorithms/dbops/join/hash_join_hints.hpp"
+#include "algorithms/dbops/join/hash_join_simd_interleaved.hpp"
 #include "algorithms/dbops/join/hash_join_simd_linear_probing.hpp"
 #include "algorithms/utils/hashing.hpp"
 #include "tsl.hpp"
@@ -35,12 +37,16 @@ namespace tuddbs {
             class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>,
             typename Idof = tsl::workaround>
   struct Hash_Join {
-    using base_class =
+    using base_class = std::conditional_t<
+      has_hint<HintSet, hints::hashing::interleaved_buckets>,
+      Hash_Join_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>,
       std::conditional_t<has_hints<HintSet, hints::hashing::linear_displacement> &&
                            !has_hint<HintSet, hints::hashing::refill>,
-                         Hash_Join_SIMD_Linear_Probing<_SimdStyle, _PositionType, HintSet, Idof>, void>;
+                         Hash_Join_SIMD_Linear_Probing<_SimdStyle, _PositionType, HintSet, Idof>, void>>;
     using builder_t = typename base_class::builder_t;
     using prober_t = typename base_class::prober_t;
+    using concurrent_builder_t =
+      Concurrent_Hash_Join_Build_SIMD_Linear_Probing<_SimdStyle, _PositionType, HintSet, Idof>;
   };
 
 }  // namespace tuddbs
@@ -0,0 +1,265 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file hash_join_concurrent.hpp
+ * @brief A join hash table that many threads build in place without locks.
+ */
+#ifndef SIMDOPS_INCLUE_ALGORITHMS_DBOPS_JOIN_HASH_JOIN_CONCURRENT_HPP
+#define SIMDOPS_INCLUE_ALGORITHMS_DBOPS_JOIN_HASH_JOIN_CONCURRENT_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/join/hash_join_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief The concurrent counterpart of Hash_Join_Build_SIMD_Linear_Probing.
+   *
+   * All threads insert into the same sinks, which have the layout of the serial table, so
+   * Hash_Join_Probe_SIMD_Linear_Probing probes it afterwards. Buckets are found with the probing sequence of the
+   * serial table and claimed with a CAS on the key slot (or on the used-bucket slot with
+   * keys_may_contain_empty_indicator, where every key gets its own bucket). The claiming thread stores the position
+   * and then marks the bucket as full with release semantics. If a key is already in the table, its position is
+   * overwritten, or lowered with a CAS loop if global_first_occurence_required is set.
+   *
+   * Like for the serial table, keys equal to the empty bucket value require keys_may_contain_empty_indicator. Without
+   * it, such a key would match every empty bucket, which no thread ever marks as full. It is rejected instead: insert
+   * asserts, and operator() stops at it as if the table was full.
+   *
+   * Probing loads registers of key (resp. used-bucket) slots with plain SIMD loads, while other threads may write
+   * single slots of them via std::atomic_ref. Formally, this is a data race. It is benign on the supported x86
+   * targets, where aligned stores of a slot are atomic and a stale register only filters candidates: every claim and
+   * every match is confirmed by an atomic operation on the slot itself.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2>, typename Idof = tsl::workaround>
+  class Concurrent_Hash_Join_Build_SIMD_Linear_Probing {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using KeySinkType = KeyType *;
+
+    using PositionType = _PositionType;
+    using PositionSinkType = PositionType *;
+
+    using BucketUsedType = typename SimdStyle::base_type;
+    using BucketUsedSinkType = BucketUsedType *;
+
+   private:
+    KeySinkType m_key_sink;
+    PositionSinkType m_original_positions_sink;
+    BucketUsedSinkType m_used_bucket_sink;
+
+    size_t const m_bucket_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
+    std::atomic<size_t> m_used_bucket_count;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+    BucketUsedType const m_bucket_empty = 0x0;
+    BucketUsedType const m_bucket_full = 0x1;
+    // A bucket whose key slot was claimed, but whose position is not yet stored.
+    BucketUsedType const m_bucket_claimed = 0x2;
+
+   public:
+    auto distinct_key_count() const noexcept { return m_used_bucket_count.load(std::memory_order_acquire); }
+    auto get_used_bucket_count() const noexcept -> size_t { return distinct_key_count(); }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto empty_bucket_indicator() const noexcept { return m_bucket_empty; }
+    auto full_bucket_indicator() const noexcept { return m_bucket_full; }
+
+   public:
+    explicit Concurrent_Hash_Join_Build_SIMD_Linear_Probing(void) = delete;
+
+    explicit Concurrent_Hash_Join_Build_SIMD_Linear_Probing(
+      SimdOpsIterable auto p_key_sink, SimdOpsIterable auto p_used_bucket_sink, SimdOpsIterable auto p_position_sink,
+      size_t p_map_element_count, KeyType p_empty_bucket_value = 0,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max(), bool initialize = true)
+      : m_key_sink(reinterpret_iterable<KeySinkType>(p_key_sink)),
+        m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_position_sink)),
+        m_used_bucket_sink(reinterpret_iterable<BucketUsedSinkType>(p_used_bucket_sink)),
+        m_bucket_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
+        m_used_bucket_count(0),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_bucket_count & (m_bucket_count - 1)) == 0);
+      }
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+    ~Concurrent_Hash_Join_Build_SIMD_Linear_Probing() = default;
+
+    /**
+     * @brief Marks all buckets as empty, a register at a time. Has to finish before the first insert. With
+     * p_thread_count > 1, the sinks are split into page aligned chunks that are filled concurrently.
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      fill_sink<SimdStyle, Idof>(m_key_sink, m_bucket_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_used_bucket_sink, m_bucket_count, m_bucket_empty, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_bucket_count, m_invalid_position, p_thread_count);
+    }
+
+   private:
+    /**
+     * @brief Moves a bucket group back, so that it ends at the last bucket, like the serial table does.
+     */
+    TSL_FORCE_INLINE auto clamp_bucket_group(size_t lookup_position) const noexcept -> size_t {
+      int64_t const lookup_position_helper = lookup_position + SimdStyle::vector_element_count() - m_bucket_count;
+      return (lookup_position_helper < 1) ? lookup_position : lookup_position - lookup_position_helper;
+    }
+
+    TSL_FORCE_INLINE auto next_bucket_group(size_t lookup_position) const noexcept -> size_t {
+      return normalizer<SimdStyle, HintSet, Idof>::normalize_value(lookup_position + SimdStyle::vector_element_count(),
+                                                                   m_bucket_modulus);
+    }
+
+    TSL_FORCE_INLINE auto update_position(size_t const bucket, PositionType const key_position_in_data) noexcept
+      -> void {
+      // Wait until the thread that claimed the bucket has stored its position.
+      std::atomic_ref<BucketUsedType> used(m_used_bucket_sink[bucket]);
+      while (used.load(std::memory_order_acquire) != m_bucket_full) {
+      }
+      std::atomic_ref<PositionType> position(m_original_positions_sink[bucket]);
+      if constexpr (has_hint<HintSet, hints::hash_join::global_first_occurence_required>) {
+        auto current = position.load(std::memory_order_relaxed);
+        while (key_position_in_data < current &&
+               !position.compare_exchange_weak(current, key_position_in_data, std::memory_order_relaxed)) {
+        }
+      } else {
+        position.store(key_position_in_data, std::memory_order_relaxed);
+      }
+    }
+
+    TSL_FORCE_INLINE auto publish(size_t const bucket, PositionType const key_position_in_data) noexcept -> void {
+      std::atomic_ref<PositionType>(m_original_positions_sink[bucket])
+        .store(key_position_in_data, std::memory_order_relaxed);
+      std::atomic_ref<BucketUsedType>(m_used_bucket_sink[bucket]).store(m_bucket_full, std::memory_order_release);
+      m_used_bucket_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Inserts a key, returns false if no bucket is left or the key is the empty bucket value (see above).
+     */
+    TSL_FORCE_INLINE auto insert(KeyType const key, PositionType const key_position_in_data,
+                                 typename SimdStyle::imask_type const all_false_mask) noexcept -> bool {
+      using imask_t = typename SimdStyle::imask_type;
+      auto lookup_position =
+        normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
+      // Every bucket group is visited at most once, then the table is full.
+      size_t const max_probes = m_bucket_count / SimdStyle::vector_element_count() + 2;
+      if constexpr (has_hint<HintSet, hints::hash_join::keys_may_contain_empty_indicator>) {
+        auto const empty_reg = tsl::set1<SimdStyle, Idof>(m_bucket_empty);
+        for (size_t probe = 0; probe < max_probes; ++probe) {
+          lookup_position = clamp_bucket_group(lookup_position);
+          auto empty_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(
+            tsl::loadu<SimdStyle, Idof>(m_used_bucket_sink + lookup_position), empty_reg);
+          while (tsl::nequal<SimdStyle, Idof>(empty_found_mask, all_false_mask)) {
+            auto const lane = tsl::tzc<SimdStyle, Idof>(empty_found_mask);
+            auto const bucket = lookup_position + lane;
+            auto expected = m_bucket_empty;
+            if (std::atomic_ref<BucketUsedType>(m_used_bucket_sink[bucket])
+                  .compare_exchange_strong(expected, m_bucket_claimed, std::memory_order_acq_rel)) {
+              std::atomic_ref<KeyType>(m_key_sink[bucket]).store(key, std::memory_order_relaxed);
+              publish(bucket, key_position_in_data);
+              return true;
+            }
+            empty_found_mask = static_cast<imask_t>(empty_found_mask & ~(static_cast<imask_t>(1) << lane));
+          }
+          lookup_position = next_bucket_group(lookup_position);
+        }
+      } else {
+        assert(key != m_empty_bucket_value);
+        if (key == m_empty_bucket_value) {
+          return false;
+        }
+        auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+        auto const key_reg_empty = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+        for (size_t probe = 0; probe < max_probes; ++probe) {
+          lookup_position = clamp_bucket_group(lookup_position);
+          // The register only filters candidate buckets, claimed key slots never change.
+          auto const map_reg = tsl::loadu<SimdStyle, Idof>(m_key_sink + lookup_position);
+          auto const key_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(map_reg, keys_reg);
+          if (tsl::nequal<SimdStyle, Idof>(key_found_mask, all_false_mask)) {
+            update_position(lookup_position + tsl::tzc<SimdStyle, Idof>(key_found_mask), key_position_in_data);
+            return true;
+          }
+          auto empty_found_mask = tsl::equal_as_imask<SimdStyle, Idof>(map_reg, key_reg_empty);
+          while (tsl::nequal<SimdStyle, Idof>(empty_found_mask, all_false_mask)) {
+            auto const lane = tsl::tzc<SimdStyle, Idof>(empty_found_mask);
+            auto const bucket = lookup_position + lane;
+            auto expected = m_empty_bucket_value;
+            if (std::atomic_ref<KeyType>(m_key_sink[bucket])
+                  .compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+              publish(bucket, key_position_in_data);
+              return true;
+            }
+            if (expected == key) {
+              // Another thread inserted the key into this bucket in the meantime.
+              update_position(bucket, key_position_in_data);
+              return true;
+            }
+            empty_found_mask = static_cast<imask_t>(empty_found_mask & ~(static_cast<imask_t>(1) << lane));
+          }
+          lookup_position = next_bucket_group(lookup_position);
+        }
+      }
+      return false;
+    }
+
+   public:
+    /**
+     * @brief Inserts keys into the shared table, may be called by many threads concurrently.
+     *
+     * @return The number of inserted keys. Less than the number of keys if the table ran out of buckets or a key equals
+     * the empty bucket value without keys_may_contain_empty_indicator.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    PositionType start_position = 0) noexcept -> size_t {
+      auto const end = iter_end(p_data, p_end);
+      auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
+      size_t insertion_count = 0;
+      for (; p_data != end; ++p_data, ++start_position) {
+        if (!insert(*p_data, start_position, all_false_mask)) {
+          break;
+        }
+        ++insertion_count;
+      }
+      return insertion_count;
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+}  // namespace tuddbs
+
+#endif
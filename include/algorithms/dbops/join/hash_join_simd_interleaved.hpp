@@ -0,0 +1,351 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file hash_join_simd_interleaved.hpp
+ * @brief Hash join with a hash table whose bucket groups hold a register of keys followed by their positions.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_JOIN_HASH_JOIN_SIMD_INTERLEAVED_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_DBOPS_JOIN_HASH_JOIN_SIMD_INTERLEAVED_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/join/hash_join_hints.hpp"
+#include "algorithms/utils/hashing.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Bucket group probing shared by the interleaved join builder and prober.
+   *
+   * The position of a bucket doubles as its occupancy tag: an empty bucket holds the invalid position. Thus keys equal
+   * to the empty bucket value (hints::hash_join::keys_may_contain_empty_indicator) need no separate bucket used sink.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, tsl::TSLArithmetic PositionType, class HintSet, typename Idof>
+  struct interleaved_join_table {
+    using KeyType = typename SimdStyle::base_type;
+    using BucketGroupType = InterleavedBucketGroup<SimdStyle, PositionType>;
+    using imask_t = typename SimdStyle::imask_type;
+    constexpr static size_t buckets_per_group = BucketGroupType::bucket_count;
+    constexpr static bool keys_may_be_empty_value =
+      has_hint<HintSet, hints::hash_join::keys_may_contain_empty_indicator> ||
+      has_hint<HintSet, hints::hashing::keys_may_contain_zero>;
+
+    constexpr static auto bucket_group_count(size_t p_map_element_count) noexcept -> size_t {
+      return (p_map_element_count + buckets_per_group - 1) / buckets_per_group;
+    }
+
+    /**
+     * @brief The lane of key and the lanes of the empty buckets of a bucket group.
+     */
+    struct probe_result {
+      imask_t found;
+      imask_t empty;
+    };
+
+    TSL_FORCE_INLINE static auto probe_group(BucketGroupType const &bucket_group, KeyType const key,
+                                             typename SimdStyle::register_type const keys_reg,
+                                             typename SimdStyle::register_type const empty_bucket_reg,
+                                             KeyType const empty_bucket_value,
+                                             PositionType const invalid_position) noexcept -> probe_result {
+      auto const map_reg = bucket_group.template load_keys<Idof>();
+      auto found = static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, keys_reg) &
+                                        BucketGroupType::bucket_lanes());
+      auto empty = static_cast<imask_t>(tsl::equal_as_imask<SimdStyle, Idof>(map_reg, empty_bucket_reg) &
+                                        BucketGroupType::bucket_lanes());
+      if constexpr (keys_may_be_empty_value) {
+        if (key == empty_bucket_value) {
+          found = bucket_group.template occupied_lanes<Idof>(found, invalid_position);
+          empty = static_cast<imask_t>(empty & ~found);
+        } else if (empty != 0) {
+          empty = static_cast<imask_t>(empty & ~bucket_group.template occupied_lanes<Idof>(empty, invalid_position));
+        }
+      }
+      return {found, empty};
+    }
+  };
+
+  /**
+   * @brief Builds a join hash table of InterleavedBucketGroup, which maps every distinct key to a position.
+   *
+   * A key hashes to a bucket group, full groups are probed linearly. A hit reads the position from the same bucket
+   * group, thus a probe touches one cache line instead of lines in three separate sinks.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  class Hash_Join_Build_SIMD_Interleaved {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using BucketGroupType = InterleavedBucketGroup<SimdStyle, PositionType>;
+    using BucketSinkType = BucketGroupType *;
+
+   private:
+    using table = interleaved_join_table<SimdStyle, PositionType, HintSet, Idof>;
+    constexpr static size_t buckets_per_group = table::buckets_per_group;
+
+    BucketSinkType m_bucket_sink;
+    size_t const m_group_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_group_modulus;
+    size_t m_used_bucket_count;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+
+   public:
+    /**
+     * @brief Returns the number of bucket groups for p_map_element_count buckets, i.e. the size of the bucket sink.
+     */
+    constexpr static auto bucket_group_count(size_t p_map_element_count) noexcept -> size_t {
+      return table::bucket_group_count(p_map_element_count);
+    }
+
+    auto distinct_key_count() const noexcept { return m_used_bucket_count; }
+    auto get_used_bucket_count() const noexcept -> size_t { return m_used_bucket_count; }
+    auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
+    auto invalid_position() const noexcept { return m_invalid_position; }
+    auto group_count() const noexcept { return m_group_count; }
+    auto bucket_sink() const noexcept -> BucketGroupType const * { return m_bucket_sink; }
+
+   public:
+    explicit Hash_Join_Build_SIMD_Interleaved(void) = delete;
+
+    /**
+     * @param p_bucket_sink bucket_group_count(p_map_element_count) bucket groups.
+     * @param p_map_element_count The number of buckets, rounded up to whole bucket groups.
+     */
+    explicit Hash_Join_Build_SIMD_Interleaved(
+      BucketSinkType p_bucket_sink, size_t p_map_element_count, KeyType p_empty_bucket_value = 0,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max(), bool initialize = true)
+      : m_bucket_sink(p_bucket_sink),
+        m_group_count(bucket_group_count(p_map_element_count)),
+        m_group_modulus(bucket_group_count(p_map_element_count)),
+        m_used_bucket_count(0),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_group_count & (m_group_count - 1)) == 0);
+      }
+      if (initialize) {
+        initialize_sinks();
+      }
+    }
+    ~Hash_Join_Build_SIMD_Interleaved() = default;
+
+    /**
+     * @brief Marks all buckets as empty.
+     */
+    auto initialize_sinks() noexcept -> void {
+      for (size_t group = 0; group < m_group_count; ++group) {
+        fill_sink<SimdStyle, Idof>(m_bucket_sink[group].keys.data(), buckets_per_group, m_empty_bucket_value);
+        fill_sink<SimdStyle, Idof>(m_bucket_sink[group].payloads.data(), buckets_per_group, m_invalid_position);
+      }
+    }
+
+   private:
+    /**
+     * @brief Inserts or updates key. Returns false if the key is not in the table and the table is full.
+     */
+    TSL_FORCE_INLINE auto insert(KeyType const key, PositionType const key_position_in_data,
+                                 typename SimdStyle::register_type const empty_bucket_reg) noexcept -> bool {
+      auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+      auto group = static_cast<size_t>(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+        hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_group_modulus));
+      for (size_t probed = 0; probed < m_group_count; ++probed) {
+        auto &bucket_group = m_bucket_sink[group];
+        auto const [found, empty] = table::probe_group(bucket_group, key, keys_reg, empty_bucket_reg,
+                                                       m_empty_bucket_value, m_invalid_position);
+        if (found != 0) {
+          auto &position = bucket_group.payloads[tsl::tzc<SimdStyle, Idof>(found)];
+          if constexpr (has_hint<HintSet, hints::hash_join::global_first_occurence_required>) {
+            if (key_position_in_data < position) {
+              position = key_position_in_data;
+            }
+          } else {
+            position = key_position_in_data;
+          }
+          return true;
+        }
+        if (empty != 0) {
+          auto const lane = tsl::tzc<SimdStyle, Idof>(empty);
+          bucket_group.keys[lane] = key;
+          bucket_group.payloads[lane] = key_position_in_data;
+          ++m_used_bucket_count;
+          return true;
+        }
+        group = (group + 1 == m_group_count) ? 0 : group + 1;
+      }
+      return false;
+    }
+
+   public:
+    /**
+     * @brief Inserts keys until a key does not fit and returns the number of inserted keys.
+     */
+    auto operator()(SimdOpsIterable auto p_data, SimdOpsIterableOrSizeT auto p_end,
+                    PositionType start_position = 0) noexcept -> size_t {
+      auto const end = iter_end(p_data, p_end);
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      size_t insertion_count = 0;
+      for (; p_data != end; ++p_data, ++start_position) {
+        if (!insert(*p_data, start_position, empty_bucket_reg)) {
+          break;
+        }
+        ++insertion_count;
+      }
+      return insertion_count;
+    }
+
+    /**
+     * @brief Merges another hash table into this one. Returns false if a key of other did not fit, the keys merged
+     * before remain in this table.
+     */
+    template <tsl::TSLArithmetic OtherPositionType, class OtherHintSet, typename OtherIdof>
+    auto merge(Hash_Join_Build_SIMD_Interleaved<SimdStyle, OtherPositionType, OtherHintSet, OtherIdof> const &other)
+      noexcept -> bool {
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      auto const other_invalid_position = other.invalid_position();
+      for (size_t group = 0; group < other.group_count(); ++group) {
+        auto const &bucket_group = other.bucket_sink()[group];
+        for (size_t lane = 0; lane < buckets_per_group; ++lane) {
+          if (bucket_group.payloads[lane] != other_invalid_position) {
+            if (!insert(bucket_group.keys[lane], static_cast<PositionType>(bucket_group.payloads[lane]),
+                        empty_bucket_reg)) {
+              return false;
+            }
+          }
+        }
+      }
+      return true;
+    }
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  /**
+   * @brief Probes a table built by Hash_Join_Build_SIMD_Interleaved.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType = size_t,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  class Hash_Join_Probe_SIMD_Interleaved {
+   public:
+    using SimdStyle = _SimdStyle;
+    using KeyType = typename SimdStyle::base_type;
+    using PositionType = _PositionType;
+    using BucketGroupType = InterleavedBucketGroup<SimdStyle, PositionType>;
+    using BucketSinkType = BucketGroupType const *;
+
+   private:
+    using table = interleaved_join_table<SimdStyle, PositionType, HintSet, Idof>;
+
+    BucketSinkType m_bucket_sink;
+    size_t const m_group_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_group_modulus;
+
+    KeyType const m_empty_bucket_value;
+    PositionType const m_invalid_position;
+
+   public:
+    explicit Hash_Join_Probe_SIMD_Interleaved(
+      BucketSinkType p_bucket_sink, size_t p_map_element_count, KeyType p_empty_bucket_value = 0,
+      PositionType p_invalid_position = std::numeric_limits<PositionType>::max())
+      : m_bucket_sink(p_bucket_sink),
+        m_group_count(table::bucket_group_count(p_map_element_count)),
+        m_group_modulus(table::bucket_group_count(p_map_element_count)),
+        m_empty_bucket_value(p_empty_bucket_value),
+        m_invalid_position(p_invalid_position) {
+      if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+        assert((m_group_count & (m_group_count - 1)) == 0);
+      }
+    }
+    ~Hash_Join_Probe_SIMD_Interleaved() = default;
+
+   private:
+    /**
+     * @brief Returns the bucket group and lane of key, or nullptr if the key is not in the table. A full table is
+     * probed at most once.
+     */
+    TSL_FORCE_INLINE auto lookup(KeyType const key, typename SimdStyle::register_type const empty_bucket_reg) const
+      noexcept -> PositionType const * {
+      auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
+      auto group = static_cast<size_t>(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
+        hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_group_modulus));
+      for (size_t probed = 0; probed < m_group_count; ++probed) {
+        auto const &bucket_group = m_bucket_sink[group];
+        auto const [found, empty] = table::probe_group(bucket_group, key, keys_reg, empty_bucket_reg,
+                                                       m_empty_bucket_value, m_invalid_position);
+        if (found != 0) {
+          return &bucket_group.payloads[tsl::tzc<SimdStyle, Idof>(found)];
+        }
+        if (empty != 0) {
+          return nullptr;
+        }
+        group = (group + 1 == m_group_count) ? 0 : group + 1;
+      }
+      return nullptr;
+    }
+
+   public:
+    /**
+     * @brief Writes the build position and the probe position of every probe key that is in the table and returns the
+     * number of matches.
+     */
+    auto operator()(SimdOpsIterable auto p_output_ht, SimdOpsIterable auto p_output_data, SimdOpsIterable auto p_data,
+                    SimdOpsIterableOrSizeT auto p_end) const noexcept -> size_t {
+      auto const end = iter_end(p_data, p_end);
+      auto const empty_bucket_reg = tsl::set1<SimdStyle, Idof>(m_empty_bucket_value);
+      size_t result_size = 0;
+      for (size_t current_pos = 0; p_data != end; ++p_data, ++current_pos) {
+        if (auto const position = lookup(*p_data, empty_bucket_reg); position != nullptr) {
+          *p_output_ht = static_cast<size_t>(*position);
+          *p_output_data = current_pos;
+          ++p_output_ht;
+          ++p_output_data;
+          ++result_size;
+        }
+      }
+      return result_size;
+    }
+
+    template <tsl::VectorProcessingStyle OtherSimdStlye, tsl::TSLArithmetic OtherPositionType, class OtherHintSet,
+              typename OtherIdof>
+    auto merge(Hash_Join_Probe_SIMD_Interleaved<OtherSimdStlye, OtherPositionType, OtherHintSet, OtherIdof> const
+                 &other) const noexcept -> void {}
+
+    auto finalize() const noexcept -> void {}
+  };
+
+  template <tsl::VectorProcessingStyle _SimdStyle, tsl::TSLArithmetic _PositionType,
+            class HintSet = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::interleaved_buckets>,
+            typename Idof = tsl::workaround>
+  struct Hash_Join_SIMD_Interleaved {
+    using builder_t = Hash_Join_Build_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>;
+    using prober_t = Hash_Join_Probe_SIMD_Interleaved<_SimdStyle, _PositionType, HintSet, Idof>;
+  };
+}  // namespace tuddbs
+#endif
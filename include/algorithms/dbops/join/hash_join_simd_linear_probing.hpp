@@ -72,6 +72,7 @@ namespace tuddbs {
     BucketUsedSinkType m_used_bucket_sink;       // indicator for empty buckets
 
     size_t const m_bucket_count;  // fixed count of map size // table size
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
     size_t m_used_bucket_count;   // count of how many buckets are used
 
     KeyType const m_empty_bucket_value;         // empty bucket indicator
@@ -79,6 +80,15 @@ namespace tuddbs {
     BucketUsedType const m_bucket_empty = 0x0;  // empty bucket indicator
     BucketUsedType const m_bucket_full = 0x1;   // indicator for a full bucket
 
+    constexpr static bool reusable = has_hint<HintSet, hints::hashing::reusable_table>;
+    DirtyBucketTracker m_dirty_buckets;  // written buckets, only with hints::hashing::reusable_table
+
+    TSL_FORCE_INLINE auto mark_dirty(size_t const bucket) noexcept -> void {
+      if constexpr (reusable) {
+        m_dirty_buckets.mark(bucket);
+      }
+    }
+
    public:
     auto distinct_key_count() const noexcept { return m_used_bucket_count; }
     auto empty_bucket_value() const noexcept { return m_empty_bucket_value; }
@@ -97,18 +107,16 @@ namespace tuddbs {
         m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_position_sink)),
         m_used_bucket_sink(reinterpret_iterable<BucketUsedSinkType>(p_used_bucket_sink)),
         m_bucket_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_used_bucket_count(0),
         m_empty_bucket_value(p_empty_bucket_value),
-        m_invalid_position(p_invalid_position) {
+        m_invalid_position(p_invalid_position),
+        m_dirty_buckets(reusable ? DirtyBucketTracker(p_map_element_count) : DirtyBucketTracker()) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_bucket_count & (m_bucket_count - 1)) == 0);
       }
       if (initialize) {
-        for (size_t i = 0; i < m_bucket_count; ++i) {
-          m_key_sink[i] = m_empty_bucket_value;
-          m_used_bucket_sink[i] = m_bucket_empty;
-          m_original_positions_sink[i] = m_invalid_position;
-        }
+        initialize_sinks();
       }
     }
 
@@ -122,29 +130,51 @@ namespace tuddbs {
         m_used_bucket_sink(reinterpret_iterable<BucketUsedSinkType>(p_bucket_used_sink)),
         m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_position_sink)),
         m_bucket_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_used_bucket_count(0),
         m_empty_bucket_value(other.empty_bucket_value()),
-        m_invalid_position(other.invalid_position()) {
+        m_invalid_position(other.invalid_position()),
+        m_dirty_buckets(reusable ? DirtyBucketTracker(p_map_element_count) : DirtyBucketTracker()) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_bucket_count & (m_bucket_count - 1)) == 0);
       }
-      for (auto i = 0; i < m_bucket_count; ++i) {
-        m_key_sink[i] = m_empty_bucket_value;
-        m_used_bucket_sink[i] = m_bucket_empty;
-        m_original_positions_sink[i] = m_invalid_position;
-      }
+      initialize_sinks();
 
       merge(other);
     }
     ~Hash_Join_Build_SIMD_Linear_Probing() = default;
 
+    /**
+     * @brief Marks all buckets as empty, a register at a time. With p_thread_count > 1, the sinks are split into page
+     * aligned chunks that are filled concurrently (e.g. after constructing with initialize = false).
+     */
+    auto initialize_sinks(size_t p_thread_count = 1) -> void {
+      fill_sink<SimdStyle, Idof>(m_key_sink, m_bucket_count, m_empty_bucket_value, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_used_bucket_sink, m_bucket_count, m_bucket_empty, p_thread_count);
+      fill_sink<SimdStyle, Idof>(m_original_positions_sink, m_bucket_count, m_invalid_position, p_thread_count);
+    }
+
+    /**
+     * @brief Empties the hash table for the next build by restoring only the blocks of buckets that were written.
+     */
+    template <class HS = HintSet>
+    auto reset(enable_if_has_hint_t<HS, hints::hashing::reusable_table> = {}) noexcept -> void {
+      m_dirty_buckets.for_each_dirty_range([this](size_t begin, size_t end) {
+        fill_sink<SimdStyle, Idof>(m_key_sink + begin, end - begin, m_empty_bucket_value);
+        fill_sink<SimdStyle, Idof>(m_used_bucket_sink + begin, end - begin, m_bucket_empty);
+        fill_sink<SimdStyle, Idof>(m_original_positions_sink + begin, end - begin, m_invalid_position);
+      });
+      m_dirty_buckets.clear();
+      m_used_bucket_count = 0;
+    }
+
    private:
     TSL_FORCE_INLINE auto probe_position(typename SimdStyle::base_type const key) {
       auto const keys_reg = tsl::set1<SimdStyle, Idof>(key);
       auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
       auto lookup_position =
         normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          default_hasher<SimdStyle, Idof>::hash_value(key), m_bucket_count));
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
       typename SimdStyle::register_type map_reg;
       typename SimdStyle::register_type bucket_used;
       int64_t lookup_position_helper;
@@ -184,7 +214,7 @@ namespace tuddbs {
             return std::make_pair(lookup_position + found_position, false);
           } else {  // move to the next probing location
             lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-              lookup_position + SimdStyle::vector_element_count(), m_bucket_count);
+              lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
           }
         }
       } else {  // if the data doesn't include the empty position key as a value we can simplify the probing
@@ -214,7 +244,7 @@ namespace tuddbs {
             return std::make_pair(lookup_position + found_position, false);
           } else {  // move to the next probing location
             lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-              lookup_position + SimdStyle::vector_element_count(), m_bucket_count);
+              lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
           }
         }
       }
@@ -224,12 +254,14 @@ namespace tuddbs {
                                  size_t position) {
       if constexpr (has_hint<HintSet, hints::hash_join::global_first_occurence_required>) {
         if (key_position_in_data < m_original_positions_sink[position]) {
+          mark_dirty(position);
           m_used_bucket_count += (m_used_bucket_sink[position] == m_bucket_empty);
           m_original_positions_sink[position] = key_position_in_data;
           m_key_sink[position] = key;
           m_used_bucket_sink[position] = m_bucket_full;
         }
       } else {
+        mark_dirty(position);
         m_used_bucket_count += (m_used_bucket_sink[position] == m_bucket_empty);
         m_original_positions_sink[position] = key_position_in_data;
         m_key_sink[position] = key;
@@ -304,6 +336,7 @@ namespace tuddbs {
     BucketUsedSinkType m_used_bucket_sink;       // indicator for empty buckets
 
     size_t const m_bucket_count;
+    typename normalizer<SimdStyle, HintSet, Idof>::bucket_count_t const m_bucket_modulus;
 
     KeyType const m_empty_bucket_value;        // empty bucket indicator
     BucketUsedType const m_bucket_empty = 0;   // empty bucket indicator
@@ -318,6 +351,7 @@ namespace tuddbs {
         m_original_positions_sink(reinterpret_iterable<PositionSinkType>(p_position_sink)),
         m_used_bucket_sink(reinterpret_iterable<BucketUsedSinkType>(p_used_bucket_sink)),
         m_bucket_count(p_map_element_count),
+        m_bucket_modulus(p_map_element_count),
         m_empty_bucket_value(p_empty_bucket_value) {
       if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
         assert((m_bucket_count & (m_bucket_count - 1)) == 0);
@@ -332,7 +366,7 @@ namespace tuddbs {
       auto const all_false_mask = tsl::integral_all_false<SimdStyle, Idof>();
       auto lookup_position =
         normalizer<SimdStyle, HintSet, Idof>::align_value(normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-          default_hasher<SimdStyle, Idof>::hash_value(key), m_bucket_count));
+          hasher_t<SimdStyle, HintSet, Idof>::hash_value(key), m_bucket_modulus));
 
       typename SimdStyle::register_type map_reg;
       typename SimdStyle::register_type bucket_used;
@@ -371,7 +405,7 @@ namespace tuddbs {
             return 0;
           } else {  // move to the next probing location
             lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-              lookup_position + SimdStyle::vector_element_count(), m_bucket_count);
+              lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
           }
         }
       } else {  // if the data doesn't include the empty position key as a value we can simplify the probing
@@ -402,7 +436,7 @@ namespace tuddbs {
             return 0;
           } else {  // move to the next probing location
             lookup_position = normalizer<SimdStyle, HintSet, Idof>::normalize_value(
-              lookup_position + SimdStyle::vector_element_count(), m_bucket_count);
+              lookup_position + SimdStyle::vector_element_count(), m_bucket_modulus);
           }
         }
       }
@@ -30,6 +30,7 @@
 
 #include "algorithms/dbops/dbops_hints.hpp"
 #include "algorithms/utils/hinting.hpp"
+#include "datastructures/compressed_bitmap.hpp"
 #include "iterable.hpp"
 #include "tsl.hpp"
 
@@ -140,7 +141,29 @@ namespace tuddbs {
     auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data, SimdOpsIterable auto p_end,
                     SimdOpsIterable auto p_position_list, SimdOpsIterable auto p_position_list_end,
                     activate_for_position_list<HS> = {}) const noexcept -> decltype(p_result) {
-      auto positions = reinterpret_iterable<ValidElementIterableType>(p_position_list);
+      return gather(p_result, p_data, reinterpret_iterable<ValidElementIterableType>(p_position_list),
+                    p_position_list_end);
+    }
+
+    /**
+     * @brief Materializes the positions selected by a compressed bitmap.
+     * @details The selection is decoded batch-wise into position lists, which are gathered directly. This works
+     * independently of the intermediate format the operator was instantiated for.
+     */
+    template <tsl::VectorProcessingStyle BitmapSimdStyle, typename BitmapIdof>
+    auto operator()(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data,
+                    CompressedBitmap<BitmapSimdStyle, BitmapIdof> const &p_selection) const noexcept
+      -> decltype(p_result) {
+      auto result = p_result;
+      p_selection.for_each_batch([this, &result, p_data](size_t const *positions, size_t count) {
+        result = gather(result, p_data, positions, positions + count);
+      });
+      return result;
+    }
+
+   private:
+    auto gather(SimdOpsIterable auto p_result, SimdOpsIterable auto p_data, SimdOpsIterable auto positions,
+                SimdOpsIterable auto p_position_list_end) const noexcept -> decltype(p_result) {
       // Get the end of the data
       auto const end = iter_end(positions, p_position_list_end);
       // Get the result pointer
@@ -173,7 +196,7 @@ namespace tuddbs {
         constexpr auto const registers_per_batch =
           sizeof(typename PositionalSimdStyle::base_type) / sizeof(typename SimdStyle::base_type);
 
-        std::array<typename SimdStyle::base_type, registers_per_batch> data_array;
+        std::array<typename PositionalSimdStyle::register_type, registers_per_batch> data_array;
         typename PositionalSimdStyle::register_type current_positions;
         for (; positions != batched_end; result += SimdStyle::vector_element_count()) {
           for (size_t i = 0; i < registers_per_batch; ++i, positions += PositionalSimdStyle::vector_element_count()) {
@@ -200,6 +223,7 @@ namespace tuddbs {
       return result;
     }
 
+   public:
     template <tsl::VectorProcessingStyle OtherSimdStlye, class OtherHintSet, typename OtherIdof>
     auto merge(Materialize<OtherSimdStlye, OtherHintSet, OtherIdof> const &other) noexcept -> void {}
 
@@ -0,0 +1,82 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file conflict_detection.hpp
+ * @brief Detection of equal values across the lanes of a register.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONFLICT_DETECTION_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONFLICT_DETECTION_HPP
+
+#include <array>
+#include <climits>
+#include <cstdint>
+
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief Mask with the lowest N bits set, N being the number of lanes of SimdStyle.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle>
+  constexpr auto all_lanes_imask() noexcept -> typename SimdStyle::imask_type {
+    constexpr auto lanes = SimdStyle::vector_element_count();
+    if constexpr (lanes >= sizeof(uint64_t) * CHAR_BIT) {
+      return static_cast<typename SimdStyle::imask_type>(~uint64_t{0});
+    } else {
+      return static_cast<typename SimdStyle::imask_type>((uint64_t{1} << lanes) - 1);
+    }
+  }
+
+  /**
+   * @brief Returns the candidate lanes whose value already occurs in a lower candidate lane.
+   * @details This is the semantic of vpconflict restricted to a mask: of every set of candidate lanes holding the same
+   * value, only the lowest one is not reported. Every candidate that is not reported yet is broadcast and compared
+   * against the whole register, thus the costs grow with the number of distinct candidate values and not with the
+   * square of the lane count. Single candidates return immediately.
+   *
+   * @param p_values The register to check.
+   * @param p_candidates The lanes to consider, other lanes neither conflict nor cause conflicts.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  [[nodiscard]] TSL_FORCE_INLINE auto conflicting_lanes(typename SimdStyle::register_type p_values,
+                                                        typename SimdStyle::imask_type p_candidates) noexcept ->
+    typename SimdStyle::imask_type {
+    using imask_t = typename SimdStyle::imask_type;
+    imask_t conflicts = 0;
+    if ((p_candidates & (p_candidates - 1)) == 0) {
+      return conflicts;
+    }
+    alignas(64) std::array<typename SimdStyle::base_type, SimdStyle::vector_element_count()> values;
+    tsl::store<SimdStyle, Idof>(values.data(), p_values);
+    // Every lane leaves this mask either as the lowest lane of its value or as a conflict.
+    imask_t remaining = p_candidates;
+    while (remaining != 0) {
+      auto const lane = tsl::tzc<SimdStyle, Idof>(remaining);
+      auto const equal_lanes = static_cast<imask_t>(
+        tsl::equal_as_imask<SimdStyle, Idof>(p_values, tsl::set1<SimdStyle, Idof>(values[lane])) & p_candidates);
+      conflicts = static_cast<imask_t>(conflicts | (equal_lanes & ~(imask_t{1} << lane)));
+      remaining = static_cast<imask_t>(remaining & ~equal_lanes);
+    }
+    return conflicts;
+  }
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONFLICT_DETECTION_HPP
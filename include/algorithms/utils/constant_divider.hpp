@@ -0,0 +1,208 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Alexander Krause.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file constant_divider.hpp
+ * @brief Integer division by a runtime-invariant divisor via multiply-high and shift.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONSTANT_DIVIDER_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONSTANT_DIVIDER_HPP
+
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "tsl.hpp"
+
+namespace tuddbs {
+  /**
+   * @brief Divides integers by a divisor that is fixed at construction.
+   * @details The magic multiplier and the shifts are computed once (Granlund and Montgomery, "Division by Invariant
+   * Integers using Multiplication", Fig. 4.1): with l = ceil(log2(d)), m = floor(2^W * (2^l - d) / d) + 1 and
+   * t = mulhi(m, n), the quotient is (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0) for every divisor d >= 1, thus the
+   * hot path has no branches. Signed values are divided by their magnitude and negated afterwards, the result is
+   * truncated towards zero like the built-in operator /.
+   * Registers of 32- and 64-bit lanes compute the multiply-high from 32x32-bit products in 64-bit lanes, narrower types
+   * are divided lane by lane.
+   *
+   * @tparam _SimdStyle
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, typename Idof = tsl::workaround>
+  class ConstantDivider {
+   public:
+    using SimdStyle = _SimdStyle;
+    using reg_t = typename SimdStyle::register_type;
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = std::make_unsigned_t<base_t>;
+    static_assert(std::is_integral_v<base_t>, "Only integers can be divided by a ConstantDivider.");
+
+   private:
+    constexpr static int bits = sizeof(base_t) * CHAR_BIT;
+    using wide_t =
+      std::conditional_t<(bits <= 16), uint32_t, std::conditional_t<(bits == 32), uint64_t, unsigned __int128>>;
+    using UnsignedSimdStyle = typename SimdStyle::template transform_extension<unsigned_t>;
+    using WideSimdStyle = typename SimdStyle::template transform_extension<uint64_t>;
+    constexpr static bool divide_in_register =
+      (SimdStyle::vector_element_count() > 1) && ((bits == 32) || (bits == 64));
+
+    base_t m_divisor;
+    unsigned_t m_magic;
+    int m_shift_1;
+    int m_shift_2;
+
+    TSL_FORCE_INLINE static auto mulhi_value(unsigned_t a, unsigned_t b) -> unsigned_t {
+      return static_cast<unsigned_t>((static_cast<wide_t>(a) * b) >> bits);
+    }
+
+    TSL_FORCE_INLINE auto mulhi(typename UnsignedSimdStyle::register_type p_values) const ->
+      typename UnsignedSimdStyle::register_type {
+      auto const low_half = tsl::set1<WideSimdStyle, Idof>(uint64_t{0xFFFFFFFF});
+      if constexpr (bits == 32) {
+        // Even and odd lanes are multiplied separately in the 64-bit lanes.
+        auto const values = tsl::reinterpret<UnsignedSimdStyle, WideSimdStyle, Idof>(p_values);
+        auto const magic = tsl::set1<WideSimdStyle, Idof>(static_cast<uint64_t>(m_magic));
+        auto const even = tsl::mul<WideSimdStyle, Idof>(tsl::binary_and<WideSimdStyle, Idof>(values, low_half), magic);
+        auto const odd = tsl::mul<WideSimdStyle, Idof>(tsl::shift_right<WideSimdStyle, Idof>(values, 32), magic);
+        auto const high = tsl::binary_or<WideSimdStyle, Idof>(
+          tsl::shift_right<WideSimdStyle, Idof>(even, 32),
+          tsl::binary_and<WideSimdStyle, Idof>(odd, tsl::set1<WideSimdStyle, Idof>(~uint64_t{0xFFFFFFFF})));
+        return tsl::reinterpret<WideSimdStyle, UnsignedSimdStyle, Idof>(high);
+      } else {
+        // Schoolbook multiplication of the 32-bit halves, the middle terms are summed without overflow.
+        auto const values_low = tsl::binary_and<WideSimdStyle, Idof>(p_values, low_half);
+        auto const values_high = tsl::shift_right<WideSimdStyle, Idof>(p_values, 32);
+        auto const magic_low = tsl::set1<WideSimdStyle, Idof>(static_cast<uint64_t>(m_magic) & 0xFFFFFFFF);
+        auto const magic_high = tsl::set1<WideSimdStyle, Idof>(static_cast<uint64_t>(m_magic) >> 32);
+        auto const low_low = tsl::mul<WideSimdStyle, Idof>(values_low, magic_low);
+        auto const high_low = tsl::mul<WideSimdStyle, Idof>(values_high, magic_low);
+        auto const low_high = tsl::mul<WideSimdStyle, Idof>(values_low, magic_high);
+        auto const high_high = tsl::mul<WideSimdStyle, Idof>(values_high, magic_high);
+        auto const middle = tsl::add<WideSimdStyle, Idof>(
+          tsl::add<WideSimdStyle, Idof>(tsl::shift_right<WideSimdStyle, Idof>(low_low, 32),
+                                        tsl::binary_and<WideSimdStyle, Idof>(high_low, low_half)),
+          tsl::binary_and<WideSimdStyle, Idof>(low_high, low_half));
+        return tsl::add<WideSimdStyle, Idof>(
+          tsl::add<WideSimdStyle, Idof>(high_high, tsl::shift_right<WideSimdStyle, Idof>(high_low, 32)),
+          tsl::add<WideSimdStyle, Idof>(tsl::shift_right<WideSimdStyle, Idof>(low_high, 32),
+                                        tsl::shift_right<WideSimdStyle, Idof>(middle, 32)));
+      }
+    }
+
+    TSL_FORCE_INLINE auto divide_unsigned(typename UnsignedSimdStyle::register_type p_values) const ->
+      typename UnsignedSimdStyle::register_type {
+      auto const t = mulhi(p_values);
+      auto const correction =
+        tsl::shift_right<UnsignedSimdStyle, Idof>(tsl::sub<UnsignedSimdStyle, Idof>(p_values, t), m_shift_1);
+      return tsl::shift_right<UnsignedSimdStyle, Idof>(tsl::add<UnsignedSimdStyle, Idof>(t, correction), m_shift_2);
+    }
+
+    TSL_FORCE_INLINE auto divide_unsigned_value(unsigned_t p_value) const -> unsigned_t {
+      auto const t = mulhi_value(p_value, m_magic);
+      return static_cast<unsigned_t>(static_cast<unsigned_t>(t + static_cast<unsigned_t>((p_value - t) >> m_shift_1)) >>
+                                     m_shift_2);
+    }
+
+   public:
+    explicit ConstantDivider(base_t p_divisor) : m_divisor(p_divisor) {
+      if (p_divisor == 0) {
+        throw std::domain_error("ConstantDivider: Division by zero.");
+      }
+      unsigned_t magnitude = static_cast<unsigned_t>(p_divisor);
+      if constexpr (std::is_signed_v<base_t>) {
+        if (p_divisor < 0) {
+          magnitude = static_cast<unsigned_t>(unsigned_t{0} - magnitude);
+        }
+      }
+      int const l = (magnitude == 1) ? 0 : bits - std::countl_zero(static_cast<unsigned_t>(magnitude - 1));
+      // 2^W * (2^l - d) / d + 1 < 2^W, as 2^l - d < d.
+      wide_t const power_of_two_minus_divisor = (wide_t{1} << l) - magnitude;
+      m_magic = static_cast<unsigned_t>(((power_of_two_minus_divisor << bits) / magnitude) + 1);
+      m_shift_1 = (l < 1) ? l : 1;
+      m_shift_2 = (l > 1) ? l - 1 : 0;
+    }
+
+    auto divisor() const noexcept -> base_t { return m_divisor; }
+
+    /**
+     * @brief Quotient of a single value.
+     */
+    [[nodiscard]] TSL_FORCE_INLINE auto divide_value(base_t p_value) const -> base_t {
+      if constexpr (std::is_signed_v<base_t>) {
+        bool const negative_value = (p_value < 0);
+        unsigned_t const magnitude =
+          negative_value ? static_cast<unsigned_t>(unsigned_t{0} - static_cast<unsigned_t>(p_value))
+                         : static_cast<unsigned_t>(p_value);
+        unsigned_t const quotient = divide_unsigned_value(magnitude);
+        return (negative_value != (m_divisor < 0)) ? static_cast<base_t>(unsigned_t{0} - quotient)
+                                                   : static_cast<base_t>(quotient);
+      } else {
+        return divide_unsigned_value(p_value);
+      }
+    }
+
+    /**
+     * @brief Remainder of a single value, with the sign of the value like the built-in operator %.
+     */
+    [[nodiscard]] TSL_FORCE_INLINE auto modulo_value(base_t p_value) const -> base_t {
+      return static_cast<base_t>(p_value - divide_value(p_value) * m_divisor);
+    }
+
+    /**
+     * @brief Quotients of all lanes.
+     */
+    [[nodiscard]] TSL_FORCE_INLINE auto divide(reg_t p_values) const -> reg_t {
+      if constexpr (!divide_in_register) {
+        alignas(64) std::array<base_t, SimdStyle::vector_element_count()> values;
+        tsl::store<SimdStyle, Idof>(values.data(), p_values);
+        for (auto &value : values) {
+          value = divide_value(value);
+        }
+        return tsl::load<SimdStyle, Idof>(values.data());
+      } else if constexpr (std::is_signed_v<base_t>) {
+        auto const zero = tsl::set1<SimdStyle, Idof>(0);
+        auto const negative_values = tsl::less_than<SimdStyle, Idof>(p_values, zero);
+        auto const magnitudes =
+          tsl::blend<SimdStyle, Idof>(negative_values, p_values, tsl::sub<SimdStyle, Idof>(zero, p_values));
+        auto const quotients = tsl::reinterpret<UnsignedSimdStyle, SimdStyle, Idof>(
+          divide_unsigned(tsl::reinterpret<SimdStyle, UnsignedSimdStyle, Idof>(magnitudes)));
+        auto const negated_quotients = tsl::sub<SimdStyle, Idof>(zero, quotients);
+        // The quotient is negative if exactly one of value and divisor is.
+        return (m_divisor < 0) ? tsl::blend<SimdStyle, Idof>(negative_values, negated_quotients, quotients)
+                               : tsl::blend<SimdStyle, Idof>(negative_values, quotients, negated_quotients);
+      } else {
+        return divide_unsigned(p_values);
+      }
+    }
+
+    /**
+     * @brief Remainders of all lanes.
+     */
+    [[nodiscard]] TSL_FORCE_INLINE auto modulo(reg_t p_values) const -> reg_t {
+      return tsl::sub<SimdStyle, Idof>(
+        p_values, tsl::mul<SimdStyle, Idof>(divide(p_values), tsl::set1<SimdStyle, Idof>(m_divisor)));
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_UTILS_CONSTANT_DIVIDER_HPP
@@ -0,0 +1,320 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file hashers.hpp
+ * @brief Hash functions for the hash based operators.
+ *
+ * Every hasher provides hash (a register) and hash_value (a single value) returning the base type of SimdStyle. The
+ * hash tables use the low bits of a hash, thus all mixing hashers produce well distributed low bits. Hashes of signed
+ * types are never negative, as they are reduced via % if the table size is not a power of two.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_HASHERS_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_HASHERS_HPP
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+#include "tsl.hpp"
+
+namespace tuddbs {
+  namespace details {
+    template <typename T>
+    using hash_unsigned_t = std::make_unsigned_t<T>;
+
+    /**
+     * @brief Maps the unsigned result of a hash function to the base type, clearing the sign bit of signed types.
+     */
+    template <typename T>
+    TSL_FORCE_INLINE constexpr auto hash_to_base(hash_unsigned_t<T> p_hash) noexcept -> T {
+      if constexpr (std::is_signed_v<T>) {
+        return static_cast<T>(static_cast<hash_unsigned_t<T>>(p_hash >> 1));
+      } else {
+        return p_hash;
+      }
+    }
+
+    /**
+     * @brief Applies a scalar hash function to all lanes of a register.
+     */
+    template <tsl::VectorProcessingStyle SimdStyle, typename Idof, typename Fun>
+    TSL_FORCE_INLINE auto hash_lanes(typename SimdStyle::register_type p_keys, Fun p_hash) noexcept ->
+      typename SimdStyle::register_type {
+      alignas(64) std::array<typename SimdStyle::base_type, SimdStyle::vector_element_count()> keys;
+      tsl::store<SimdStyle, Idof>(keys.data(), p_keys);
+      for (auto &key : keys) {
+        key = p_hash(key);
+      }
+      return tsl::load<SimdStyle, Idof>(keys.data());
+    }
+
+    /**
+     * @brief Whether the mixing hashers operate on whole registers. Narrower lanes are hashed lane by lane.
+     */
+    template <tsl::VectorProcessingStyle SimdStyle>
+    inline constexpr bool hash_in_register =
+      (SimdStyle::vector_element_count() > 1) && std::is_integral_v<typename SimdStyle::base_type> &&
+      ((sizeof(typename SimdStyle::base_type) == sizeof(uint32_t)) ||
+       (sizeof(typename SimdStyle::base_type) == sizeof(uint64_t)));
+
+    /**
+     * @brief Clears the sign bit of a hashed register of a signed type, see hash_to_base.
+     */
+    template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+    TSL_FORCE_INLINE auto hash_reg_to_base(
+      typename SimdStyle::template transform_extension<hash_unsigned_t<typename SimdStyle::base_type>>::register_type
+        p_hashes) noexcept -> typename SimdStyle::register_type {
+      using UnsignedSimdStyle =
+        typename SimdStyle::template transform_extension<hash_unsigned_t<typename SimdStyle::base_type>>;
+      if constexpr (std::is_signed_v<typename SimdStyle::base_type>) {
+        return tsl::reinterpret<UnsignedSimdStyle, SimdStyle, Idof>(
+          tsl::shift_right<UnsignedSimdStyle, Idof>(p_hashes, 1));
+      } else {
+        return p_hashes;
+      }
+    }
+
+    /**
+     * @brief splitmix64, used to fill the tabulation tables at compile time.
+     */
+    constexpr auto splitmix64(uint64_t &p_state) noexcept -> uint64_t {
+      uint64_t z = (p_state += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+
+    template <typename T>
+    constexpr auto make_tabulation_table() noexcept {
+      std::array<T, sizeof(T) * 256> table{};
+      uint64_t state = 0x5DEECE66Dull * sizeof(T);
+      for (auto &entry : table) {
+        entry = static_cast<T>(splitmix64(state));
+      }
+      return table;
+    }
+
+    /**
+     * @brief One table of 256 random words per key byte, the tables of all bytes are stored consecutively.
+     */
+    template <typename T>
+    alignas(64) inline constexpr auto tabulation_table = make_tabulation_table<T>();
+
+    constexpr auto make_crc32c_table() noexcept {
+      std::array<uint32_t, 256> table{};
+      for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+          crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78u : 0u);
+        }
+        table[i] = crc;
+      }
+      return table;
+    }
+    inline constexpr auto crc32c_table = make_crc32c_table();
+
+    /**
+     * @brief CRC32-C of a 32- or 64-bit word, via the SSE4.2 crc32 instruction if available.
+     */
+    template <typename T>
+    TSL_FORCE_INLINE auto crc32c(uint32_t p_crc, T p_value) noexcept -> uint32_t {
+#ifdef __SSE4_2__
+      if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        return static_cast<uint32_t>(_mm_crc32_u64(p_crc, static_cast<uint64_t>(p_value)));
+      } else {
+        return _mm_crc32_u32(p_crc, static_cast<uint32_t>(p_value));
+      }
+#else
+      for (size_t byte = 0; byte < sizeof(T); ++byte) {
+        p_crc = (p_crc >> 8) ^ crc32c_table[(p_crc ^ static_cast<uint32_t>(p_value >> (byte * CHAR_BIT))) & 0xFF];
+      }
+      return p_crc;
+#endif
+    }
+  }  // namespace details
+
+  /**
+   * @brief Returns the key unchanged. Suited for dense keys, which then fill the buckets without collisions.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  class identity_hasher {
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type key) { return key; }
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(typename SimdStyle::base_type key) { return key; }
+  };
+
+  /**
+   * @brief Multiplication by an odd constant (Fibonacci hashing). As the tables use the low bits, the high half of the
+   * product is folded into the low half.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  class multiply_shift_hasher {
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = details::hash_unsigned_t<base_t>;
+    using UnsignedSimdStyle = typename SimdStyle::template transform_extension<unsigned_t>;
+    constexpr static int bits = sizeof(base_t) * CHAR_BIT;
+    constexpr static unsigned_t multiplier = static_cast<unsigned_t>(0x9E3779B97F4A7C15ull);
+
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(base_t key) -> base_t {
+      auto const product = static_cast<unsigned_t>(static_cast<unsigned_t>(key) * multiplier);
+      return details::hash_to_base<base_t>(static_cast<unsigned_t>(product ^ (product >> (bits / 2))));
+    }
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type keys) ->
+      typename SimdStyle::register_type {
+      if constexpr (details::hash_in_register<SimdStyle>) {
+        auto const product = tsl::mul<UnsignedSimdStyle, Idof>(
+          tsl::reinterpret<SimdStyle, UnsignedSimdStyle, Idof>(keys), tsl::set1<UnsignedSimdStyle, Idof>(multiplier));
+        return details::hash_reg_to_base<SimdStyle, Idof>(tsl::binary_xor<UnsignedSimdStyle, Idof>(
+          product, tsl::shift_right<UnsignedSimdStyle, Idof>(product, bits / 2)));
+      } else {
+        return details::hash_lanes<SimdStyle, Idof>(keys, [](base_t key) { return hash_value(key); });
+      }
+    }
+  };
+
+  /**
+   * @brief The finalizer of MurmurHash3 (fmix32 / fmix64), narrower types are widened to 32 bit.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  class murmur3_hasher {
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = details::hash_unsigned_t<base_t>;
+    using UnsignedSimdStyle = typename SimdStyle::template transform_extension<unsigned_t>;
+    using mix_t = std::conditional_t<(sizeof(base_t) == sizeof(uint64_t)), uint64_t, uint32_t>;
+    constexpr static bool is_64 = std::is_same_v<mix_t, uint64_t>;
+    constexpr static int shift_1 = is_64 ? 33 : 16;
+    constexpr static int shift_2 = is_64 ? 33 : 13;
+    constexpr static int shift_3 = is_64 ? 33 : 16;
+    constexpr static mix_t multiplier_1 = is_64 ? static_cast<mix_t>(0xFF51AFD7ED558CCDull) : mix_t{0x85EBCA6Bu};
+    constexpr static mix_t multiplier_2 = is_64 ? static_cast<mix_t>(0xC4CEB9FE1A85EC53ull) : mix_t{0xC2B2AE35u};
+
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(base_t key) -> base_t {
+      auto h = static_cast<mix_t>(static_cast<unsigned_t>(key));
+      h ^= h >> shift_1;
+      h *= multiplier_1;
+      h ^= h >> shift_2;
+      h *= multiplier_2;
+      h ^= h >> shift_3;
+      return details::hash_to_base<base_t>(static_cast<unsigned_t>(h));
+    }
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type keys) ->
+      typename SimdStyle::register_type {
+      if constexpr (details::hash_in_register<SimdStyle>) {
+        auto h = tsl::reinterpret<SimdStyle, UnsignedSimdStyle, Idof>(keys);
+        h = tsl::binary_xor<UnsignedSimdStyle, Idof>(h, tsl::shift_right<UnsignedSimdStyle, Idof>(h, shift_1));
+        h = tsl::mul<UnsignedSimdStyle, Idof>(h, tsl::set1<UnsignedSimdStyle, Idof>(multiplier_1));
+        h = tsl::binary_xor<UnsignedSimdStyle, Idof>(h, tsl::shift_right<UnsignedSimdStyle, Idof>(h, shift_2));
+        h = tsl::mul<UnsignedSimdStyle, Idof>(h, tsl::set1<UnsignedSimdStyle, Idof>(multiplier_2));
+        h = tsl::binary_xor<UnsignedSimdStyle, Idof>(h, tsl::shift_right<UnsignedSimdStyle, Idof>(h, shift_3));
+        return details::hash_reg_to_base<SimdStyle, Idof>(h);
+      } else {
+        return details::hash_lanes<SimdStyle, Idof>(keys, [](base_t key) { return hash_value(key); });
+      }
+    }
+  };
+
+  /**
+   * @brief CRC32-C, computed by the crc32 instruction (SSE4.2) lane by lane. 64-bit keys combine the CRCs of their
+   * two halves and mix them with a multiply-xorshift, such that all 64 bits of the key affect the low bits of the hash.
+   * @details Two CRCs of the same value with different seeds would only differ by a constant, i.e. carry 32 bits of
+   * entropy. The CRC of a 32-bit value and the mix are bijective, thus distinct 64-bit keys get distinct hashes.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  class crc32c_hasher {
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = details::hash_unsigned_t<base_t>;
+
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(base_t key) -> base_t {
+      auto const value = static_cast<unsigned_t>(key);
+      if constexpr (sizeof(base_t) == sizeof(uint64_t)) {
+        uint64_t const low = details::crc32c(0xFFFFFFFFu, static_cast<uint32_t>(value));
+        uint64_t const high = details::crc32c(0xFFFFFFFFu, static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+        uint64_t h = (high << 32) | low;
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+        return details::hash_to_base<base_t>(static_cast<unsigned_t>(h));
+      } else {
+        return details::hash_to_base<base_t>(
+          static_cast<unsigned_t>(details::crc32c(0xFFFFFFFFu, static_cast<uint32_t>(value))));
+      }
+    }
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type keys) ->
+      typename SimdStyle::register_type {
+      if constexpr (SimdStyle::vector_element_count() == 1) {
+        return hash_value(keys);
+      } else {
+        return details::hash_lanes<SimdStyle, Idof>(keys, [](base_t key) { return hash_value(key); });
+      }
+    }
+  };
+
+  /**
+   * @brief Simple tabulation hashing: the XOR of one random word per key byte. Registers of 32- and 64-bit lanes look
+   * the words up via gather.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround>
+  class tabulation_hasher {
+    using base_t = typename SimdStyle::base_type;
+    using unsigned_t = details::hash_unsigned_t<base_t>;
+    using UnsignedSimdStyle = typename SimdStyle::template transform_extension<unsigned_t>;
+
+   public:
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(base_t key) -> base_t {
+      auto const value = static_cast<unsigned_t>(key);
+      unsigned_t h = 0;
+      for (size_t byte = 0; byte < sizeof(base_t); ++byte) {
+        h ^= details::tabulation_table<unsigned_t>[(byte << 8) | ((value >> (byte * CHAR_BIT)) & 0xFF)];
+      }
+      return details::hash_to_base<base_t>(h);
+    }
+    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type keys) ->
+      typename SimdStyle::register_type {
+      if constexpr (details::hash_in_register<SimdStyle>) {
+        auto const values = tsl::reinterpret<SimdStyle, UnsignedSimdStyle, Idof>(keys);
+        auto const byte_mask = tsl::set1<UnsignedSimdStyle, Idof>(0xFF);
+        auto h = tsl::set1<UnsignedSimdStyle, Idof>(0);
+        for (size_t byte = 0; byte < sizeof(base_t); ++byte) {
+          auto const index = tsl::add<UnsignedSimdStyle, Idof>(
+            tsl::binary_and<UnsignedSimdStyle, Idof>(
+              tsl::shift_right<UnsignedSimdStyle, Idof>(values, static_cast<int>(byte * CHAR_BIT)), byte_mask),
+            tsl::set1<UnsignedSimdStyle, Idof>(static_cast<unsigned_t>(byte << 8)));
+          h = tsl::binary_xor<UnsignedSimdStyle, Idof>(
+            h, tsl::gather<UnsignedSimdStyle, Idof>(details::tabulation_table<unsigned_t>.data(), index));
+        }
+        return details::hash_reg_to_base<SimdStyle, Idof>(h);
+      } else {
+        return details::hash_lanes<SimdStyle, Idof>(keys, [](base_t key) { return hash_value(key); });
+      }
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_UTILS_HASHERS_HPP
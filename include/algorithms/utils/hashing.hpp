@@ -24,7 +24,17 @@
 #ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_HASHING_HPP
 #define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_HASHING_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#include "algorithms/utils/constant_divider.hpp"
+#include "algorithms/utils/hashers.hpp"
 #include "algorithms/utils/hinting.hpp"
+#include "algorithms/utils/table_init.hpp"
 #include "iterable.hpp"
 #include "tsl.hpp"
 
@@ -39,17 +49,62 @@ namespace tuddbs {
 
       struct linear_displacement {};
       struct refill {};
+      /**
+       * @brief The builder tracks which blocks of buckets it wrote, so reset() restores only those for the next use of
+       * the table instead of clearing all sinks.
+       */
+      struct reusable_table {};
+      /**
+       * @brief The table is an array of cache line sized bucket groups, each holding keys followed by their payloads
+       * (see InterleavedBucketGroup), instead of separate key and payload sinks.
+       */
+      struct interleaved_buckets {};
+
+      /**
+       * @brief Hash function hints. Any hint with a member template hasher_t<SimdStyle, Idof> selects that hasher, thus
+       * custom hash functions are plugged in the same way. Without such a hint, default_hasher is used.
+       */
+      struct identity_hash {
+        template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+        using hasher_t = identity_hasher<SimdStyle, Idof>;
+      };
+      struct multiply_shift_hash {
+        template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+        using hasher_t = multiply_shift_hasher<SimdStyle, Idof>;
+      };
+      struct murmur3_hash {
+        template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+        using hasher_t = murmur3_hasher<SimdStyle, Idof>;
+      };
+      struct crc32c_hash {
+        template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+        using hasher_t = crc32c_hasher<SimdStyle, Idof>;
+      };
+      struct tabulation_hash {
+        template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+        using hasher_t = tabulation_hasher<SimdStyle, Idof>;
+      };
     }  // namespace hashing
   }    // namespace hints
 
   template <tsl::VectorProcessingStyle SimdStyle, class HintSet, tsl::ImplementationDegreeOfFreedom Idof>
   class normalizer {
    public:
+    /**
+     * @brief Bucket count as stored by the hash tables. Unless it is a power of two, it is a ConstantDivider, which
+     * replaces the modulo by a multiply-high and shifts.
+     */
+    using bucket_count_t =
+      std::conditional_t<has_hint<HintSet, hints::hashing::size_exp_2> ||
+                           !std::is_integral_v<typename SimdStyle::base_type>,
+                         typename SimdStyle::base_type, ConstantDivider<SimdStyle, Idof>>;
+
     [[nodiscard]] TSL_FORCE_INLINE static auto normalize(typename SimdStyle::register_type position_hint,
                                                          typename SimdStyle::register_type bucket_count) {
       if constexpr (std::is_integral_v<typename SimdStyle::base_type>) {
          if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
-           return tsl::binary_and<SimdStyle, Idof>(position_hint, bucket_count);
+           return tsl::binary_and<SimdStyle, Idof>(
+             position_hint, tsl::sub<SimdStyle, Idof>(bucket_count, tsl::set1<SimdStyle, Idof>(1)));
          } else {
            return tsl::mod<SimdStyle, Idof>(position_hint, bucket_count);
          }
@@ -74,16 +129,138 @@ namespace tuddbs {
 
       }
     }
+    template <typename Divider>
+      requires std::same_as<Divider, ConstantDivider<SimdStyle, Idof>>
+    [[nodiscard]] TSL_FORCE_INLINE static auto normalize(typename SimdStyle::register_type position_hint,
+                                                         Divider const &bucket_count) {
+      return bucket_count.modulo(position_hint);
+    }
+    template <typename Divider>
+      requires std::same_as<Divider, ConstantDivider<SimdStyle, Idof>>
+    [[nodiscard]] TSL_FORCE_INLINE static auto normalize_value(typename SimdStyle::base_type position_hint,
+                                                               Divider const &bucket_count) {
+      return bucket_count.modulo_value(position_hint);
+    }
     [[nodiscard]] TSL_FORCE_INLINE static auto align_value(typename SimdStyle::base_type position_hint) {
       return position_hint - (position_hint & (SimdStyle::vector_element_count() - 1));
     }
   };
 
+  /**
+   * @brief The number of sink entries behind the last of p_bucket_count buckets that the probes read. Probes load a
+   * register at the aligned start of a bucket group, so unless the bucket count is a power of two (size_exp_2) or a
+   * multiple of the register width, the last group reaches beyond the last bucket. Such sinks have to hold
+   * p_bucket_count + bucket_padding() entries, the builders initialize the padding like the buckets.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, class HintSet>
+  constexpr auto bucket_padding(size_t p_bucket_count) noexcept -> size_t {
+    if constexpr (has_hint<HintSet, hints::hashing::size_exp_2>) {
+      return 0;
+    } else {
+      return (p_bucket_count % SimdStyle::vector_element_count() == 0) ? 0 : SimdStyle::vector_element_count();
+    }
+  }
+
+  /**
+   * @brief The hasher used without a hash function hint: the Murmur3 finalizer for integers, as sequential keys and
+   * keys sharing their low bits would otherwise cluster in the buckets. Other types are not hashed.
+   */
   template <tsl::VectorProcessingStyle SimdStyle, tsl::ImplementationDegreeOfFreedom Idof>
-  class default_hasher {
+  class default_hasher
+    : public std::conditional_t<std::is_integral_v<typename SimdStyle::base_type>, murmur3_hasher<SimdStyle, Idof>,
+                                identity_hasher<SimdStyle, Idof>> {};
+
+  template <typename Hint, class SimdStyle, typename Idof>
+  concept HashFunctionHint = requires { typename Hint::template hasher_t<SimdStyle, Idof>; };
+
+  template <class SimdStyle, class HintSet, typename Idof>
+  struct hasher_selector {
+    using type = default_hasher<SimdStyle, Idof>;
+  };
+
+  template <class SimdStyle, typename Idof, typename Hint, typename... Hints>
+  struct hasher_selector<SimdStyle, OperatorHintSet<Hint, Hints...>, Idof>
+    : hasher_selector<SimdStyle, OperatorHintSet<Hints...>, Idof> {};
+
+  template <class SimdStyle, typename Idof, typename Hint, typename... Hints>
+    requires HashFunctionHint<Hint, SimdStyle, Idof>
+  struct hasher_selector<SimdStyle, OperatorHintSet<Hint, Hints...>, Idof> {
+    using type = typename Hint::template hasher_t<SimdStyle, Idof>;
+  };
+
+  /**
+   * @brief The hasher selected by the first hash function hint of HintSet, default_hasher if there is none.
+   */
+  template <class SimdStyle, class HintSet, typename Idof>
+  using hasher_t = typename hasher_selector<SimdStyle, HintSet, Idof>::type;
+
+  /**
+   * @brief Hashers that hash a whole register. User defined hash functions may only provide hash_value.
+   */
+  template <class Hasher, class SimdStyle>
+  concept RegisterHasher = requires(typename SimdStyle::register_type const reg) { Hasher::hash(reg); };
+
+  /**
+   * @brief A bucket group of a table with hints::hashing::interleaved_buckets: the keys of a few buckets followed by
+   * the payloads of these keys. A group has as many buckets as a register has lanes, but at most as many as fit a
+   * cache line together with their payloads, and it is aligned so it does not straddle cache lines. A probe compares
+   * the keys with one aligned SIMD load and finds the payload of a hit in the same cache line.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename PayloadType>
+  struct InterleavedBucketGroup {
+    using KeyType = typename SimdStyle::base_type;
+    using imask_t = typename SimdStyle::imask_type;
+
+    constexpr static size_t cache_line_size = 64;
+    constexpr static size_t bucket_count =
+      std::min<size_t>(SimdStyle::vector_element_count(),
+                       std::max<size_t>(std::bit_floor(cache_line_size / (sizeof(KeyType) + sizeof(PayloadType))), 1));
+
+   private:
+    struct layout_t {
+      std::array<KeyType, bucket_count> keys;
+      std::array<PayloadType, bucket_count> payloads;
+    };
+    // The key register is loaded from the start of the group and may reach into the payloads, so the group has to be
+    // at least as large as a register.
+    constexpr static size_t alignment = std::max<size_t>(std::bit_ceil(sizeof(layout_t)),
+                                                         SimdStyle::vector_element_count() * sizeof(KeyType));
+
    public:
-    [[nodiscard]] TSL_FORCE_INLINE static auto hash(typename SimdStyle::register_type key) { return key; }
-    [[nodiscard]] TSL_FORCE_INLINE static auto hash_value(typename SimdStyle::base_type key) { return key; }
+    alignas(alignment) std::array<KeyType, bucket_count> keys;
+    std::array<PayloadType, bucket_count> payloads;
+
+    /**
+     * @brief Loads the keys into a register. If the group has fewer buckets than lanes, the upper lanes hold payload
+     * bytes and have to be masked off with bucket_lanes().
+     */
+    template <typename Idof>
+    auto load_keys() const noexcept -> typename SimdStyle::register_type {
+      return tsl::load<SimdStyle, Idof>(keys.data());
+    }
+
+    /**
+     * @brief The lanes of a key register that belong to a bucket.
+     */
+    constexpr static auto bucket_lanes() noexcept -> imask_t {
+      return static_cast<imask_t>((uint64_t{1} << bucket_count) - 1);
+    }
+
+    /**
+     * @brief Returns the lanes of p_candidates whose payload differs from p_empty_payload. This tells a key equal to
+     * the empty bucket value apart from an empty bucket.
+     */
+    template <typename Idof, typename MaskType>
+    auto occupied_lanes(MaskType p_candidates, PayloadType p_empty_payload) const noexcept -> MaskType {
+      MaskType occupied = 0;
+      for (auto lanes = p_candidates; lanes != 0; lanes = static_cast<MaskType>(lanes & (lanes - 1))) {
+        auto const lane = tsl::tzc<SimdStyle, Idof>(lanes);
+        if (payloads[lane] != p_empty_payload) {
+          occupied = static_cast<MaskType>(occupied | (MaskType{1} << lane));
+        }
+      }
+      return occupied;
+    }
   };
 
 }  // namespace tuddbs
@@ -0,0 +1,203 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file spill_file.hpp
+ * @brief Runs of (key, payload) pairs that are written to and read back from an anonymous file on the local disk.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_SPILL_FILE_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_SPILL_FILE_HPP
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tuddbs {
+
+  /**
+   * @brief An append-only run of (key, payload) pairs in a file on the local disk.
+   * @details The pairs are collected in a block of block_records keys followed by block_records payloads, a full block
+   * is written with one sequential write. Blocks are a multiple of 4 KiB and the block buffer is 4 KiB aligned, thus
+   * the file can be opened with O_DIRECT to bypass the page cache. If the file system does not support O_DIRECT, the
+   * run falls back to buffered I/O. The file is unlinked right after its creation, so it is removed when the run is
+   * destroyed, even if the process terminates.
+   */
+  template <typename KeyType, typename PayloadType>
+  class SpillRun {
+    static_assert(std::is_trivially_copyable_v<KeyType> && std::is_trivially_copyable_v<PayloadType>,
+                  "Spilled pairs are written as raw bytes.");
+
+   public:
+    constexpr static size_t block_records = size_t{16} << 10;
+    constexpr static size_t block_bytes = block_records * (sizeof(KeyType) + sizeof(PayloadType));
+    constexpr static size_t io_alignment = 4096;
+    static_assert(block_bytes % io_alignment == 0);
+
+   private:
+    struct free_deleter {
+      auto operator()(void *p) const noexcept -> void { std::free(p); }
+    };
+
+    int m_fd = -1;
+    std::unique_ptr<std::byte, free_deleter> m_block;
+    size_t m_block_fill = 0;
+    size_t m_written_blocks = 0;
+    size_t m_record_count = 0;
+    bool m_direct_io = false;
+
+    [[noreturn]] static auto throw_errno(char const *p_what) -> void {
+      throw std::system_error(errno, std::generic_category(), p_what);
+    }
+
+    auto keys() const noexcept -> KeyType * { return reinterpret_cast<KeyType *>(m_block.get()); }
+    auto payloads() const noexcept -> PayloadType * {
+      return reinterpret_cast<PayloadType *>(m_block.get() + block_records * sizeof(KeyType));
+    }
+
+    auto write_block() -> void {
+      auto const offset = static_cast<off_t>(m_written_blocks * block_bytes);
+      for (size_t done = 0; done < block_bytes;) {
+        auto const written = ::pwrite(m_fd, m_block.get() + done, block_bytes - done, offset + done);
+        if (written < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw_errno("Writing a spill block failed");
+        }
+        done += static_cast<size_t>(written);
+      }
+      ++m_written_blocks;
+      m_block_fill = 0;
+    }
+
+    auto read_block(size_t p_block) -> void {
+      auto const offset = static_cast<off_t>(p_block * block_bytes);
+      for (size_t done = 0; done < block_bytes;) {
+        auto const read = ::pread(m_fd, m_block.get() + done, block_bytes - done, offset + done);
+        if (read < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          throw_errno("Reading a spill block failed");
+        }
+        if (read == 0) {
+          throw std::system_error(std::make_error_code(std::errc::io_error), "A spill file is truncated");
+        }
+        done += static_cast<size_t>(read);
+      }
+    }
+
+   public:
+    /**
+     * @brief Creates the file of the run in p_directory.
+     *
+     * @param p_directory A directory on the local disk.
+     * @param p_direct_io Open the file with O_DIRECT, if the file system supports it.
+     */
+    explicit SpillRun(std::filesystem::path const &p_directory, bool p_direct_io = false) {
+      auto path = (p_directory / "simdops_spill_XXXXXX").string();
+      m_fd = ::mkstemp(path.data());
+      if (m_fd < 0) {
+        throw_errno("Creating a spill file failed");
+      }
+      ::unlink(path.c_str());
+#ifdef O_DIRECT
+      if (p_direct_io) {
+        auto const flags = ::fcntl(m_fd, F_GETFL);
+        m_direct_io = flags >= 0 && ::fcntl(m_fd, F_SETFL, flags | O_DIRECT) == 0;
+      }
+#else
+      (void)p_direct_io;
+#endif
+      m_block.reset(static_cast<std::byte *>(std::aligned_alloc(io_alignment, block_bytes)));
+      if (m_block == nullptr) {
+        ::close(m_fd);
+        throw std::bad_alloc();
+      }
+    }
+
+    SpillRun(SpillRun const &) = delete;
+    SpillRun &operator=(SpillRun const &) = delete;
+    SpillRun(SpillRun &&other) noexcept
+      : m_fd(std::exchange(other.m_fd, -1)),
+        m_block(std::move(other.m_block)),
+        m_block_fill(other.m_block_fill),
+        m_written_blocks(other.m_written_blocks),
+        m_record_count(other.m_record_count),
+        m_direct_io(other.m_direct_io) {}
+    SpillRun &operator=(SpillRun &&) = delete;
+
+    ~SpillRun() noexcept {
+      if (m_fd >= 0) {
+        ::close(m_fd);
+      }
+    }
+
+    auto record_count() const noexcept { return m_record_count; }
+    auto direct_io() const noexcept { return m_direct_io; }
+    /**
+     * @brief The bytes written to the file so far.
+     */
+    auto file_bytes() const noexcept { return m_written_blocks * block_bytes; }
+
+    /**
+     * @brief Appends one pair, a full block is written to the file.
+     */
+    auto append(KeyType p_key, PayloadType p_payload) -> void {
+      keys()[m_block_fill] = p_key;
+      payloads()[m_block_fill] = p_payload;
+      ++m_record_count;
+      if (++m_block_fill == block_records) {
+        write_block();
+      }
+    }
+
+    /**
+     * @brief Calls p_fun(keys, payloads, count) for every block of the run, in the order of appending. The last block
+     * is written before, thus no pairs may be appended afterwards.
+     */
+    template <class Fun>
+    auto for_each_block(Fun &&p_fun) -> void {
+      if (m_block_fill != 0) {
+        // The unused tail of the last block keeps the file a multiple of the block size.
+        write_block();
+      }
+      for (size_t block = 0; block < m_written_blocks; ++block) {
+        read_block(block);
+        auto const count = std::min(block_records, m_record_count - block * block_records);
+        p_fun(static_cast<KeyType const *>(keys()), static_cast<PayloadType const *>(payloads()), count);
+      }
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_ALGORITHMS_UTILS_SPILL_FILE_HPP
@@ -0,0 +1,164 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file table_init.hpp
+ * @brief Initialization and reset of the sinks of the hash based operators.
+ */
+
+#ifndef SIMDOPS_INCLUDE_ALGORITHMS_UTILS_TABLE_INIT_HPP
+#define SIMDOPS_INCLUDE_ALGORITHMS_UTILS_TABLE_INIT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @brief Sinks of at least this many bytes are filled with non-temporal stores, as they would only evict the caches.
+   */
+  inline constexpr size_t non_temporal_fill_threshold = size_t{8} << 20;
+
+  namespace details {
+    /**
+     * @brief Fills [p_begin, p_end) with 16 byte non-temporal stores, the unaligned head and the tail are written
+     * directly. Returns false if non-temporal stores are not available.
+     */
+    template <typename T>
+    auto stream_fill(T *p_begin, T *p_end, T p_value) noexcept -> bool {
+#ifdef __SSE2__
+      if constexpr ((16 % sizeof(T)) == 0) {
+        constexpr size_t per_store = 16 / sizeof(T);
+        std::array<T, per_store> pattern;
+        pattern.fill(p_value);
+        auto const value_reg = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pattern.data()));
+        for (; p_begin != p_end && (reinterpret_cast<uintptr_t>(p_begin) & 15) != 0; ++p_begin) {
+          *p_begin = p_value;
+        }
+        for (; static_cast<size_t>(p_end - p_begin) >= per_store; p_begin += per_store) {
+          _mm_stream_si128(reinterpret_cast<__m128i *>(p_begin), value_reg);
+        }
+        _mm_sfence();
+        for (; p_begin != p_end; ++p_begin) {
+          *p_begin = p_value;
+        }
+        return true;
+      }
+#endif
+      return false;
+    }
+  }  // namespace details
+
+  /**
+   * @brief Fills p_count elements of a sink with p_value using registers of the extension of SimdStyle. Sinks of at
+   * least non_temporal_fill_threshold bytes bypass the caches.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround, typename T>
+  auto fill_sink(T *p_sink, size_t p_count, T p_value) noexcept -> void {
+    if (p_count * sizeof(T) >= non_temporal_fill_threshold && details::stream_fill(p_sink, p_sink + p_count, p_value)) {
+      return;
+    }
+    using FillStyle = typename SimdStyle::template transform_extension<T>;
+    size_t i = 0;
+    if constexpr (FillStyle::vector_element_count() > 1) {
+      auto const value_reg = tsl::set1<FillStyle, Idof>(p_value);
+      for (; i + FillStyle::vector_element_count() <= p_count; i += FillStyle::vector_element_count()) {
+        tsl::storeu<FillStyle, Idof>(p_sink + i, value_reg);
+      }
+    }
+    for (; i < p_count; ++i) {
+      p_sink[i] = p_value;
+    }
+  }
+
+  /**
+   * @brief Fills a sink like fill_sink, split into page aligned chunks across p_thread_count threads.
+   */
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof = tsl::workaround, typename T>
+  auto fill_sink(T *p_sink, size_t p_count, T p_value, size_t p_thread_count) -> void {
+    constexpr size_t page_elements = std::max<size_t>(4096 / sizeof(T), 1);
+    if (p_thread_count <= 1 || p_count < 2 * page_elements) {
+      fill_sink<SimdStyle, Idof>(p_sink, p_count, p_value);
+      return;
+    }
+    size_t const chunk = ((p_count / p_thread_count + page_elements - 1) / page_elements) * page_elements;
+    std::vector<std::thread> pool;
+    for (size_t begin = chunk; begin < p_count; begin += chunk) {
+      pool.emplace_back(
+        [=]() { fill_sink<SimdStyle, Idof>(p_sink + begin, std::min(chunk, p_count - begin), p_value); });
+    }
+    fill_sink<SimdStyle, Idof>(p_sink, std::min(chunk, p_count), p_value);
+    for (auto &thread : pool) {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Records the blocks of buckets a builder wrote, so that only those are restored for the next use of a table.
+   */
+  class DirtyBucketTracker {
+    constexpr static size_t block_shift = 8;
+    constexpr static size_t block_size = size_t{1} << block_shift;
+
+    std::vector<uint64_t> m_blocks;
+    size_t m_dirty_end = 0;
+
+   public:
+    DirtyBucketTracker() = default;
+    explicit DirtyBucketTracker(size_t p_bucket_count) : m_blocks(((p_bucket_count >> block_shift) >> 6) + 1, 0) {}
+
+    TSL_FORCE_INLINE auto mark(size_t p_bucket) noexcept -> void {
+      auto const block = p_bucket >> block_shift;
+      m_blocks[block >> 6] |= uint64_t{1} << (block & 63);
+      m_dirty_end = std::max(m_dirty_end, p_bucket + 1);
+    }
+
+    /**
+     * @brief Calls p_fun(begin, end) for every block of buckets that contains a written bucket. The last block ends at
+     * the last written bucket, thus a range never exceeds the buckets the builder touched.
+     */
+    template <class Fun>
+    auto for_each_dirty_range(Fun &&p_fun) const -> void {
+      for (size_t word = 0; word < m_blocks.size(); ++word) {
+        for (auto bits = m_blocks[word]; bits != 0; bits &= bits - 1) {
+          auto const begin = ((word << 6) + static_cast<size_t>(std::countr_zero(bits))) << block_shift;
+          p_fun(begin, std::min(begin + block_size, m_dirty_end));
+        }
+      }
+    }
+
+    auto clear() noexcept -> void {
+      std::fill(m_blocks.begin(), m_blocks.end(), 0);
+      m_dirty_end = 0;
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif
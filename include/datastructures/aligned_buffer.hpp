@@ -0,0 +1,102 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file aligned_buffer.hpp
+ * @brief Owning, aligned and optionally huge-page-backed memory for operator state such as hash tables.
+ */
+
+#ifndef SIMDOPS_INCLUDE_DATASTRUCTURES_ALIGNED_BUFFER_HPP
+#define SIMDOPS_INCLUDE_DATASTRUCTURES_ALIGNED_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace tuddbs {
+  /**
+   * @brief A move-only array of trivial elements, aligned to a cache line or, with huge pages, to 2 MiB.
+   * @details With huge pages, the allocation is rounded up to a multiple of 2 MiB and advised to be backed by
+   * transparent huge pages (Linux only), which reduces TLB misses for randomly accessed hash tables. The elements are
+   * not initialized.
+   */
+  template <typename T>
+  class AlignedBuffer {
+    static_assert(std::is_trivial_v<T>, "AlignedBuffer does not construct its elements.");
+
+   public:
+    constexpr static size_t cache_line_alignment = 64;
+    constexpr static size_t huge_page_alignment = size_t{2} << 20;
+
+   private:
+    T *m_data = nullptr;
+    size_t m_count = 0;
+
+   public:
+    AlignedBuffer() noexcept = default;
+
+    explicit AlignedBuffer(size_t p_count, bool p_huge_pages = false) : m_count(p_count) {
+      size_t const alignment = p_huge_pages ? huge_page_alignment : cache_line_alignment;
+      // aligned_alloc requires the size to be a multiple of the alignment.
+      size_t const bytes = (((p_count * sizeof(T)) + alignment - 1) / alignment) * alignment;
+      if (bytes == 0) {
+        return;
+      }
+      m_data = static_cast<T *>(std::aligned_alloc(alignment, bytes));
+      if (m_data == nullptr) {
+        throw std::bad_alloc();
+      }
+#ifdef __linux__
+      if (p_huge_pages) {
+        // Only an advice, the memory is usable without huge pages as well.
+        madvise(m_data, bytes, MADV_HUGEPAGE);
+      }
+#endif
+    }
+
+    AlignedBuffer(AlignedBuffer const &) = delete;
+    AlignedBuffer &operator=(AlignedBuffer const &) = delete;
+
+    AlignedBuffer(AlignedBuffer &&other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)), m_count(std::exchange(other.m_count, 0)) {}
+
+    AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+      if (this != &other) {
+        std::free(m_data);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_count = std::exchange(other.m_count, 0);
+      }
+      return *this;
+    }
+
+    ~AlignedBuffer() noexcept { std::free(m_data); }
+
+    auto data() const noexcept -> T * { return m_data; }
+    auto size() const noexcept -> size_t { return m_count; }
+    auto operator[](size_t i) const noexcept -> T & { return m_data[i]; }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_DATASTRUCTURES_ALIGNED_BUFFER_HPP
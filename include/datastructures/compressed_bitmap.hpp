@@ -0,0 +1,620 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file compressed_bitmap.hpp
+ * @brief Defines the CompressedBitmap class, a Roaring-style compressed selection format.
+ */
+
+#ifndef SIMDOPS_INCLUDE_DATASTRUCTURES_COMPRESSED_BITMAP_HPP
+#define SIMDOPS_INCLUDE_DATASTRUCTURES_COMPRESSED_BITMAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @class CompressedBitmap
+   * @brief A compressed selection bitmap with array, bitmap and run containers.
+   * @details The position space is split into chunks of 2^16 positions. Every non-empty chunk is stored in the
+   * smallest of three representations: a sorted array of 16-bit offsets (sparse chunks), an uncompressed bitmap of
+   * 1024 64-bit words (dense chunks) or a list of runs (clustered chunks). Set operations are performed chunk-wise;
+   * bitmap/bitmap combinations and array/array intersections, differences and unions are SIMDified.
+   *
+   * @tparam _SimdStyle The TSL processing style. Only the target extension is used, words are processed as uint64_t
+   * and array containers as uint16_t.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, typename Idof = tsl::workaround>
+  class CompressedBitmap {
+   public:
+    using SimdStyle = _SimdStyle;
+    using PositionType = size_t;
+    using WordType = uint64_t;
+    using OffsetType = uint16_t;
+
+    enum class container_kind : uint8_t { array, bitmap, run };
+
+    struct run_t {
+      OffsetType start;
+      OffsetType length; /**< Number of positions in the run minus one. */
+    };
+
+    constexpr static size_t chunk_bits = 16;
+    constexpr static size_t chunk_size = size_t{1} << chunk_bits;
+    constexpr static size_t bits_per_word = sizeof(WordType) * CHAR_BIT;
+    constexpr static size_t words_per_chunk = chunk_size / bits_per_word;
+    /**< Above this cardinality a bitmap container is smaller than an array container. */
+    constexpr static size_t array_max_cardinality = (words_per_chunk * sizeof(WordType)) / sizeof(OffsetType);
+
+    struct container_t {
+      size_t key;
+      container_kind kind;
+      size_t cardinality;
+      std::vector<OffsetType> array;
+      std::vector<WordType> words;
+      std::vector<run_t> runs;
+
+      auto size_in_bytes() const noexcept -> size_t {
+        return array.size() * sizeof(OffsetType) + words.size() * sizeof(WordType) + runs.size() * sizeof(run_t);
+      }
+    };
+
+   private:
+    using WordSimdStyle = typename SimdStyle::template transform_extension<WordType>;
+    using OffsetSimdStyle = typename SimdStyle::template transform_extension<OffsetType>;
+
+    std::vector<container_t> m_containers;
+
+   public:
+    explicit CompressedBitmap() = default;
+    CompressedBitmap(CompressedBitmap const &) = default;
+    CompressedBitmap(CompressedBitmap &&) noexcept = default;
+    CompressedBitmap &operator=(CompressedBitmap const &) = default;
+    CompressedBitmap &operator=(CompressedBitmap &&) noexcept = default;
+    ~CompressedBitmap() = default;
+
+   public:
+    auto containers() const noexcept -> std::vector<container_t> const & { return m_containers; }
+    auto empty() const noexcept -> bool { return m_containers.empty(); }
+
+    auto cardinality() const noexcept -> size_t {
+      size_t result = 0;
+      for (auto const &container : m_containers) {
+        result += container.cardinality;
+      }
+      return result;
+    }
+
+    auto size_in_bytes() const noexcept -> size_t {
+      size_t result = 0;
+      for (auto const &container : m_containers) {
+        result += sizeof(container_t) + container.size_in_bytes();
+      }
+      return result;
+    }
+
+    auto contains(PositionType position) const noexcept -> bool {
+      auto const key = position >> chunk_bits;
+      auto const it = std::lower_bound(m_containers.cbegin(), m_containers.cend(), key,
+                                       [](container_t const &c, size_t k) { return c.key < k; });
+      if ((it == m_containers.cend()) || (it->key != key)) {
+        return false;
+      }
+      return contains(*it, static_cast<OffsetType>(position & (chunk_size - 1)));
+    }
+
+   public:
+    /**
+     * @brief Builds a compressed bitmap from the output of a filter operator.
+     * @details Depending on HintSet, the masks are interpreted as bit_mask (one imask per register, holding
+     * FilterSimdStyle::vector_element_count() valid bits) or dense_bit_mask (every bit of an imask is valid).
+     *
+     * @tparam FilterSimdStyle The processing style the filter was instantiated with.
+     * @tparam HintSet The hint set the filter was instantiated with.
+     * @param p_valid_masks The masks written by the filter.
+     * @param p_element_count The number of elements the filter was applied to.
+     * @param p_start_position The position of the first element (for partitioned filters).
+     */
+    template <tsl::VectorProcessingStyle FilterSimdStyle, class HintSet>
+    static auto from_filter_result(SimdOpsIterable auto p_valid_masks, size_t p_element_count,
+                                   PositionType p_start_position = 0) -> CompressedBitmap {
+      static_assert(has_any_hint<HintSet, hints::intermediate::bit_mask, hints::intermediate::dense_bit_mask>,
+                    "A compressed bitmap can only be built from a bit_mask or dense_bit_mask.");
+      using imask_type = typename FilterSimdStyle::imask_type;
+      constexpr size_t bits_per_mask = has_hint<HintSet, hints::intermediate::dense_bit_mask>
+                                         ? sizeof(imask_type) * CHAR_BIT
+                                         : FilterSimdStyle::vector_element_count();
+      static_assert((bits_per_word % bits_per_mask) == 0, "Mask granularity has to divide the word size.");
+
+      auto masks = reinterpret_iterable<imask_type const *>(p_valid_masks);
+      CompressedBitmap result;
+      std::vector<WordType> words(words_per_chunk, 0);
+      size_t current_key = p_start_position >> chunk_bits;
+      auto const mask_count = (p_element_count + bits_per_mask - 1) / bits_per_mask;
+      for (size_t m = 0; m < mask_count; ++m) {
+        auto mask = static_cast<WordType>(masks[m]);
+        if constexpr (bits_per_mask < bits_per_word) {
+          mask &= (WordType{1} << bits_per_mask) - 1;
+        }
+        auto const remaining = p_element_count - m * bits_per_mask;
+        if (remaining < bits_per_mask) {
+          mask &= (WordType{1} << remaining) - 1;
+        }
+        // An unaligned start position may spread a mask over two words or even two chunks.
+        auto position = p_start_position + m * bits_per_mask;
+        while (mask != 0) {
+          auto const key = position >> chunk_bits;
+          if (key != current_key) {
+            result.append_from_words(current_key, words.data());
+            std::fill(words.begin(), words.end(), 0);
+            current_key = key;
+          }
+          auto const offset = position & (chunk_size - 1);
+          auto const shift = offset % bits_per_word;
+          words[offset / bits_per_word] |= mask << shift;
+          auto const consumed = bits_per_word - shift;
+          mask = (consumed >= bits_per_word) ? 0 : (mask >> consumed);
+          position += consumed;
+        }
+      }
+      result.append_from_words(current_key, words.data());
+      return result;
+    }
+
+    /**
+     * @brief Builds a compressed bitmap from a sorted list of positions.
+     */
+    static auto from_positions(SimdOpsIterable auto p_positions, SimdOpsIterableOrSizeT auto p_end)
+      -> CompressedBitmap {
+      auto const end = iter_end(p_positions, p_end);
+      CompressedBitmap result;
+      while (p_positions != end) {
+        auto const key = static_cast<size_t>(*p_positions) >> chunk_bits;
+        container_t container{key, container_kind::array, 0, {}, {}, {}};
+        for (; (p_positions != end) && ((static_cast<size_t>(*p_positions) >> chunk_bits) == key); ++p_positions) {
+          container.array.push_back(static_cast<OffsetType>(*p_positions & (chunk_size - 1)));
+        }
+        container.cardinality = container.array.size();
+        result.m_containers.push_back(std::move(container));
+        optimize(result.m_containers.back());
+      }
+      return result;
+    }
+
+   public:
+    /**
+     * @brief Writes all set positions in ascending order.
+     * @return The end of the written positions.
+     */
+    auto decode(SimdOpsIterable auto p_result) const noexcept {
+      for_each_batch([&p_result](PositionType const *positions, size_t count) {
+        for (size_t i = 0; i < count; ++i, ++p_result) {
+          *p_result = positions[i];
+        }
+      });
+      return p_result;
+    }
+
+    /**
+     * @brief Writes the selection as dense bitmask words, e.g. as input for operators that support dense_bit_mask.
+     * @param p_result Sink for ceil(p_element_count / bits per word) words, which is zeroed first.
+     */
+    template <typename MaskType = WordType>
+    auto to_dense_bit_mask(MaskType *p_result, size_t p_element_count) const noexcept -> void {
+      constexpr size_t bits_per_mask = sizeof(MaskType) * CHAR_BIT;
+      std::fill(p_result, p_result + (p_element_count + bits_per_mask - 1) / bits_per_mask, MaskType{0});
+      for_each_batch([p_result, p_element_count](PositionType const *positions, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+          if (positions[i] < p_element_count) {
+            p_result[positions[i] / bits_per_mask] |= MaskType{1} << (positions[i] % bits_per_mask);
+          }
+        }
+      });
+    }
+
+    /**
+     * @brief Calls fun(PositionType const *positions, size_t count) for consecutive batches of ascending positions.
+     * @details This is the interface used by Materialize and the grouping builders to consume the selection without
+     * decoding it completely.
+     */
+    template <class Fun>
+    auto for_each_batch(Fun &&fun) const -> void {
+      alignas(64) std::array<PositionType, 1024> buffer;
+      size_t fill = 0;
+      auto emit = [&](PositionType position) {
+        buffer[fill++] = position;
+        if (fill == buffer.size()) {
+          fun(static_cast<PositionType const *>(buffer.data()), fill);
+          fill = 0;
+        }
+      };
+      for (auto const &container : m_containers) {
+        auto const base = container.key << chunk_bits;
+        switch (container.kind) {
+          case container_kind::array:
+            for (auto const offset : container.array) {
+              emit(base + offset);
+            }
+            break;
+          case container_kind::bitmap:
+            for (size_t w = 0; w < words_per_chunk; ++w) {
+              for (auto word = container.words[w]; word != 0; word &= word - 1) {
+                emit(base + w * bits_per_word + std::countr_zero(word));
+              }
+            }
+            break;
+          case container_kind::run:
+            for (auto const &run : container.runs) {
+              for (size_t i = 0; i <= run.length; ++i) {
+                emit(base + run.start + i);
+              }
+            }
+            break;
+        }
+      }
+      if (fill != 0) {
+        fun(static_cast<PositionType const *>(buffer.data()), fill);
+      }
+    }
+
+   public:
+    auto set_intersection(CompressedBitmap const &other) const -> CompressedBitmap {
+      CompressedBitmap result;
+      auto left = m_containers.cbegin();
+      auto right = other.m_containers.cbegin();
+      while ((left != m_containers.cend()) && (right != other.m_containers.cend())) {
+        if (left->key < right->key) {
+          ++left;
+        } else if (right->key < left->key) {
+          ++right;
+        } else {
+          result.push_if_not_empty(intersect(*left, *right));
+          ++left;
+          ++right;
+        }
+      }
+      return result;
+    }
+
+    auto set_union(CompressedBitmap const &other) const -> CompressedBitmap {
+      CompressedBitmap result;
+      auto left = m_containers.cbegin();
+      auto right = other.m_containers.cbegin();
+      while ((left != m_containers.cend()) || (right != other.m_containers.cend())) {
+        if ((right == other.m_containers.cend()) || ((left != m_containers.cend()) && (left->key < right->key))) {
+          result.m_containers.push_back(*left++);
+        } else if ((left == m_containers.cend()) || (right->key < left->key)) {
+          result.m_containers.push_back(*right++);
+        } else {
+          result.push_if_not_empty(unite(*left, *right));
+          ++left;
+          ++right;
+        }
+      }
+      return result;
+    }
+
+    auto set_difference(CompressedBitmap const &other) const -> CompressedBitmap {
+      CompressedBitmap result;
+      auto right = other.m_containers.cbegin();
+      for (auto left = m_containers.cbegin(); left != m_containers.cend(); ++left) {
+        while ((right != other.m_containers.cend()) && (right->key < left->key)) {
+          ++right;
+        }
+        if ((right == other.m_containers.cend()) || (right->key != left->key)) {
+          result.m_containers.push_back(*left);
+        } else {
+          result.push_if_not_empty(subtract(*left, *right));
+        }
+      }
+      return result;
+    }
+
+   private:
+    auto push_if_not_empty(container_t &&container) -> void {
+      if (container.cardinality != 0) {
+        m_containers.push_back(std::move(container));
+      }
+    }
+
+    auto append_from_words(size_t key, WordType const *words) -> void {
+      container_t container{key, container_kind::bitmap, 0, {}, std::vector<WordType>(words, words + words_per_chunk),
+                            {}};
+      container.cardinality = bitmap_cardinality(container.words.data());
+      if (container.cardinality == 0) {
+        return;
+      }
+      // Filters over consecutive partitions may produce the same chunk twice.
+      if (!m_containers.empty() && (m_containers.back().key == key)) {
+        m_containers.back() = unite(m_containers.back(), container);
+        return;
+      }
+      optimize(container);
+      m_containers.push_back(std::move(container));
+    }
+
+    static auto contains(container_t const &container, OffsetType offset) noexcept -> bool {
+      switch (container.kind) {
+        case container_kind::array:
+          return std::binary_search(container.array.cbegin(), container.array.cend(), offset);
+        case container_kind::bitmap:
+          return (container.words[offset / bits_per_word] >> (offset % bits_per_word)) & 1;
+        case container_kind::run: {
+          auto it = std::upper_bound(container.runs.cbegin(), container.runs.cend(), offset,
+                                     [](OffsetType o, run_t const &r) { return o < r.start; });
+          if (it == container.runs.cbegin()) {
+            return false;
+          }
+          --it;
+          return offset <= static_cast<size_t>(it->start) + it->length;
+        }
+      }
+      return false;
+    }
+
+    static auto bitmap_cardinality(WordType const *words) noexcept -> size_t {
+      size_t result = 0;
+      for (size_t i = 0; i < words_per_chunk; ++i) {
+        result += std::popcount(words[i]);
+      }
+      return result;
+    }
+
+    static auto run_count(WordType const *words) noexcept -> size_t {
+      size_t result = 0;
+      WordType carry = 0;
+      for (size_t i = 0; i < words_per_chunk; ++i) {
+        // A run starts at every set bit whose predecessor is not set.
+        result += std::popcount(words[i] & ~((words[i] << 1) | carry));
+        carry = words[i] >> (bits_per_word - 1);
+      }
+      return result;
+    }
+
+    static auto to_words(container_t const &container, WordType *words) noexcept -> void {
+      switch (container.kind) {
+        case container_kind::bitmap:
+          std::copy(container.words.cbegin(), container.words.cend(), words);
+          return;
+        case container_kind::array:
+          std::fill(words, words + words_per_chunk, 0);
+          for (auto const offset : container.array) {
+            words[offset / bits_per_word] |= WordType{1} << (offset % bits_per_word);
+          }
+          return;
+        case container_kind::run:
+          std::fill(words, words + words_per_chunk, 0);
+          for (auto const &run : container.runs) {
+            for (size_t i = run.start; i <= static_cast<size_t>(run.start) + run.length; ++i) {
+              words[i / bits_per_word] |= WordType{1} << (i % bits_per_word);
+            }
+          }
+          return;
+      }
+    }
+
+    /**
+     * @brief Converts the container into the representation with the smallest memory footprint.
+     */
+    static auto optimize(container_t &container) -> void {
+      std::vector<WordType> words(words_per_chunk);
+      to_words(container, words.data());
+      auto const runs = run_count(words.data());
+      auto const array_bytes = container.cardinality * sizeof(OffsetType);
+      auto const bitmap_bytes = words_per_chunk * sizeof(WordType);
+      auto const run_bytes = runs * sizeof(run_t);
+
+      container.array.clear();
+      container.runs.clear();
+      container.words.clear();
+      if ((run_bytes < array_bytes) && (run_bytes < bitmap_bytes)) {
+        container.kind = container_kind::run;
+        container.runs.reserve(runs);
+        size_t i = 0;
+        while (i < chunk_size) {
+          auto const word = words[i / bits_per_word] >> (i % bits_per_word);
+          if (word == 0) {
+            i += bits_per_word - (i % bits_per_word);
+            continue;
+          }
+          i += std::countr_zero(word);
+          auto const start = i;
+          while ((i < chunk_size) && ((words[i / bits_per_word] >> (i % bits_per_word)) & 1)) {
+            auto const ones = std::countr_one(words[i / bits_per_word] >> (i % bits_per_word));
+            i += std::min<size_t>(ones, bits_per_word - (i % bits_per_word));
+          }
+          container.runs.push_back(run_t{static_cast<OffsetType>(start), static_cast<OffsetType>(i - start - 1)});
+        }
+      } else if (container.cardinality <= array_max_cardinality) {
+        container.kind = container_kind::array;
+        container.array.reserve(container.cardinality);
+        for (size_t w = 0; w < words_per_chunk; ++w) {
+          for (auto word = words[w]; word != 0; word &= word - 1) {
+            container.array.push_back(static_cast<OffsetType>(w * bits_per_word + std::countr_zero(word)));
+          }
+        }
+      } else {
+        container.kind = container_kind::bitmap;
+        container.words = std::move(words);
+      }
+    }
+
+    /**
+     * @brief Combines two bitmap word arrays with a SIMD binary operation.
+     */
+    template <class BinaryOp>
+    static auto combine_words(WordType *result, WordType const *left, WordType const *right,
+                              BinaryOp &&op) noexcept -> void {
+      static_assert((words_per_chunk % WordSimdStyle::vector_element_count()) == 0);
+      for (size_t i = 0; i < words_per_chunk; i += WordSimdStyle::vector_element_count()) {
+        auto const left_reg = tsl::loadu<WordSimdStyle, Idof>(left + i);
+        auto const right_reg = tsl::loadu<WordSimdStyle, Idof>(right + i);
+        tsl::storeu<WordSimdStyle, Idof>(result + i, op(left_reg, right_reg));
+      }
+    }
+
+    static auto from_combined_words(size_t key, std::vector<WordType> &&words) -> container_t {
+      container_t result{key, container_kind::bitmap, 0, {}, std::move(words), {}};
+      result.cardinality = bitmap_cardinality(result.words.data());
+      if (result.cardinality != 0) {
+        optimize(result);
+      }
+      return result;
+    }
+
+    /**
+     * @brief SIMD block-wise intersection / difference of two sorted offset arrays.
+     * @details A register of left values is compared against a register of right values by broadcasting every right
+     * value. The match mask of the current left block is accumulated until the left block is exhausted, afterwards the
+     * left values are emitted (matches for an intersection, non-matches for a difference).
+     */
+    template <bool KeepMatches>
+    static auto simd_array_merge(std::vector<OffsetType> const &left,
+                                 std::vector<OffsetType> const &right) -> std::vector<OffsetType> {
+      constexpr size_t N = OffsetSimdStyle::vector_element_count();
+      std::vector<OffsetType> result;
+      result.reserve(KeepMatches ? std::min(left.size(), right.size()) : left.size());
+      size_t l = 0;
+      size_t r = 0;
+      typename OffsetSimdStyle::imask_type found = 0;
+      if constexpr (N > 1) {
+        while ((l + N <= left.size()) && (r + N <= right.size())) {
+          auto const left_reg = tsl::loadu<OffsetSimdStyle, Idof>(left.data() + l);
+          for (size_t j = 0; j < N; ++j) {
+            auto const right_reg = tsl::set1<OffsetSimdStyle, Idof>(right[r + j]);
+            found = tsl::mask_binary_or<OffsetSimdStyle, Idof>(
+              found, tsl::equal_as_imask<OffsetSimdStyle, Idof>(left_reg, right_reg));
+          }
+          auto const left_max = left[l + N - 1];
+          auto const right_max = right[r + N - 1];
+          if (left_max <= right_max) {
+            for (size_t i = 0; i < N; ++i) {
+              if (tsl::test_mask<OffsetSimdStyle, Idof>(found, i) == KeepMatches) {
+                result.push_back(left[l + i]);
+              }
+            }
+            l += N;
+            found = 0;
+          }
+          if (right_max <= left_max) {
+            r += N;
+          }
+        }
+      }
+      // Scalar remainder. Elements of the current left block may already have been matched by skipped right blocks.
+      for (size_t i = 0; l < left.size(); ++l, ++i) {
+        while ((r < right.size()) && (right[r] < left[l])) {
+          ++r;
+        }
+        bool const matched =
+          ((i < N) && tsl::test_mask<OffsetSimdStyle, Idof>(found, i)) || ((r < right.size()) && (right[r] == left[l]));
+        if (matched == KeepMatches) {
+          result.push_back(left[l]);
+        }
+      }
+      return result;
+    }
+
+    static auto from_array(size_t key, std::vector<OffsetType> &&array) -> container_t {
+      container_t result{key, container_kind::array, array.size(), std::move(array), {}, {}};
+      if (result.cardinality != 0) {
+        optimize(result);
+      }
+      return result;
+    }
+
+    template <bool KeepMatches>
+    static auto filter_array(container_t const &array_container, container_t const &other) -> container_t {
+      std::vector<WordType> words(words_per_chunk);
+      to_words(other, words.data());
+      std::vector<OffsetType> result;
+      for (auto const offset : array_container.array) {
+        if ((((words[offset / bits_per_word] >> (offset % bits_per_word)) & 1) != 0) == KeepMatches) {
+          result.push_back(offset);
+        }
+      }
+      return from_array(array_container.key, std::move(result));
+    }
+
+    static auto intersect(container_t const &left, container_t const &right) -> container_t {
+      if ((left.kind == container_kind::array) && (right.kind == container_kind::array)) {
+        return from_array(left.key, simd_array_merge<true>(left.array, right.array));
+      } else if (left.kind == container_kind::array) {
+        return filter_array<true>(left, right);
+      } else if (right.kind == container_kind::array) {
+        return filter_array<true>(right, left);
+      }
+      std::vector<WordType> left_words(words_per_chunk);
+      std::vector<WordType> right_words(words_per_chunk);
+      to_words(left, left_words.data());
+      to_words(right, right_words.data());
+      combine_words(left_words.data(), left_words.data(), right_words.data(),
+                    [](auto a, auto b) { return tsl::binary_and<WordSimdStyle, Idof>(a, b); });
+      return from_combined_words(left.key, std::move(left_words));
+    }
+
+    static auto unite(container_t const &left, container_t const &right) -> container_t {
+      if ((left.kind == container_kind::array) && (right.kind == container_kind::array) &&
+          (left.cardinality + right.cardinality <= array_max_cardinality)) {
+        // The duplicates are removed with the SIMD difference, merging the disjoint arrays is branch-free.
+        auto const right_only = simd_array_merge<false>(right.array, left.array);
+        std::vector<OffsetType> result(left.array.size() + right_only.size());
+        std::merge(left.array.cbegin(), left.array.cend(), right_only.cbegin(), right_only.cend(), result.begin());
+        return from_array(left.key, std::move(result));
+      }
+      std::vector<WordType> left_words(words_per_chunk);
+      std::vector<WordType> right_words(words_per_chunk);
+      to_words(left, left_words.data());
+      to_words(right, right_words.data());
+      combine_words(left_words.data(), left_words.data(), right_words.data(),
+                    [](auto a, auto b) { return tsl::binary_or<WordSimdStyle, Idof>(a, b); });
+      return from_combined_words(left.key, std::move(left_words));
+    }
+
+    static auto subtract(container_t const &left, container_t const &right) -> container_t {
+      if ((left.kind == container_kind::array) && (right.kind == container_kind::array)) {
+        return from_array(left.key, simd_array_merge<false>(left.array, right.array));
+      } else if (left.kind == container_kind::array) {
+        return filter_array<false>(left, right);
+      }
+      std::vector<WordType> left_words(words_per_chunk);
+      std::vector<WordType> right_words(words_per_chunk);
+      to_words(left, left_words.data());
+      to_words(right, right_words.data());
+      combine_words(left_words.data(), left_words.data(), right_words.data(), [](auto a, auto b) {
+        return tsl::binary_and<WordSimdStyle, Idof>(a, tsl::binary_not<WordSimdStyle, Idof>(b));
+      });
+      return from_combined_words(left.key, std::move(left_words));
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_DATASTRUCTURES_COMPRESSED_BITMAP_HPP
@@ -0,0 +1,257 @@
+// ------------------------------------------------------------------- //
+/*
+   This file is part of the SimdOperators Project.
+   Author(s): Johannes Pietrzyk.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, version 3.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+// ------------------------------------------------------------------- //
+/**
+ * @file rank_select_index.hpp
+ * @brief Defines a succinct rank/select directory over filter bitmasks.
+ */
+
+#ifndef SIMDOPS_INCLUDE_DATASTRUCTURES_RANK_SELECT_INDEX_HPP
+#define SIMDOPS_INCLUDE_DATASTRUCTURES_RANK_SELECT_INDEX_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/utils/hinting.hpp"
+#include "iterable.hpp"
+#include "tsl.hpp"
+
+namespace tuddbs {
+
+  /**
+   * @class RankSelectIndex
+   * @brief Cumulative popcount directory over a bit_mask or dense_bit_mask.
+   * @details The bitmask is divided into blocks of 512 bits and superblocks of 2^16 bits. For every superblock the
+   * absolute number of set bits in front of it is stored (64 bit), for every block the number relative to its
+   * superblock (16 bit), which adds ~3% space. rank(i) adds both counters and popcounts at most one block.
+   * For every 4096th set bit, the block containing it is sampled. select(k) binary searches the block counters between
+   * the samples in front of and behind k and scans at most one block. If the set bits are dense, the samples are a few
+   * blocks apart and select is constant time, otherwise it is logarithmic in the number of blocks between two samples.
+   * The index does not own the bitmask, it has to outlive the index.
+   *
+   * @tparam _SimdStyle The processing style the filter was instantiated with.
+   * @tparam HintSet intermediate::bit_mask (one imask per register) or intermediate::dense_bit_mask.
+   */
+  template <tsl::VectorProcessingStyle _SimdStyle, class HintSet = OperatorHintSet<hints::intermediate::bit_mask>,
+            typename Idof = tsl::workaround>
+  class RankSelectIndex {
+    static_assert(has_any_hint<HintSet, hints::intermediate::bit_mask, hints::intermediate::dense_bit_mask>,
+                  "A rank/select index can only be built over a bit_mask or dense_bit_mask.");
+
+   public:
+    using SimdStyle = _SimdStyle;
+    using MaskType = typename SimdStyle::imask_type;
+    using UnsignedMaskType = std::make_unsigned_t<MaskType>;
+
+    constexpr static size_t bits_per_mask = has_hint<HintSet, hints::intermediate::dense_bit_mask>
+                                              ? sizeof(MaskType) * CHAR_BIT
+                                              : SimdStyle::vector_element_count();
+    constexpr static size_t block_bits = std::max<size_t>(512, bits_per_mask);
+    constexpr static size_t masks_per_block = block_bits / bits_per_mask;
+    constexpr static size_t superblock_bits = size_t{1} << 16;
+    constexpr static size_t blocks_per_superblock = superblock_bits / block_bits;
+    constexpr static size_t select_sample_rate = 4096;
+    static_assert((block_bits % bits_per_mask) == 0, "Mask granularity has to divide the block size.");
+
+    /**
+     * @brief A range of rows [begin, end) whose selected elements are written to [output_offset, output_offset +
+     * output_count). Begin and end are aligned to mask boundaries, thus a partition can be handed to Materialize as
+     * (p_data + begin, end - begin, p_masks + begin / bits_per_mask).
+     */
+    struct partition_t {
+      size_t begin;
+      size_t end;
+      size_t output_offset;
+      size_t output_count;
+    };
+
+   private:
+    MaskType const *m_masks;
+    size_t m_element_count;
+    size_t m_mask_count;
+    size_t m_set_bit_count;
+    std::vector<uint64_t> m_superblock_ranks;
+    std::vector<uint16_t> m_block_ranks;
+    std::vector<uint32_t> m_select_samples;
+
+   private:
+    /**
+     * @brief Number of set bits in front of a block.
+     */
+    TSL_FORCE_INLINE auto block_rank(size_t p_block) const noexcept -> size_t {
+      return m_superblock_ranks[p_block / blocks_per_superblock] + m_block_ranks[p_block];
+    }
+
+    TSL_FORCE_INLINE auto mask_at(size_t i) const noexcept -> UnsignedMaskType {
+      auto mask = static_cast<UnsignedMaskType>(m_masks[i]);
+      if constexpr (bits_per_mask < sizeof(MaskType) * CHAR_BIT) {
+        mask &= static_cast<UnsignedMaskType>((UnsignedMaskType{1} << bits_per_mask) - 1);
+      }
+      if ((i == m_mask_count - 1) && ((m_element_count % bits_per_mask) != 0)) {
+        mask &= static_cast<UnsignedMaskType>((UnsignedMaskType{1} << (m_element_count % bits_per_mask)) - 1);
+      }
+      return mask;
+    }
+
+   public:
+    /**
+     * @brief Builds the directory in a single popcount pass over the bitmask.
+     *
+     * @param p_masks The masks written by the filter.
+     * @param p_element_count The number of elements the filter was applied to.
+     */
+    explicit RankSelectIndex(SimdOpsIterable auto p_masks, size_t p_element_count)
+      : m_masks(reinterpret_iterable<MaskType const *>(p_masks)),
+        m_element_count(p_element_count),
+        m_mask_count((p_element_count + bits_per_mask - 1) / bits_per_mask),
+        m_set_bit_count(0) {
+      auto const block_count = (m_mask_count + masks_per_block - 1) / masks_per_block;
+      auto const superblock_count = (block_count + blocks_per_superblock - 1) / blocks_per_superblock;
+      m_superblock_ranks.resize(superblock_count + 1);
+      m_block_ranks.resize(block_count + 1);
+
+      m_select_samples.reserve(m_element_count / select_sample_rate + 2);
+      size_t total = 0;
+      size_t superblock_start = 0;
+      size_t next_sample = 0;
+      for (size_t block = 0; block < block_count; ++block) {
+        if ((block % blocks_per_superblock) == 0) {
+          m_superblock_ranks[block / blocks_per_superblock] = total;
+          superblock_start = total;
+        }
+        m_block_ranks[block] = static_cast<uint16_t>(total - superblock_start);
+        auto const mask_end = std::min(m_mask_count, (block + 1) * masks_per_block);
+        for (size_t m = block * masks_per_block; m < mask_end; ++m) {
+          total += std::popcount(mask_at(m));
+        }
+        for (; next_sample < total; next_sample += select_sample_rate) {
+          m_select_samples.push_back(static_cast<uint32_t>(block));
+        }
+      }
+      m_superblock_ranks[superblock_count] = total;
+      m_block_ranks[block_count] = 0;
+      m_set_bit_count = total;
+      // Bounds the search for the set bits behind the last sample.
+      m_select_samples.push_back(static_cast<uint32_t>(block_count == 0 ? 0 : block_count - 1));
+    }
+
+    ~RankSelectIndex() = default;
+
+   public:
+    auto count() const noexcept -> size_t { return m_set_bit_count; }
+    auto element_count() const noexcept -> size_t { return m_element_count; }
+
+    auto size_in_bytes() const noexcept -> size_t {
+      return m_superblock_ranks.size() * sizeof(uint64_t) + m_block_ranks.size() * sizeof(uint16_t) +
+             m_select_samples.size() * sizeof(uint32_t);
+    }
+
+    /**
+     * @brief Number of set bits in [0, p_position).
+     */
+    auto rank(size_t p_position) const noexcept -> size_t {
+      assert(p_position <= m_element_count);
+      if (p_position == m_element_count) {
+        return m_set_bit_count;
+      }
+      auto const block = p_position / block_bits;
+      size_t result = m_superblock_ranks[block / blocks_per_superblock] + m_block_ranks[block];
+      auto const target_mask = p_position / bits_per_mask;
+      for (size_t m = block * masks_per_block; m < target_mask; ++m) {
+        result += std::popcount(mask_at(m));
+      }
+      if (auto const bit = p_position % bits_per_mask; bit != 0) {
+        result += std::popcount(static_cast<UnsignedMaskType>(
+          mask_at(target_mask) & static_cast<UnsignedMaskType>((UnsignedMaskType{1} << bit) - 1)));
+      }
+      return result;
+    }
+
+    /**
+     * @brief Position of the set bit with rank p_k (0-based), i.e. the p_k-th qualifying row.
+     * @return The position or element_count() if p_k >= count().
+     */
+    auto select(size_t p_k) const noexcept -> size_t {
+      if (p_k >= m_set_bit_count) {
+        return m_element_count;
+      }
+      // The set bit lies between the blocks of the samples in front of and behind it. Search the last block whose rank
+      // is <= p_k.
+      size_t block = m_select_samples[p_k / select_sample_rate];
+      size_t last_block = m_select_samples[p_k / select_sample_rate + 1];
+      while (block < last_block) {
+        auto const middle = block + (last_block - block + 1) / 2;
+        if (block_rank(middle) <= p_k) {
+          block = middle;
+        } else {
+          last_block = middle - 1;
+        }
+      }
+      size_t remaining = p_k - block_rank(block);
+
+      for (size_t m = block * masks_per_block;; ++m) {
+        auto mask = mask_at(m);
+        auto const population = static_cast<size_t>(std::popcount(mask));
+        if (remaining < population) {
+          for (; remaining != 0; --remaining) {
+            mask &= static_cast<UnsignedMaskType>(mask - 1);
+          }
+          return m * bits_per_mask + std::countr_zero(mask);
+        }
+        remaining -= population;
+      }
+    }
+
+    /**
+     * @brief Splits the bitmask into p_partition_count ranges with (nearly) the same number of selected rows.
+     * @details The boundaries are the selected rows with rank j * count() / p_partition_count, rounded down to a mask
+     * boundary. Thus every partition produces the same amount of output (up to bits_per_mask rows), independently of
+     * the selectivity distribution. Partitions may be empty if there are less selected rows than partitions.
+     */
+    auto partition(size_t p_partition_count) const -> std::vector<partition_t> {
+      std::vector<partition_t> result;
+      if (p_partition_count == 0) {
+        return result;
+      }
+      result.reserve(p_partition_count);
+      size_t begin = 0;
+      size_t begin_rank = 0;
+      for (size_t j = 1; j <= p_partition_count; ++j) {
+        size_t end = m_element_count;
+        if (j != p_partition_count) {
+          end = std::max(begin, (select((j * m_set_bit_count) / p_partition_count) / bits_per_mask) * bits_per_mask);
+        }
+        auto const end_rank = rank(end);
+        result.push_back(partition_t{begin, end, begin_rank, end_rank - begin_rank});
+        begin = end;
+        begin_rank = end_rank;
+      }
+      return result;
+    }
+  };
+
+}  // namespace tuddbs
+
+#endif  // SIMDOPS_INCLUDE_DATASTRUCTURES_RANK_SELECT_INDEX_HPP
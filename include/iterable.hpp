@@ -35,6 +35,10 @@ namespace tuddbs {
   namespace hints {
     namespace memory {
       struct aligned {};
+      /**
+       * @brief Memory owned by an operator is aligned to 2 MiB and advised to be backed by transparent huge pages.
+       */
+      struct huge_pages {};
     }  // namespace memory
   }    // namespace hints
 
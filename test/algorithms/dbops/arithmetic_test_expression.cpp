@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/arithmetic/arithmetic_expression.hpp"
+
+template <typename T>
+bool approximate_equality(T a, T b) {
+  if constexpr (std::is_floating_point_v<T>) {
+    const T max_val = std::max(std::fabs(a), std::fabs(b));
+    const T max_mult = std::max(static_cast<T>(1.0), max_val);
+    const T ulps = 4 * std::numeric_limits<T>::epsilon() * max_mult;
+    return std::fabs(a - b) <= ulps;
+  } else {
+    return a == b;
+  }
+}
+
+template <typename T>
+bool compare(T const *result, std::vector<T> const &expected) {
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (!approximate_equality(result[i], expected[i])) {
+      std::cout << "Wrong value at index " << i << ". Is: " << +result[i] << " but should be: " << +expected[i]
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Evaluates price * (10 - discount) * (1 + tax), the shape of the TPC-H Q1 projection. */
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs::arithmetic_expression;
+  using T = typename SimdStyle::base_type;
+  using cpu_executor = tsl::executor<tsl::runtime::cpu>;
+  cpu_executor exec;
+  auto price = exec.allocate<T>(elements, 64);
+  auto discount = exec.allocate<T>(elements, 64);
+  auto tax = exec.allocate<T>(elements, 64);
+  auto result = exec.allocate<T>(elements, 64);
+
+  std::mt19937_64 mt(seed);
+  std::uniform_int_distribution<int> dist(0, 9);
+  std::bernoulli_distribution selected(0.3);
+  std::vector<T> expected_all(elements);
+  for (size_t i = 0; i < elements; ++i) {
+    price[i] = static_cast<T>(dist(mt) + 1);
+    discount[i] = static_cast<T>(dist(mt));
+    tax[i] = static_cast<T>(dist(mt) % 3);
+    expected_all[i] = static_cast<T>(price[i] * static_cast<T>(static_cast<T>(10) - discount[i]) *
+                                     static_cast<T>(static_cast<T>(1) + tax[i]));
+  }
+  auto const expression = col(price) * (lit(10) - col(discount)) * (lit(1) + col(tax));
+
+  tuddbs::ArithmeticExpression<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::position_list>>
+    position_evaluator;
+  auto end = position_evaluator(result, expression, elements);
+  REQUIRE(static_cast<size_t>(end - result) == elements);
+  REQUIRE(compare(result, expected_all));
+
+  std::vector<size_t> positions;
+  std::vector<T> expected_selected;
+  for (size_t i = 0; i < elements; ++i) {
+    if (selected(mt)) {
+      positions.push_back(i);
+      expected_selected.push_back(expected_all[i]);
+    }
+  }
+  std::reverse(positions.begin(), positions.end());
+  std::vector<T> expected_gathered(expected_selected.rbegin(), expected_selected.rend());
+  end = position_evaluator(result, expression, positions.data(), positions.size());
+  REQUIRE(static_cast<size_t>(end - result) == positions.size());
+  REQUIRE(compare(result, expected_gathered));
+
+  if constexpr (SimdStyle::vector_element_count() > 1) {
+    using imask_t = typename SimdStyle::imask_type;
+    constexpr size_t bits_per_mask = sizeof(imask_t) * CHAR_BIT;
+    std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+    std::vector<imask_t> dense_bit_mask(elements / bits_per_mask + 1, 0);
+    for (auto position : positions) {
+      bit_mask[position / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (position % SimdStyle::vector_element_count()));
+      dense_bit_mask[position / bits_per_mask] |= static_cast<imask_t>(imask_t{1} << (position % bits_per_mask));
+    }
+
+    tuddbs::ArithmeticExpression<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::bit_mask>>
+      bm_evaluator;
+    end = bm_evaluator(result, expression, elements, bit_mask.data());
+    REQUIRE(static_cast<size_t>(end - result) == expected_selected.size());
+    REQUIRE(compare(result, expected_selected));
+
+    tuddbs::ArithmeticExpression<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::dense_bit_mask>>
+      dbm_evaluator;
+    end = dbm_evaluator(result, expression, elements, dense_bit_mask.data());
+    REQUIRE(static_cast<size_t>(end - result) == expected_selected.size());
+    REQUIRE(compare(result, expected_selected));
+  }
+
+  exec.deallocate(result);
+  exec.deallocate(tax);
+  exec.deallocate(discount);
+  exec.deallocate(price);
+}
+
+/* Divides by a column whose rows that are not selected are 0, which must not trap for the masked selections. */
+template <class SimdStyle>
+void test_zero_divisor(const size_t elements, const size_t seed) {
+  using namespace tuddbs::arithmetic_expression;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  constexpr size_t bits_per_mask = sizeof(imask_t) * CHAR_BIT;
+  std::mt19937_64 mt(seed);
+  std::uniform_int_distribution<int> dist(1, 9);
+  std::bernoulli_distribution selected(0.3);
+  std::vector<T> price(elements);
+  std::vector<T> divisor(elements);
+  std::vector<T> result(elements);
+  std::vector<T> expected;
+  std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+  std::vector<imask_t> dense_bit_mask(elements / bits_per_mask + 1, 0);
+  for (size_t i = 0; i < elements; ++i) {
+    price[i] = static_cast<T>(dist(mt));
+    if (selected(mt)) {
+      divisor[i] = static_cast<T>(dist(mt));
+      expected.push_back(static_cast<T>(static_cast<T>(static_cast<T>(100) / divisor[i]) + price[i]));
+      bit_mask[i / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (i % SimdStyle::vector_element_count()));
+      dense_bit_mask[i / bits_per_mask] |= static_cast<imask_t>(imask_t{1} << (i % bits_per_mask));
+    } else {
+      divisor[i] = 0;
+    }
+  }
+  auto const expression = lit(100) / col(divisor.data()) + col(price.data());
+
+  tuddbs::ArithmeticExpression<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::bit_mask>> bm_evaluator;
+  auto end = bm_evaluator(result.data(), expression, elements, bit_mask.data());
+  REQUIRE(static_cast<size_t>(end - result.data()) == expected.size());
+  REQUIRE(compare(result.data(), expected));
+
+  tuddbs::ArithmeticExpression<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::dense_bit_mask>>
+    dbm_evaluator;
+  end = dbm_evaluator(result.data(), expression, elements, dense_bit_mask.data());
+  REQUIRE(static_cast<size_t>(end - result.data()) == expected.size());
+  REQUIRE(compare(result.data(), expected));
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{1024 * 1024 + 7}}) {
+    test<SimdStyle>(elements, seed);
+    if constexpr (SimdStyle::vector_element_count() > 1) {
+      test_zero_divisor<SimdStyle>(elements, seed);
+    }
+  }
+}
+
+TEMPLATE_TEST_CASE("Fused expression, scalar", "[scalar]", uint16_t, uint32_t, uint64_t, int32_t, int64_t, float,
+                   double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::scalar>>(); }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Fused expression, sse", "[sse]", uint16_t, uint32_t, uint64_t, int32_t, int64_t, float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Fused expression, avx2", "[avx2]", uint16_t, uint32_t, uint64_t, int32_t, int64_t, float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Fused expression, avx512", "[avx512]", uint16_t, uint32_t, uint64_t, int32_t, int64_t, float,
+                   double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
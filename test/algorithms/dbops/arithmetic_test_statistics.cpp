@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/arithmetic/arithmetic.hpp"
+
+template <typename T>
+bool equal_statistics(tuddbs::arithmetic_statistics_t<T> const &is, tuddbs::arithmetic_statistics_t<T> const &should) {
+  bool sum_equal;
+  if constexpr (std::is_floating_point_v<T>) {
+    sum_equal = std::fabs(is.sum - should.sum) <= 1e-3 * std::max(static_cast<T>(1), std::fabs(should.sum));
+  } else {
+    sum_equal = (is.sum == should.sum);
+  }
+  if (!sum_equal || (is.min != should.min) || (is.max != should.max) || (is.count != should.count)) {
+    std::cout << "Is: [" << +is.min << ", " << +is.max << ", " << +is.sum << ", " << is.count << "] but should be: ["
+              << +should.min << ", " << +should.max << ", " << +should.sum << ", " << should.count << "]" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  constexpr size_t bits_per_mask = sizeof(imask_t) * CHAR_BIT;
+
+  std::mt19937_64 mt(seed);
+  // Values are kept small, such that the sum does not overflow for narrow types.
+  std::uniform_int_distribution<int> dist(0, std::is_signed_v<T> ? 20 : 10);
+  std::bernoulli_distribution selected(0.25);
+
+  std::vector<T> data(elements);
+  std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+  std::vector<imask_t> dense_bit_mask(elements / bits_per_mask + 1, 0);
+  std::vector<size_t> positions;
+  arithmetic_statistics_t<T> expected_all{std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(), 0, 0};
+  arithmetic_statistics_t<T> expected_selected = expected_all;
+  auto update = [](arithmetic_statistics_t<T> &stats, T value) {
+    stats.min = std::min(stats.min, value);
+    stats.max = std::max(stats.max, value);
+    stats.sum += value;
+    ++stats.count;
+  };
+  for (size_t i = 0; i < elements; ++i) {
+    data[i] = static_cast<T>(dist(mt) - (std::is_signed_v<T> ? 10 : 0));
+    update(expected_all, data[i]);
+    if (selected(mt)) {
+      bit_mask[i / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (i % SimdStyle::vector_element_count()));
+      dense_bit_mask[i / bits_per_mask] |= static_cast<imask_t>(imask_t{1} << (i % bits_per_mask));
+      positions.push_back(i);
+      update(expected_selected, data[i]);
+    }
+  }
+
+  arithmetic_statistics_t<T> result;
+  col_stats_t<SimdStyle>{}(&result, data.data(), elements);
+  REQUIRE(equal_statistics(result, expected_all));
+  col_bm_stats_t<SimdStyle>{}(&result, data.data(), elements, bit_mask.data());
+  REQUIRE(equal_statistics(result, expected_selected));
+  Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::statistics, hints::intermediate::dense_bit_mask>>{}(
+    &result, data.data(), elements, dense_bit_mask.data());
+  REQUIRE(equal_statistics(result, expected_selected));
+  col_stats_t<SimdStyle>{}(&result, data.data(), positions.data(), positions.size());
+  REQUIRE(equal_statistics(result, expected_selected));
+
+  // Sums and averages over dense bitmasks and position lists.
+  auto const close_to = [](auto is, auto should) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return std::fabs(is - should) <= 1e-3 * std::max(1.0, std::fabs(static_cast<double>(should)));
+    } else {
+      return is == should;
+    }
+  };
+  using dense_sum_t =
+    Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::sum, hints::intermediate::dense_bit_mask>>;
+  using dense_avg_t =
+    Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::average, hints::intermediate::dense_bit_mask>>;
+  using positions_avg_t =
+    Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::average, hints::intermediate::position_list>>;
+  T sum;
+  double average;
+  dense_sum_t{}(&sum, data.data(), elements, dense_bit_mask.data());
+  REQUIRE(close_to(sum, expected_selected.sum));
+  col_sum_t<SimdStyle>{}(&sum, data.data(), positions.data(), positions.size());
+  REQUIRE(close_to(sum, expected_selected.sum));
+  if (expected_selected.count > 0) {
+    double const expected_average = static_cast<double>(expected_selected.sum) / expected_selected.count;
+    dense_avg_t{}(&average, data.data(), elements, dense_bit_mask.data());
+    REQUIRE(close_to(average, expected_average));
+    positions_avg_t{}(&average, data.data(), positions.data(), positions.size());
+    REQUIRE(close_to(average, expected_average));
+  }
+  // Every other mask word fully selected.
+  std::vector<imask_t> alternating_bit_mask(dense_bit_mask.size());
+  T expected_alternating_sum = 0;
+  for (size_t i = 0; i < alternating_bit_mask.size(); ++i) {
+    alternating_bit_mask[i] = (i % 2 == 0) ? static_cast<imask_t>(~imask_t{0}) : 0;
+  }
+  for (size_t i = 0; i < elements; ++i) {
+    if ((i / bits_per_mask) % 2 == 0) {
+      expected_alternating_sum += data[i];
+    }
+  }
+  dense_sum_t{}(&sum, data.data(), elements, alternating_bit_mask.data());
+  REQUIRE(close_to(sum, expected_alternating_sum));
+
+  T value;
+  size_t count;
+  col_min_t<SimdStyle>{}(&value, data.data(), elements);
+  REQUIRE(value == expected_all.min);
+  col_max_t<SimdStyle>{}(&value, data.data(), data.data() + elements);
+  REQUIRE(value == expected_all.max);
+  col_bm_min_t<SimdStyle>{}(&value, data.data(), elements, bit_mask.data());
+  REQUIRE(value == expected_selected.min);
+  col_bm_max_t<SimdStyle>{}(&value, data.data(), elements, bit_mask.data());
+  REQUIRE(value == expected_selected.max);
+  col_bm_count_t<SimdStyle>{}(&count, data.data(), elements, bit_mask.data());
+  REQUIRE(count == expected_selected.count);
+  col_count_t<SimdStyle>{}(&count, data.data(), elements);
+  REQUIRE(count == elements);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{1024 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Min/Max/Count/Statistics, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t, float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Min/Max/Count/Statistics, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t, float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Min/Max/Count/Statistics, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t, float,
+                   double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
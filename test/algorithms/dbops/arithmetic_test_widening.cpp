@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/arithmetic/arithmetic.hpp"
+
+template <class SimdStyle, typename AccumulatorType>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  using sum_t = Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::sum, hints::intermediate::position_list>,
+                           AccumulatorType>;
+  using bm_sum_t =
+    Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::sum, hints::intermediate::bit_mask>, AccumulatorType>;
+  using checked_sum_t = Arithmetic<
+    SimdStyle,
+    OperatorHintSet<hints::arithmetic::sum, hints::arithmetic::checked, hints::intermediate::position_list>,
+    AccumulatorType>;
+  using stats_t = Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::statistics, hints::arithmetic::checked,
+                                                        hints::intermediate::position_list>,
+                             AccumulatorType>;
+  using bm_stats_t =
+    Arithmetic<SimdStyle, OperatorHintSet<hints::arithmetic::statistics, hints::intermediate::bit_mask>,
+               AccumulatorType>;
+
+  std::mt19937_64 mt(seed);
+  // Values close to the limits of T, such that the sum overflows T after a few elements.
+  std::uniform_int_distribution<T> dist(std::numeric_limits<T>::max() - 1000, std::numeric_limits<T>::max());
+  std::bernoulli_distribution selected(0.5);
+  std::bernoulli_distribution negative(0.3);
+
+  std::vector<T> data(elements);
+  std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+  AccumulatorType expected_all = 0;
+  AccumulatorType expected_selected = 0;
+  size_t expected_selected_count = 0;
+  for (size_t i = 0; i < elements; ++i) {
+    data[i] = dist(mt);
+    if constexpr (std::is_signed_v<T>) {
+      if (negative(mt)) {
+        data[i] = static_cast<T>(-data[i]);
+      }
+    }
+    expected_all += static_cast<AccumulatorType>(data[i]);
+    if (selected(mt)) {
+      bit_mask[i / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (i % SimdStyle::vector_element_count()));
+      expected_selected += static_cast<AccumulatorType>(data[i]);
+      ++expected_selected_count;
+    }
+  }
+
+  AccumulatorType result = 0;
+  sum_t{}(&result, data.data(), elements);
+  REQUIRE(result == expected_all);
+  bm_sum_t{}(&result, data.data(), elements, bit_mask.data());
+  REQUIRE(result == expected_selected);
+  checked_sum_t{}(&result, data.data(), elements);
+  REQUIRE(result == expected_all);
+
+  // The sum of the statistics is accumulated like a sum.
+  arithmetic_statistics_t<T, AccumulatorType> statistics;
+  stats_t{}(&statistics, data.data(), elements);
+  REQUIRE(statistics.sum == expected_all);
+  REQUIRE(statistics.count == elements);
+  REQUIRE(statistics.min == *std::min_element(data.begin(), data.end()));
+  REQUIRE(statistics.max == *std::max_element(data.begin(), data.end()));
+  bm_stats_t{}(&statistics, data.data(), elements, bit_mask.data());
+  REQUIRE(statistics.sum == expected_selected);
+  REQUIRE(statistics.count == expected_selected_count);
+
+  if constexpr (std::is_unsigned_v<T>) {
+    // Accumulating in the base type itself has to report the overflow.
+    using narrow_checked_sum_t = Arithmetic<
+      SimdStyle,
+      OperatorHintSet<hints::arithmetic::sum, hints::arithmetic::checked, hints::intermediate::position_list>>;
+    T narrow_result = 0;
+    if (elements > 1) {
+      REQUIRE_THROWS_AS(narrow_checked_sum_t{}(&narrow_result, data.data(), elements), std::overflow_error);
+    }
+    using narrow_checked_stats_t = Arithmetic<
+      SimdStyle,
+      OperatorHintSet<hints::arithmetic::statistics, hints::arithmetic::checked, hints::intermediate::position_list>>;
+    arithmetic_statistics_t<T> narrow_statistics;
+    if (elements > 1) {
+      REQUIRE_THROWS_AS(narrow_checked_stats_t{}(&narrow_statistics, data.data(), elements), std::overflow_error);
+    }
+  }
+}
+
+template <class SimdStyle, typename AccumulatorType>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{1024 * 1024 + 3}}) {
+    test<SimdStyle, AccumulatorType>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEST_CASE("Widening sum, sse", "[sse]") {
+  dispatch_type<tsl::simd<uint32_t, tsl::sse>, uint64_t>();
+  dispatch_type<tsl::simd<int32_t, tsl::sse>, int64_t>();
+  dispatch_type<tsl::simd<uint64_t, tsl::sse>, unsigned __int128>();
+  dispatch_type<tsl::simd<int64_t, tsl::sse>, __int128>();
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEST_CASE("Widening sum, avx2", "[avx2]") {
+  dispatch_type<tsl::simd<uint32_t, tsl::avx2>, uint64_t>();
+  dispatch_type<tsl::simd<int32_t, tsl::avx2>, int64_t>();
+  dispatch_type<tsl::simd<uint64_t, tsl::avx2>, unsigned __int128>();
+  dispatch_type<tsl::simd<int64_t, tsl::avx2>, __int128>();
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEST_CASE("Widening sum, avx512", "[avx512]") {
+  dispatch_type<tsl::simd<uint32_t, tsl::avx512>, uint64_t>();
+  dispatch_type<tsl::simd<int32_t, tsl::avx512>, int64_t>();
+  dispatch_type<tsl::simd<uint64_t, tsl::avx512>, unsigned __int128>();
+  dispatch_type<tsl::simd<int64_t, tsl::avx512>, __int128>();
+}
+#endif
@@ -0,0 +1,129 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <bit>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/bitmask_expression/bitmask_expression.hpp"
+#include "algorithms/dbops/dbops_hints.hpp"
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace tuddbs::bitmask_expression;
+  using T = typename SimdStyle::base_type;
+  using U = std::make_unsigned_t<T>;
+  constexpr size_t bits_per_word = sizeof(T) * CHAR_BIT;
+  auto const word_count = (elements + bits_per_word - 1) / bits_per_word;
+
+  std::mt19937_64 mt(seed);
+  std::vector<std::vector<T>> inputs(4, std::vector<T>(word_count));
+  for (auto &input : inputs) {
+    for (auto &word : input) {
+      word = static_cast<T>(mt());
+    }
+  }
+  auto const &a = inputs[0];
+  auto const &b = inputs[1];
+  auto const &c = inputs[2];
+  auto const &d = inputs[3];
+  auto const tail_mask = (elements % bits_per_word) == 0
+                           ? static_cast<T>(~T{0})
+                           : static_cast<T>((static_cast<T>(1) << (elements % bits_per_word)) - 1);
+  auto const apply_tail = [&](std::vector<T> &expected) {
+    if (!expected.empty()) {
+      expected.back() = static_cast<T>(expected.back() & tail_mask);
+    }
+  };
+  auto const population_count = [](std::vector<T> const &words) {
+    size_t count = 0;
+    for (auto word : words) {
+      count += std::popcount(static_cast<U>(word));
+    }
+    return count;
+  };
+
+  std::vector<T> result(word_count);
+  std::vector<T> expected(word_count);
+  {
+    // (a AND b) OR (c ANDNOT d)
+    using expression_t = op_or<op_and<input<0>, input<1>>, op_andnot<input<2>, input<3>>>;
+    BitmaskExpression<SimdStyle, expression_t> op;
+    auto const end = op(result.data(), a.data(), word_count, b.data(), c.data(), d.data());
+    REQUIRE(end == result.data() + word_count);
+    for (size_t i = 0; i < word_count; ++i) {
+      expected[i] = static_cast<T>((a[i] & b[i]) | (c[i] & ~d[i]));
+    }
+    REQUIRE(result == expected);
+  }
+  {
+    // NOT (a OR b OR c) XOR d, the padding bits of the last word are cleared.
+    using expression_t = op_xor<op_not<op_or<input<0>, input<1>, input<2>>>, input<3>>;
+    BitmaskExpression<SimdStyle, expression_t> op(elements);
+    op(result.data(), a.data(), word_count, b.data(), c.data(), d.data());
+    for (size_t i = 0; i < word_count; ++i) {
+      expected[i] = static_cast<T>(~(a[i] | b[i] | c[i]) ^ d[i]);
+    }
+    apply_tail(expected);
+    REQUIRE(result == expected);
+  }
+  {
+    // a AND b AND NOT c with the population count.
+    using expression_t = op_and<input<0>, input<1>, op_not<input<2>>>;
+    using hints_t = OperatorHintSet<hints::intermediate::bit_mask, hints::operators::bitmask_expression::count_bits>;
+    BitmaskExpression<SimdStyle, expression_t, hints_t> op(elements);
+    auto const [end, count] = op(result.data(), a.data(), word_count, b.data(), c.data());
+    REQUIRE(end == result.data() + word_count);
+    for (size_t i = 0; i < word_count; ++i) {
+      expected[i] = static_cast<T>(a[i] & b[i] & ~c[i]);
+    }
+    apply_tail(expected);
+    REQUIRE(result == expected);
+    REQUIRE(count == population_count(expected));
+  }
+  {
+    // A top-level NOT with the population count, which has to exclude the padding bits.
+    using hints_t = OperatorHintSet<hints::intermediate::bit_mask, hints::operators::bitmask_expression::count_bits>;
+    BitmaskExpression<SimdStyle, op_not<input<0>>, hints_t> op(elements);
+    auto const [end, count] = op(result.data(), a.data(), word_count);
+    for (size_t i = 0; i < word_count; ++i) {
+      expected[i] = static_cast<T>(~a[i]);
+    }
+    apply_tail(expected);
+    REQUIRE(result == expected);
+    REQUIRE(count == population_count(expected));
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{0}, size_t{1}, size_t{63}, size_t{64}, size_t{1000}, size_t{64 * 1024 + 17}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Bitmask expression, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Bitmask expression, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Bitmask expression, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,174 @@
+#include "datastructures/compressed_bitmap.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+
+/**
+ * @brief Sorted positions whose chunks cover every container kind: sparse chunks become arrays, dense random chunks
+ * bitmaps and clustered chunks runs.
+ */
+std::vector<size_t> make_positions(std::mt19937_64 &mt, size_t chunk_count) {
+  constexpr size_t chunk_size = size_t{1} << 16;
+  std::vector<size_t> positions;
+  for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+    auto const base = chunk * chunk_size;
+    switch ((chunk + mt() % 2) % 4) {
+      case 0: {
+        std::bernoulli_distribution bit(0.01);
+        for (size_t i = 0; i < chunk_size; ++i) {
+          if (bit(mt)) {
+            positions.push_back(base + i);
+          }
+        }
+        break;
+      }
+      case 1: {
+        std::bernoulli_distribution bit(0.5);
+        for (size_t i = 0; i < chunk_size; ++i) {
+          if (bit(mt)) {
+            positions.push_back(base + i);
+          }
+        }
+        break;
+      }
+      case 2: {
+        for (size_t start = mt() % 1000; start < chunk_size;) {
+          auto const length = std::min<size_t>(1 + mt() % 2000, chunk_size - start);
+          for (size_t i = 0; i < length; ++i) {
+            positions.push_back(base + start + i);
+          }
+          start += length + 1 + mt() % 2000;
+        }
+        break;
+      }
+      default:
+        // An empty chunk.
+        break;
+    }
+  }
+  return positions;
+}
+
+template <class SimdStyle>
+void test(const size_t seed) {
+  using namespace tuddbs;
+  using bitmap_t = CompressedBitmap<SimdStyle>;
+  using kind = typename bitmap_t::container_kind;
+  std::mt19937_64 mt(seed);
+
+  for (size_t chunk_count : {size_t{1}, size_t{4}, size_t{16}}) {
+    auto const left_positions = make_positions(mt, chunk_count);
+    auto const right_positions = make_positions(mt, chunk_count);
+    auto const left = bitmap_t::from_positions(left_positions.data(), left_positions.size());
+    auto const right = bitmap_t::from_positions(right_positions.data(), right_positions.size());
+
+    REQUIRE(left.cardinality() == left_positions.size());
+    std::vector<size_t> decoded(left.cardinality());
+    REQUIRE(left.decode(decoded.data()) == decoded.data() + decoded.size());
+    REQUIRE(decoded == left_positions);
+    std::array<bool, 3> kind_seen{};
+    for (auto const &container : left.containers()) {
+      kind_seen[static_cast<size_t>(container.kind)] = true;
+      if (container.kind == kind::array) {
+        REQUIRE(container.cardinality <= bitmap_t::array_max_cardinality);
+      } else if (container.kind == kind::bitmap) {
+        REQUIRE(container.words.size() == bitmap_t::words_per_chunk);
+      } else {
+        REQUIRE(!container.runs.empty());
+      }
+    }
+    if (chunk_count >= 16) {
+      REQUIRE((kind_seen[0] && kind_seen[1] && kind_seen[2]));
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+      auto const position = mt() % (chunk_count << 16);
+      REQUIRE(left.contains(position) == std::binary_search(left_positions.begin(), left_positions.end(), position));
+    }
+
+    auto const check = [](bitmap_t const &bitmap, std::vector<size_t> const &expected) {
+      REQUIRE(bitmap.cardinality() == expected.size());
+      std::vector<size_t> positions(bitmap.cardinality());
+      bitmap.decode(positions.data());
+      REQUIRE(positions == expected);
+    };
+    std::vector<size_t> expected;
+    std::set_intersection(left_positions.begin(), left_positions.end(), right_positions.begin(),
+                          right_positions.end(), std::back_inserter(expected));
+    check(left.set_intersection(right), expected);
+    expected.clear();
+    std::set_union(left_positions.begin(), left_positions.end(), right_positions.begin(), right_positions.end(),
+                   std::back_inserter(expected));
+    check(left.set_union(right), expected);
+    expected.clear();
+    std::set_difference(left_positions.begin(), left_positions.end(), right_positions.begin(),
+                        right_positions.end(), std::back_inserter(expected));
+    check(left.set_difference(right), expected);
+    check(left.set_difference(left), {});
+
+    // Round trip through a dense bitmask, starting at an unaligned position.
+    auto const element_count = chunk_count << 16;
+    std::vector<uint64_t> words((element_count + 63) / 64);
+    left.to_dense_bit_mask(words.data(), element_count);
+    using hints_t = OperatorHintSet<hints::intermediate::dense_bit_mask>;
+    auto const shifted =
+      bitmap_t::template from_filter_result<tsl::simd<uint64_t, tsl::scalar>, hints_t>(words.data(), element_count, 13);
+    expected.clear();
+    for (auto position : left_positions) {
+      expected.push_back(position + 13);
+    }
+    check(shifted, expected);
+  }
+
+  // Array/array combinations of sparse chunks, with and without shared offsets.
+  for (size_t density : {size_t{10}, size_t{200}, size_t{3000}}) {
+    std::vector<size_t> left_positions;
+    std::vector<size_t> right_positions;
+    for (size_t i = 0; i < (size_t{1} << 16); ++i) {
+      if (mt() % (1 << 16) < density) {
+        left_positions.push_back(i);
+      }
+      if (mt() % (1 << 16) < density) {
+        right_positions.push_back(i);
+      }
+    }
+    auto const left = bitmap_t::from_positions(left_positions.data(), left_positions.size());
+    auto const right = bitmap_t::from_positions(right_positions.data(), right_positions.size());
+    std::vector<size_t> expected;
+    std::set_union(left_positions.begin(), left_positions.end(), right_positions.begin(), right_positions.end(),
+                   std::back_inserter(expected));
+    auto const united = left.set_union(right);
+    std::vector<size_t> positions(united.cardinality());
+    united.decode(positions.data());
+    REQUIRE(positions == expected);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  test<SimdStyle>(seed);
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEST_CASE("Compressed bitmap, sse", "[sse]") { dispatch_type<tsl::simd<uint64_t, tsl::sse>>(); }
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEST_CASE("Compressed bitmap, avx2", "[avx2]") { dispatch_type<tsl::simd<uint64_t, tsl::avx2>>(); }
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEST_CASE("Compressed bitmap, avx512", "[avx512]") { dispatch_type<tsl::simd<uint64_t, tsl::avx512>>(); }
+#endif
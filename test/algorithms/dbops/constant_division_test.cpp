@@ -0,0 +1,140 @@
+#include "algorithms/dbops/arithmetic/constant_division.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle>
+void test_divisor(typename SimdStyle::base_type divisor, std::vector<typename SimdStyle::base_type> const &data) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  std::vector<T> result(data.size());
+  col_constant_divider_t<SimdStyle>{divisor}(result.data(), data.data(), data.size());
+  ConstantDivider<SimdStyle> const divider(divisor);
+  std::vector<T> remainders(data.size() + SimdStyle::vector_element_count());
+  for (size_t i = 0; i + SimdStyle::vector_element_count() <= data.size(); i += SimdStyle::vector_element_count()) {
+    tsl::storeu<SimdStyle>(remainders.data() + i, divider.modulo(tsl::loadu<SimdStyle>(data.data() + i)));
+  }
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (std::is_signed_v<T> && (data[i] == std::numeric_limits<T>::lowest()) && (divisor == static_cast<T>(-1))) {
+      // The quotient is not representable.
+      continue;
+    }
+    REQUIRE(result[i] == static_cast<T>(data[i] / divisor));
+    REQUIRE(divider.modulo_value(data[i]) == static_cast<T>(data[i] % divisor));
+    if (i < (data.size() / SimdStyle::vector_element_count()) * SimdStyle::vector_element_count()) {
+      REQUIRE(remainders[i] == static_cast<T>(data[i] % divisor));
+    }
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using T = typename SimdStyle::base_type;
+  std::mt19937_64 mt(seed);
+  // uniform_int_distribution is undefined for 8-bit types, thus narrower values are drawn as 32-bit integers.
+  using draw_t =
+    std::conditional_t<(sizeof(T) < sizeof(int32_t)), std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>, T>;
+  std::uniform_int_distribution<draw_t> dist(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+  std::vector<T> data(elements);
+  for (auto &value : data) {
+    value = static_cast<T>(dist(mt));
+  }
+  // Boundary values.
+  for (T value : {T{0}, T{1}, std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()}) {
+    if (data.size() < elements + 4) {
+      data.push_back(value);
+    }
+  }
+
+  std::vector<T> divisors = {1, 2, 3, 7, 10, 60, std::numeric_limits<T>::max()};
+  if constexpr (std::is_signed_v<T>) {
+    divisors.insert(divisors.end(), {-1, -3, -100, std::numeric_limits<T>::lowest()});
+  } else {
+    divisors.insert(divisors.end(), {std::numeric_limits<T>::max() / 2 + 1, std::numeric_limits<T>::max() / 2 + 2});
+  }
+  for (size_t i = 0; i < 32; ++i) {
+    // Random divisors of every magnitude.
+    T const divisor = static_cast<T>(dist(mt) >> (mt() % (sizeof(T) * CHAR_BIT)));
+    if (divisor != 0) {
+      divisors.push_back(divisor);
+    }
+  }
+  for (T divisor : divisors) {
+    test_divisor<SimdStyle>(divisor, data);
+  }
+  REQUIRE_THROWS_AS(tuddbs::col_constant_divider_t<SimdStyle>{0}, std::domain_error);
+}
+
+/* Hash tables with a bucket count that is not a power of two normalize via a ConstantDivider. */
+template <class SimdStyle>
+void test_group_sum(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_sum_t = GroupAggregate_Sum<SimdStyle, T, OperatorHintSet<hints::hashing::linear_displacement>>;
+  constexpr size_t group_count = 37;
+  constexpr size_t map_count = 3 * group_count;
+  std::mt19937_64 mt(seed);
+  std::uniform_int_distribution<size_t> group(1, group_count);
+  std::vector<T> keys(elements);
+  std::vector<T> values(elements);
+  std::map<T, T> expected;
+  for (size_t i = 0; i < elements; ++i) {
+    keys[i] = static_cast<T>(group(mt) * 1000003);
+    values[i] = static_cast<T>(i % 100);
+    expected[keys[i]] += values[i];
+  }
+  std::vector<T> key_sink(map_count + SimdStyle::vector_element_count());
+  std::vector<T> value_sink(map_count + SimdStyle::vector_element_count());
+  typename group_sum_t::builder_t builder(key_sink.data(), value_sink.data(), map_count);
+  builder(keys.data(), elements, values.data());
+  REQUIRE(builder.distinct_key_count() == expected.size());
+  for (size_t i = 0; i < map_count; ++i) {
+    if (key_sink[i] != 0) {
+      REQUIRE(value_sink[i] == expected[key_sink[i]]);
+    }
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+  if constexpr (std::is_unsigned_v<typename SimdStyle::base_type>) {
+    test_group_sum<SimdStyle>(10000, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Division by a constant, sse", "[sse]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t,
+                   int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Division by a constant, avx2", "[avx2]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t,
+                   int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Division by a constant, avx512", "[avx512]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t,
+                   int16_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
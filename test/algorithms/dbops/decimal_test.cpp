@@ -0,0 +1,201 @@
+#include "algorithms/dbops/arithmetic/decimal.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/* Reference implementations on __int128, rounding half away from zero. */
+__int128 reference_round_divide(__int128 numerator, __int128 denominator) {
+  __int128 const quotient = numerator / denominator;
+  __int128 const remainder = numerator % denominator;
+  __int128 const abs_remainder = (remainder < 0) ? -remainder : remainder;
+  __int128 const abs_denominator = (denominator < 0) ? -denominator : denominator;
+  if (2 * abs_remainder >= abs_denominator) {
+    return quotient + (((numerator < 0) != (denominator < 0)) ? -1 : 1);
+  }
+  return quotient;
+}
+
+__int128 reference_rescale(__int128 value, int shift) {
+  __int128 factor = 1;
+  for (int i = 0; i < ((shift < 0) ? -shift : shift); ++i) {
+    factor *= 10;
+  }
+  return (shift >= 0) ? value * factor : reference_round_divide(value, factor);
+}
+
+template <class SimdStyle, class HintSet, class Lhs, class Rhs, class Result>
+void test_elementwise(std::vector<typename SimdStyle::base_type> const &lhs,
+                      std::vector<typename SimdStyle::base_type> const &rhs, auto reference) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  std::vector<T> result(lhs.size());
+  DecimalArithmetic<SimdStyle, Lhs, Rhs, Result, HintSet>{}(result.data(), lhs.data(), lhs.size(), rhs.data());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    REQUIRE(static_cast<__int128>(result[i]) == reference(static_cast<__int128>(lhs[i]), rhs[i]));
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  constexpr size_t digits = (sizeof(T) == sizeof(int32_t)) ? 9 : 18;
+  // Operands with 4 (resp. 7) digits, such that sums and products in registers can not overflow.
+  using small_t = decimal<digits / 2 - 1, 2>;
+  using fine_t = decimal<digits / 2, 3>;
+  using wide_t = decimal<digits, 4>;
+
+  std::mt19937_64 mt(seed);
+  std::uniform_int_distribution<T> small_dist(-small_t::max_value, small_t::max_value);
+  std::uniform_int_distribution<T> fine_dist(-fine_t::max_value, fine_t::max_value);
+  std::bernoulli_distribution selected(0.5);
+  std::vector<T> lhs(elements);
+  std::vector<T> rhs(elements);
+  std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+  for (size_t i = 0; i < elements; ++i) {
+    lhs[i] = small_dist(mt);
+    rhs[i] = fine_dist(mt);
+    if (rhs[i] == 0) {
+      rhs[i] = 1;
+    }
+    if (selected(mt)) {
+      bit_mask[i / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (i % SimdStyle::vector_element_count()));
+    }
+  }
+
+  // small + fine: the operands are aligned to the scale of the result within the registers.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::add>, small_t, fine_t, wide_t>(
+    lhs, rhs, [](__int128 a, __int128 b) { return a * 100 + b * 10; });
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::sub>, small_t, fine_t, wide_t>(
+    lhs, rhs, [](__int128 a, __int128 b) { return a * 100 - b * 10; });
+  // small + fine rounded to one fractional digit: the sum is divided by 10^2 in the registers.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::add>, small_t, fine_t, decimal<digits, 1>>(
+    lhs, rhs, [](__int128 a, __int128 b) { return reference_rescale(a * 10 + b, -2); });
+  // small * fine keeps all 5 fractional digits in the registers.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::mul>, small_t, fine_t, decimal<digits, 5>>(
+    lhs, rhs, [](__int128 a, __int128 b) { return a * b; });
+  // small * fine rounded to 2 fractional digits.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::mul>, small_t, fine_t, decimal<digits, 2>>(
+    lhs, rhs, [](__int128 a, __int128 b) { return reference_rescale(a * b, -3); });
+  // small / fine with 4 fractional digits.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::div>, small_t, fine_t, wide_t>(
+    lhs, rhs, [](__int128 a, __int128 b) { return reference_round_divide(a * 100000, b); });
+  // money * money rounded back to 2 fractional digits, e.g. price * quantity.
+  using money_t = decimal<digits / 2, 2>;
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::mul>, money_t, money_t, decimal<digits, 2>>(
+    rhs, rhs, [](__int128 a, __int128 b) { return reference_rescale(a * b, -2); });
+  // fine / integer with 2 fractional digits: the divisor is scaled up instead of the dividend.
+  test_elementwise<SimdStyle, OperatorHintSet<hints::arithmetic::div>, fine_t, decimal<digits / 2, 0>,
+                   decimal<digits, 2>>(rhs, rhs,
+                                       [](__int128 a, __int128 b) { return reference_round_divide(a, b * 10); });
+
+  if (elements > 0) {
+    // Division by zero.
+    std::vector<T> zeros(elements, 0);
+    std::vector<T> result(elements);
+    using div_t = DecimalArithmetic<SimdStyle, small_t, fine_t, wide_t, OperatorHintSet<hints::arithmetic::div>>;
+    REQUIRE_THROWS_AS(div_t{}(result.data(), lhs.data(), elements, zeros.data()), std::domain_error);
+
+    // The checked product of two maximal values exceeds the precision of the result.
+    std::vector<T> large(elements, fine_t::max_value);
+    using checked_mul_t = DecimalArithmetic<SimdStyle, fine_t, fine_t, decimal<digits - 2, 6>,
+                                            OperatorHintSet<hints::arithmetic::mul, hints::arithmetic::checked>>;
+    REQUIRE_THROWS_AS(checked_mul_t{}(result.data(), large.data(), elements, large.data()), std::overflow_error);
+  }
+
+  // Sums and averages, accumulated in the widened type.
+  __int128 expected_sum = 0;
+  __int128 expected_selected_sum = 0;
+  size_t selected_count = 0;
+  for (size_t i = 0; i < elements; ++i) {
+    expected_sum += rhs[i];
+    if ((bit_mask[i / SimdStyle::vector_element_count()] >> (i % SimdStyle::vector_element_count())) & 1) {
+      expected_selected_sum += rhs[i];
+      ++selected_count;
+    }
+  }
+  using sum_result_t = decimal<digits + 9, 3>;
+  using avg_result_t = decimal<digits, 5>;
+  typename sum_result_t::storage_t sum;
+  DecimalArithmetic<SimdStyle, fine_t, fine_t, sum_result_t, OperatorHintSet<hints::arithmetic::sum>>{}(
+    &sum, rhs.data(), elements);
+  REQUIRE(static_cast<__int128>(sum) == expected_sum);
+  DecimalArithmetic<SimdStyle, fine_t, fine_t, sum_result_t,
+                    OperatorHintSet<hints::arithmetic::sum, hints::intermediate::bit_mask>>{}(
+    &sum, rhs.data(), elements, bit_mask.data());
+  REQUIRE(static_cast<__int128>(sum) == expected_selected_sum);
+
+  typename avg_result_t::storage_t average;
+  DecimalArithmetic<SimdStyle, fine_t, fine_t, avg_result_t,
+                    OperatorHintSet<hints::arithmetic::average, hints::intermediate::bit_mask>>{}(
+    &average, rhs.data(), elements, bit_mask.data());
+  REQUIRE(average == decimal_average<avg_result_t, fine_t>(expected_selected_sum, selected_count));
+  if (selected_count > 0) {
+    REQUIRE(average == reference_round_divide(expected_selected_sum * 100, static_cast<__int128>(selected_count)));
+  }
+
+  // Per-group sums of a decimal column, grouped by a key column.
+  using group_sum_t = DecimalGroupAggregate_Sum<SimdStyle, fine_t>;
+  constexpr size_t group_count = 16;
+  constexpr size_t map_count = 4 * group_count;
+  std::vector<T> keys(elements);
+  std::map<T, __int128> expected_group_sums;
+  std::map<T, size_t> expected_group_counts;
+  for (size_t i = 0; i < elements; ++i) {
+    keys[i] = static_cast<T>(i % group_count + 1);
+    expected_group_sums[keys[i]] += rhs[i];
+    ++expected_group_counts[keys[i]];
+  }
+  std::vector<T> key_sink(map_count);
+  std::vector<int64_t> sum_sink(map_count);
+  typename group_sum_t::builder_t builder(key_sink.data(), sum_sink.data(), map_count);
+  builder(keys.data(), elements, rhs.data());
+  REQUIRE(builder.distinct_key_count() == std::min(elements, group_count));
+  for (size_t i = 0; i < map_count; ++i) {
+    if (key_sink[i] != 0) {
+      REQUIRE(sum_sink[i] == expected_group_sums[key_sink[i]]);
+      REQUIRE(decimal_average<avg_result_t, fine_t>(sum_sink[i], expected_group_counts[key_sink[i]]) ==
+              reference_round_divide(static_cast<__int128>(sum_sink[i]) * 100,
+                                     static_cast<__int128>(expected_group_counts[key_sink[i]])));
+    }
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{0}, size_t{1}, size_t{1000}, size_t{1024 * 64 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEST_CASE("Decimal arithmetic, sse", "[sse]") {
+  dispatch_type<tsl::simd<int32_t, tsl::sse>>();
+  dispatch_type<tsl::simd<int64_t, tsl::sse>>();
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEST_CASE("Decimal arithmetic, avx2", "[avx2]") {
+  dispatch_type<tsl::simd<int32_t, tsl::avx2>>();
+  dispatch_type<tsl::simd<int64_t, tsl::avx2>>();
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEST_CASE("Decimal arithmetic, avx512", "[avx512]") {
+  dispatch_type<tsl::simd<int32_t, tsl::avx512>>();
+  dispatch_type<tsl::simd<int64_t, tsl::avx512>>();
+}
+#endif
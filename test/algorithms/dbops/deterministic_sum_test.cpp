@@ -0,0 +1,136 @@
+#include "algorithms/dbops/arithmetic/deterministic_sum.hpp"
+
+#include <algorithm>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/arithmetic/arithmetic.hpp"
+
+template <typename T>
+bool bitwise_equal(T a, T b) {
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <class SimdStyle, class HintSet>
+auto partitioned_sum(auto const &data, auto const &bit_mask, size_t partition_count, size_t seed) {
+  using namespace tuddbs;
+  using sum_t = DeterministicSum<SimdStyle, HintSet>;
+  constexpr size_t block_size = size_t{1} << 14;
+  auto const block_count = (data.size() + block_size - 1) / block_size;
+  std::vector<sum_t> partial(partition_count);
+  for (size_t p = 0; p < partition_count; ++p) {
+    auto const begin = std::min(data.size(), ((p * block_count) / partition_count) * block_size);
+    auto const end = std::min(data.size(), (((p + 1) * block_count) / partition_count) * block_size);
+    if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+      partial[p](data.data() + begin, end - begin, bit_mask.data() + begin / SimdStyle::vector_element_count(), begin);
+    } else {
+      partial[p](data.data() + begin, end - begin, begin);
+    }
+  }
+  // Merge in a shuffled order, the result must not depend on it.
+  std::vector<size_t> order(partition_count);
+  for (size_t p = 0; p < partition_count; ++p) {
+    order[p] = p;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+  sum_t result;
+  for (auto p : order) {
+    result.merge(partial[p]);
+  }
+  result.finalize();
+  return std::make_pair(result.result(), result.count());
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+
+  std::mt19937_64 mt(seed);
+  std::uniform_real_distribution<T> dist(-1000, 1000);
+  std::uniform_int_distribution<int> exponent(-20, 20);
+  std::bernoulli_distribution selected(0.4);
+  std::vector<T> data(elements);
+  std::vector<imask_t> bit_mask(elements / SimdStyle::vector_element_count() + 1, 0);
+  long double expected_all = 0;
+  long double expected_selected = 0;
+  long double magnitude = 0;
+  size_t selected_count = 0;
+  for (size_t i = 0; i < elements; ++i) {
+    data[i] = std::ldexp(dist(mt), exponent(mt));
+    expected_all += data[i];
+    magnitude += std::fabs(data[i]);
+    if (selected(mt)) {
+      bit_mask[i / SimdStyle::vector_element_count()] |=
+        static_cast<imask_t>(imask_t{1} << (i % SimdStyle::vector_element_count()));
+      expected_selected += data[i];
+      ++selected_count;
+    }
+  }
+
+  // Compensated summation is accurate up to a few ulps of the sum of magnitudes.
+  long double const tolerance = 8 * std::numeric_limits<T>::epsilon() * magnitude + 1e-3;
+  auto const close_to = [tolerance](T is, long double should) { return std::fabs(is - should) <= tolerance; };
+
+  using all_rows_t = OperatorHintSet<hints::intermediate::position_list>;
+  using selected_rows_t = OperatorHintSet<hints::intermediate::bit_mask>;
+  auto const reference_all = partitioned_sum<SimdStyle, all_rows_t>(data, bit_mask, 1, seed);
+  auto const reference_selected = partitioned_sum<SimdStyle, selected_rows_t>(data, bit_mask, 1, seed);
+  REQUIRE(reference_all.second == elements);
+  REQUIRE(reference_selected.second == selected_count);
+  REQUIRE(close_to(reference_all.first, expected_all));
+  REQUIRE(close_to(reference_selected.first, expected_selected));
+  for (size_t partition_count : {2, 3, 7, 16}) {
+    auto const all = partitioned_sum<SimdStyle, all_rows_t>(data, bit_mask, partition_count, seed + partition_count);
+    REQUIRE(bitwise_equal(all.first, reference_all.first));
+    auto const selected_rows =
+      partitioned_sum<SimdStyle, selected_rows_t>(data, bit_mask, partition_count, seed + partition_count);
+    REQUIRE(bitwise_equal(selected_rows.first, reference_selected.first));
+  }
+
+  // The unrolled sum of Arithmetic is deterministic within a single call as well.
+  T sum_1;
+  T sum_2;
+  col_sum_t<SimdStyle>{}(&sum_1, data.data(), elements);
+  col_sum_t<SimdStyle>{}(&sum_2, data.data(), elements);
+  REQUIRE(bitwise_equal(sum_1, sum_2));
+  REQUIRE(close_to(sum_1, expected_all));
+  col_bm_sum_t<SimdStyle>{}(&sum_1, data.data(), elements, bit_mask.data());
+  REQUIRE(close_to(sum_1, expected_selected));
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{1024 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Deterministic sum, sse", "[sse]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Deterministic sum, avx2", "[avx2]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Deterministic sum, avx512", "[avx512]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,99 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_grouping(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  // The map is padded by a register, as bucket groups may reach beyond the last bucket.
+  std::vector<T> key_sink(map_count + SimdStyle::vector_element_count());
+  std::vector<T> gid_sink(map_count + SimdStyle::vector_element_count());
+  std::vector<size_t> position_sink(map_count + SimdStyle::vector_element_count());
+  typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  builder(keys.data(), keys.size());
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+
+  std::vector<T> gids(keys.size());
+  typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  grouper(gids.data(), keys.data(), keys.size());
+  std::map<T, T> gid_of_key;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(gids[i] < first_occurence.size());
+    REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+    auto const [it, inserted] = gid_of_key.try_emplace(keys[i], gids[i]);
+    REQUIRE(it->second == gids[i]);
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using scalar_t = OperatorHintSet<hints::hashing::linear_displacement>;
+  using batched_t = OperatorHintSet<hints::hashing::linear_displacement, hints::grouping::batched_insert>;
+  using batched_exp_2_t = OperatorHintSet<hints::hashing::linear_displacement, hints::hashing::size_exp_2,
+                                          hints::grouping::batched_insert>;
+  using batched_first_t =
+    OperatorHintSet<hints::hashing::linear_displacement, hints::hashing::size_exp_2, hints::grouping::batched_insert,
+                    hints::grouping::global_first_occurence_required>;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{5}, size_t{300}, size_t{700}}) {
+    // Keys are never 0, which is the empty bucket value. Low cardinalities lead to duplicates within a register, high
+    // cardinalities to long displacement chains and conflicts on empty buckets.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    test_grouping<SimdStyle, scalar_t>(keys, 1000);
+    test_grouping<SimdStyle, batched_t>(keys, 1000);
+    test_grouping<SimdStyle, batched_exp_2_t>(keys, 1024);
+    test_grouping<SimdStyle, batched_first_t>(keys, 1024);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Batched group build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Batched group build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Batched group build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,136 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+/* A user defined hash function without a register variant, the lookup hashes every key on its own. */
+struct scalar_only_hash {
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+  struct hasher_t {
+    static auto hash_value(typename SimdStyle::base_type key) {
+      using T = typename SimdStyle::base_type;
+      return static_cast<T>(static_cast<T>(key ^ (key >> 3)) & std::numeric_limits<T>::max());
+    }
+  };
+};
+
+template <class SimdStyle, class HintSet>
+void test_lookup(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  constexpr size_t bits_per_mask = sizeof(imask_t) * CHAR_BIT;
+  T const unwritten = std::numeric_limits<T>::max();
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  std::vector<T> key_sink(map_count + lanes);
+  std::vector<T> gid_sink(map_count + lanes);
+  std::vector<size_t> position_sink(map_count + lanes);
+  typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  builder(keys.data(), keys.size());
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+
+  typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  std::vector<T> gids(keys.size(), unwritten);
+  grouper(gids.data(), keys.data(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+  }
+
+  std::uniform_int_distribution<uint64_t> bits;
+  auto check_masked = [&](std::vector<T> const &masked_gids, auto const is_valid) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (is_valid(i)) {
+        REQUIRE(masked_gids[i] == gids[i]);
+      } else {
+        REQUIRE(masked_gids[i] == unwritten);
+      }
+    }
+  };
+
+  if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+    std::vector<imask_t> masks((keys.size() + lanes - 1) / lanes);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    std::vector<T> masked_gids(keys.size(), unwritten);
+    grouper(masked_gids.data(), keys.data(), keys.size(), masks.data());
+    check_masked(masked_gids, [&](size_t i) { return ((masks[i / lanes] >> (i % lanes)) & 1) != 0; });
+  }
+  if constexpr (has_hint<HintSet, hints::intermediate::dense_bit_mask>) {
+    std::vector<imask_t> masks((keys.size() + bits_per_mask - 1) / bits_per_mask);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    std::vector<T> masked_gids(keys.size(), unwritten);
+    grouper(masked_gids.data(), keys.data(), keys.size(), masks.data());
+    check_masked(masked_gids,
+                 [&](size_t i) { return ((masks[i / bits_per_mask] >> (i % bits_per_mask)) & 1) != 0; });
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using namespace hints::intermediate;
+  using T = typename SimdStyle::base_type;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{3000}}) {
+    // Keys are never 0, which is the empty bucket value.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    test_lookup<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys, 4096, mt);
+    test_lookup<SimdStyle, OperatorHintSet<linear_displacement>>(keys, 4001, mt);
+    test_lookup<SimdStyle, OperatorHintSet<linear_displacement, scalar_only_hash>>(keys, 4001, mt);
+    test_lookup<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, bit_mask>>(keys, 4096, mt);
+    test_lookup<SimdStyle, OperatorHintSet<linear_displacement, dense_bit_mask>>(keys, 4001, mt);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{61}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Batched group id lookup, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Batched group id lookup, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Batched group id lookup, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
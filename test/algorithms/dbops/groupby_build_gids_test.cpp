@@ -0,0 +1,145 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_build(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  constexpr size_t bits_per_mask = sizeof(imask_t) * CHAR_BIT;
+  T const unwritten = std::numeric_limits<T>::max();
+
+  // The sinks hold the padding the table requires, followed by a register of sentinels that must stay untouched.
+  auto const sink_count = map_count + bucket_padding<SimdStyle, HintSet>(map_count);
+  T const sentinel = 7;
+  std::vector<T> key_sink(sink_count + lanes, sentinel);
+  std::vector<T> gid_sink(sink_count + lanes, sentinel);
+  std::vector<size_t> position_sink(map_count + lanes);
+  std::vector<T> gids(keys.size(), unwritten);
+  std::vector<T> looked_up_gids(keys.size(), unwritten);
+
+  // The group ids written during the build equal the ones of a lookup in the finished table.
+  auto check = [&](auto const build, auto const lookup) {
+    std::fill(gids.begin(), gids.end(), unwritten);
+    std::fill(looked_up_gids.begin(), looked_up_gids.end(), unwritten);
+    typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+    build(builder);
+    builder.finalize();
+    typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+    lookup(grouper);
+    REQUIRE(gids == looked_up_gids);
+    for (size_t i = sink_count; i < sink_count + lanes; ++i) {
+      REQUIRE(key_sink[i] == sentinel);
+      REQUIRE(gid_sink[i] == sentinel);
+    }
+    return builder.distinct_key_count();
+  };
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+  auto const groups = check([&](auto &builder) { builder.build_with_gids(gids.data(), keys.data(), keys.size()); },
+                            [&](auto &grouper) { grouper(looked_up_gids.data(), keys.data(), keys.size()); });
+  REQUIRE(groups == first_occurence.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(static_cast<size_t>(gids[i]) < groups);
+    REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+  }
+
+  std::uniform_int_distribution<uint64_t> bits;
+  if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+    std::vector<imask_t> masks((keys.size() + lanes - 1) / lanes);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    check([&](auto &builder) { builder.build_with_gids(gids.data(), keys.data(), keys.size(), masks.data()); },
+          [&](auto &grouper) { grouper(looked_up_gids.data(), keys.data(), keys.size(), masks.data()); });
+  }
+  if constexpr (has_hint<HintSet, hints::intermediate::dense_bit_mask>) {
+    std::vector<imask_t> masks((keys.size() + bits_per_mask - 1) / bits_per_mask);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    check([&](auto &builder) { builder.build_with_gids(gids.data(), keys.data(), keys.size(), masks.data()); },
+          [&](auto &grouper) { grouper(looked_up_gids.data(), keys.data(), keys.size(), masks.data()); });
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using namespace hints::intermediate;
+  using T = typename SimdStyle::base_type;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{3000}}) {
+    // Keys are never 0, which is the empty bucket value.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    test_build<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys, 4096, mt);
+    test_build<SimdStyle, OperatorHintSet<linear_displacement>>(keys, 4001, mt);
+    test_build<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, hints::grouping::batched_insert>>(keys, 4096,
+                                                                                                             mt);
+    test_build<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, bit_mask>>(keys, 4096, mt);
+    test_build<SimdStyle, OperatorHintSet<linear_displacement, dense_bit_mask>>(keys, 4001, mt);
+  }
+
+  // 40 keys including 0 in tight tables: the bucket of the key 0 may be the only one of a register that looks empty.
+  std::uniform_int_distribution<size_t> key(0, 39);
+  std::vector<T> keys(elements);
+  for (auto &k : keys) {
+    k = static_cast<T>(key(mt) * 7919);
+  }
+  keys[elements / 2] = 0;
+  test_build<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_zero>>(keys, 64, mt);
+  test_build<SimdStyle, OperatorHintSet<linear_displacement, keys_may_contain_zero>>(keys, 61, mt);
+  // A multiple of the register width needs no padding.
+  test_build<SimdStyle, OperatorHintSet<linear_displacement, keys_may_contain_zero>>(keys, 64, mt);
+  test_build<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_zero, bit_mask>>(keys, 64,
+                                                                                                          mt);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{61}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Group ids during the build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Group ids during the build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Group ids during the build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,232 @@
+#include <array>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+#include "algorithms/utils/hashing.hpp"
+
+template <class SimdStyle, size_t ColumnCount>
+void test_packing(const size_t elements, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using packer_t = typename GroupComposite<SimdStyle, size_t, ColumnCount>::template packer_t<>;
+  constexpr unsigned width = (sizeof(T) * 8) / ColumnCount;
+  std::array<unsigned, ColumnCount> widths;
+  widths.fill(width);
+  packer_t packer(widths);
+
+  std::uniform_int_distribution<uint64_t> dist(0, (uint64_t{1} << width) - 1);
+  std::array<std::vector<T>, ColumnCount> columns;
+  std::array<std::vector<T>, ColumnCount> unpacked;
+  std::array<T const *, ColumnCount> column_ptrs;
+  std::array<T *, ColumnCount> unpacked_ptrs;
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    columns[column].resize(elements);
+    unpacked[column].resize(elements);
+    for (auto &value : columns[column]) {
+      value = static_cast<T>(dist(mt));
+    }
+    column_ptrs[column] = columns[column].data();
+    unpacked_ptrs[column] = unpacked[column].data();
+  }
+  std::vector<T> packed(elements);
+  packer(packed.data(), column_ptrs, elements);
+  packer.unpack(unpacked_ptrs, packed.data(), elements);
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    REQUIRE(unpacked[column] == columns[column]);
+  }
+
+  // A value exceeding the width of its column (in the SIMD part or in the remainder) is rejected.
+  columns[ColumnCount - 1][elements - 1] = static_cast<T>(uint64_t{1} << width);
+  REQUIRE_THROWS_AS(packer(packed.data(), column_ptrs, elements), std::out_of_range);
+  widths.fill(width + 1);
+  REQUIRE(!packer_t::fits(widths));
+  REQUIRE_THROWS_AS(packer_t{widths}, std::invalid_argument);
+
+  if constexpr (sizeof(T) == sizeof(uint64_t) && ColumnCount == 2) {
+    // Two 32-bit columns are widened into one 64-bit key.
+    using narrow_packer_t = typename GroupComposite<SimdStyle, size_t, ColumnCount>::template packer_t<uint32_t>;
+    std::vector<uint32_t> low(elements), high(elements), low_out(elements), high_out(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      low[i] = static_cast<uint32_t>(mt());
+      high[i] = static_cast<uint32_t>(mt());
+    }
+    narrow_packer_t narrow_packer({32, 32});
+    narrow_packer(packed.data(), {low.data(), high.data()}, elements);
+    for (size_t i = 0; i < elements; ++i) {
+      REQUIRE(packed[i] == ((static_cast<T>(high[i]) << 32) | low[i]));
+    }
+    narrow_packer.unpack({low_out.data(), high_out.data()}, packed.data(), elements);
+    REQUIRE(low_out == low);
+    REQUIRE(high_out == high);
+  }
+}
+
+template <class SimdStyle, size_t ColumnCount, class HintSet>
+void test_grouping(const size_t elements, const size_t map_count, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = GroupComposite<SimdStyle, size_t, ColumnCount, HintSet>;
+  using key_t = std::array<T, ColumnCount>;
+
+  // Few distinct values per column, but many distinct combinations. The keys use the full value range.
+  std::array<std::vector<T>, ColumnCount> columns;
+  std::array<T const *, ColumnCount> column_ptrs;
+  std::uniform_int_distribution<size_t> pick(0, 6);
+  std::uniform_int_distribution<T> any(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+  std::array<std::array<T, 7>, ColumnCount> domains;
+  for (auto &domain : domains) {
+    for (auto &value : domain) {
+      value = any(mt);
+    }
+    domain[0] = 0;
+  }
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    columns[column].resize(elements);
+    for (auto &value : columns[column]) {
+      value = domains[column][pick(mt)];
+    }
+    column_ptrs[column] = columns[column].data();
+  }
+  auto key_at = [&](size_t i) {
+    key_t key;
+    for (size_t column = 0; column < ColumnCount; ++column) {
+      key[column] = columns[column][i];
+    }
+    return key;
+  };
+  std::map<key_t, size_t> first_occurence;
+  for (size_t i = 0; i < elements; ++i) {
+    first_occurence.try_emplace(key_at(i), i);
+  }
+  if (first_occurence.size() >= map_count) {
+    return;
+  }
+
+  constexpr size_t padding = SimdStyle::vector_element_count();
+  std::array<std::vector<T>, ColumnCount> key_sinks;
+  std::array<T *, ColumnCount> key_sink_ptrs;
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    key_sinks[column].assign(map_count + padding, 0);
+    key_sink_ptrs[column] = key_sinks[column].data();
+  }
+  // The builder marks all buckets as empty, including the padding behind the last bucket.
+  std::vector<T> gid_sink(map_count + padding, 0);
+  std::vector<size_t> position_sink(map_count + padding);
+
+  // Build the table from two halves that are merged.
+  size_t const half = elements / 2;
+  std::array<std::vector<T>, ColumnCount> other_key_sinks;
+  std::array<T *, ColumnCount> other_key_sink_ptrs;
+  std::array<T const *, ColumnCount> second_half_ptrs;
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    other_key_sinks[column].assign(map_count + padding, 0);
+    other_key_sink_ptrs[column] = other_key_sinks[column].data();
+    second_half_ptrs[column] = column_ptrs[column] + half;
+  }
+  std::vector<T> other_gid_sink(map_count + padding, 0);
+  std::vector<size_t> other_position_sink(map_count + padding);
+
+  typename group_t::builder_t builder(key_sink_ptrs, gid_sink.data(), position_sink.data(), map_count);
+  typename group_t::builder_t other(other_key_sink_ptrs, other_gid_sink.data(), other_position_sink.data(),
+                                    map_count);
+  builder(column_ptrs, half);
+  other(second_half_ptrs, elements - half, half);
+  builder.merge(other);
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+  if constexpr (!has_hint<HintSet, hints::hashing::size_exp_2>) {
+    // Every group occupies exactly one bucket, the padding included.
+    size_t occupied = 0;
+    for (auto gid : gid_sink) {
+      occupied += (gid != builder.invalid_gid());
+    }
+    REQUIRE(occupied == first_occurence.size());
+  }
+
+  std::vector<T> gids(elements);
+  typename group_t::grouper_t grouper(key_sink_ptrs, gid_sink.data(), map_count);
+  grouper(gids.data(), column_ptrs, elements);
+  std::map<T, key_t> key_of_gid;
+  for (size_t i = 0; i < elements; ++i) {
+    REQUIRE(gids[i] < builder.distinct_key_count());
+    auto const [it, inserted] = key_of_gid.try_emplace(gids[i], key_at(i));
+    REQUIRE(it->second == key_at(i));
+    if (has_hint<HintSet, hints::grouping::global_first_occurence_required> || first_occurence[key_at(i)] < half) {
+      REQUIRE(position_sink[gids[i]] == first_occurence[key_at(i)]);
+    }
+  }
+  REQUIRE(key_of_gid.size() == first_occurence.size());
+
+  // Keys that were not inserted have no group.
+  std::array<T, ColumnCount> unknown;
+  std::array<T const *, ColumnCount> unknown_ptrs;
+  for (size_t column = 0; column < ColumnCount; ++column) {
+    unknown[column] = domains[column][0];
+    unknown_ptrs[column] = &unknown[column];
+  }
+  unknown[ColumnCount - 1] = static_cast<T>(domains[ColumnCount - 1][1] ^ domains[ColumnCount - 1][2] ^ 1);
+  if (first_occurence.count(unknown) == 0) {
+    T gid;
+    grouper(&gid, unknown_ptrs, 1);
+    REQUIRE(gid == builder.invalid_gid());
+  }
+  // The all-zero key equals the keys of empty buckets.
+  unknown.fill(0);
+  if (first_occurence.count(unknown) == 0) {
+    T gid;
+    grouper(&gid, unknown_ptrs, 1);
+    REQUIRE(gid == builder.invalid_gid());
+  }
+}
+
+template <class SimdStyle, size_t ColumnCount>
+void test_columns(const size_t elements, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using namespace hints::grouping;
+  test_packing<SimdStyle, ColumnCount>(elements, mt);
+  test_grouping<SimdStyle, ColumnCount, OperatorHintSet<size_exp_2, linear_displacement>>(elements, 4096, mt);
+  test_grouping<SimdStyle, ColumnCount, OperatorHintSet<linear_displacement>>(elements, 3001, mt);
+  test_grouping<SimdStyle, ColumnCount, OperatorHintSet<linear_displacement, global_first_occurence_required>>(
+    elements, 3001, mt);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  std::mt19937_64 mt(seed);
+  for (size_t elements : {size_t{1}, size_t{37}, size_t{1000}, size_t{20000}}) {
+    test_columns<SimdStyle, 2>(elements, mt);
+    test_columns<SimdStyle, 3>(elements, mt);
+    test_columns<SimdStyle, 4>(elements, mt);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Group by composite keys, sse", "[sse]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Group by composite keys, avx2", "[avx2]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Group by composite keys, avx512", "[avx512]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,143 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_grouping(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count, size_t thread_count) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  // Bucket groups may reach beyond the last bucket. The sinks are zero filled, the builder initializes the padding.
+  auto const sink_count = map_count + bucket_padding<SimdStyle, HintSet>(map_count);
+  std::vector<T> key_sink(sink_count, 0);
+  std::vector<T> gid_sink(sink_count, 0);
+  std::vector<size_t> position_sink(sink_count);
+  typename group_t::concurrent_builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+
+  // Interleaved slices, so that threads race for the same keys.
+  constexpr size_t slice = 97;
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < thread_count; ++t) {
+    pool.emplace_back([&, t]() {
+      for (size_t begin = t * slice; begin < keys.size(); begin += thread_count * slice) {
+        auto const count = std::min(slice, keys.size() - begin);
+        builder(keys.data() + begin, count, begin);
+      }
+    });
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+
+  std::vector<T> gids(keys.size());
+  typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  grouper(gids.data(), keys.data(), keys.size());
+  std::map<T, T> gid_of_key;
+  std::vector<bool> gid_used(first_occurence.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(gids[i] < first_occurence.size());
+    if constexpr (has_hint<HintSet, hints::grouping::global_first_occurence_required>) {
+      REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+    } else {
+      // The thread that inserted the key first decides the position.
+      REQUIRE(keys[position_sink[gids[i]]] == keys[i]);
+    }
+    auto const [it, inserted] = gid_of_key.try_emplace(keys[i], gids[i]);
+    REQUIRE(it->second == gids[i]);
+    if (inserted) {
+      REQUIRE(!gid_used[gids[i]]);
+      gid_used[gids[i]] = true;
+    }
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using T = typename SimdStyle::base_type;
+  using first_t = hints::grouping::global_first_occurence_required;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{2500}}) {
+    std::uniform_int_distribution<size_t> key(0, distinct - 1);
+    std::vector<T> keys(elements);
+    std::vector<T> keys_with_zero(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      auto const k = key(mt);
+      // Keys are never 0, which is the empty bucket value, unless keys_may_contain_zero is set.
+      keys[i] = static_cast<T>((k + 1) * 7919);
+      keys_with_zero[i] = static_cast<T>(k * 7919);
+    }
+    for (size_t thread_count : {size_t{1}, size_t{4}}) {
+      test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys, 4096, thread_count);
+      test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, first_t>>(keys, 4096, thread_count);
+      test_grouping<SimdStyle, OperatorHintSet<linear_displacement, first_t>>(keys, 3001, thread_count);
+      test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_zero, first_t>>(
+        keys_with_zero, 4096, thread_count);
+      test_grouping<SimdStyle, OperatorHintSet<linear_displacement, keys_may_contain_zero, first_t>>(keys_with_zero,
+                                                                                                     3001, thread_count);
+    }
+  }
+
+  // Every bucket holds a key, so finalize() finds no bucket for the key 0 and has to give up after one pass.
+  using full_hints_t = OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_zero>;
+  constexpr size_t map_count = 2 * SimdStyle::vector_element_count();
+  std::vector<T> full_keys(map_count + 1);
+  for (size_t i = 0; i < full_keys.size(); ++i) {
+    full_keys[i] = static_cast<T>(i * 7919);
+  }
+  std::vector<T> key_sink(map_count);
+  std::vector<T> gid_sink(map_count);
+  std::vector<size_t> position_sink(map_count + 1);
+  typename Group<SimdStyle, size_t, full_hints_t>::concurrent_builder_t builder(key_sink.data(), gid_sink.data(),
+                                                                                position_sink.data(), map_count);
+  builder(full_keys.data(), full_keys.size());
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == map_count + 1);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Concurrent group build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Concurrent group build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Concurrent group build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,167 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class Builder, typename T>
+void require_groups(Builder const &builder, std::vector<T> const &keys, std::map<T, size_t> const &first_occurence,
+                    bool check_positions = true) {
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+  std::vector<T> gids(keys.size());
+  builder.grouper()(gids.data(), keys.data(), keys.size());
+  std::map<T, T> gid_of_key;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(gids[i] < first_occurence.size());
+    if (check_positions) {
+      REQUIRE(builder.original_positions_sink()[gids[i]] == first_occurence.at(keys[i]));
+    }
+    auto const [it, inserted] = gid_of_key.try_emplace(keys[i], gids[i]);
+    REQUIRE(it->second == gids[i]);
+  }
+}
+
+template <class SimdStyle, class HintSet>
+void test_growth(std::vector<typename SimdStyle::base_type> const &keys, size_t initial_bucket_count) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t, HintSet>::growable_builder_t;
+  constexpr double max_load_factor = 0.6;
+
+  std::map<T, size_t> first_occurence;
+  builder_t builder(initial_bucket_count, max_load_factor);
+  // Insert in a few calls, the group ids of the first call must survive the resizes.
+  size_t const first_call = keys.size() / 10;
+  builder(keys.data(), first_call);
+  for (size_t i = 0; i < first_call; ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+  std::vector<T> early_gids(first_call);
+  builder.grouper()(early_gids.data(), keys.data(), first_call);
+
+  for (size_t begin = first_call; begin < keys.size(); begin += 4099) {
+    auto const count = std::min(keys.size() - begin, size_t{4099});
+    builder(keys.data() + begin, count, begin);
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+  require_groups(builder, keys, first_occurence);
+  REQUIRE(builder.load_factor() <= max_load_factor);
+  if (first_occurence.size() > 64) {
+    REQUIRE(builder.rehash_count() > 0);
+  }
+  std::vector<T> late_gids(first_call);
+  builder.grouper()(late_gids.data(), keys.data(), first_call);
+  REQUIRE(early_gids == late_gids);
+
+  // Merging two halves.
+  builder_t left(initial_bucket_count, max_load_factor);
+  builder_t right(initial_bucket_count, max_load_factor);
+  left(keys.data(), keys.size() / 2);
+  right(keys.data() + keys.size() / 2, keys.size() - keys.size() / 2, keys.size() / 2);
+  left.merge(right);
+  left.finalize();
+  // Merging only keeps the first positions if they are required.
+  require_groups(left, keys, first_occurence,
+                 tuddbs::has_hint<HintSet, tuddbs::hints::grouping::global_first_occurence_required>);
+}
+
+template <class SimdStyle, class HintSet>
+void test_padding_merge() {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t, HintSet>::growable_builder_t;
+  using hasher = hasher_t<SimdStyle, HintSet, tsl::workaround>;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  // The last bucket group starts at the last bucket, all but its first bucket are padding.
+  constexpr size_t bucket_count = 2 * lanes + 1;
+
+  std::vector<T> keys;
+  std::map<T, size_t> first_occurence;
+  for (T key = 1; keys.size() < lanes; ++key) {
+    if (hasher::hash_value(key) % bucket_count == bucket_count - 1) {
+      first_occurence.try_emplace(key, keys.size());
+      keys.push_back(key);
+    }
+  }
+  builder_t right(bucket_count, 0.6);
+  right(keys.data(), keys.size());
+  REQUIRE(right.rehash_count() == 0);
+  builder_t left(bucket_count, 0.6);
+  left.merge(right);
+  left.finalize();
+  require_groups(left, keys, first_occurence,
+                 tuddbs::has_hint<HintSet, tuddbs::hints::grouping::global_first_occurence_required>);
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using namespace hints::hashing;
+  using namespace hints;
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{3}, size_t{1000}, size_t{20000}}) {
+    std::uniform_int_distribution<size_t> key(0, distinct - 1);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) + 1);
+    }
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys, 5);
+    // Bucket counts that are not a power of two keep groups in the padding behind the last bucket.
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement>>(keys, 5);
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement>>(keys, 37);
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, grouping::global_first_occurence_required>>(keys, 37);
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, grouping::global_first_occurence_required,
+                                           memory::huge_pages>>(keys, 5);
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, grouping::batched_insert>>(keys, 5);
+
+    // The key 0 equals the empty bucket value.
+    std::vector<T> zero_keys(elements);
+    for (auto &k : zero_keys) {
+      k = static_cast<T>(key(mt));
+    }
+    zero_keys[elements / 2] = 0;
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_zero>>(zero_keys, 5);
+    test_growth<SimdStyle, OperatorHintSet<linear_displacement, keys_may_contain_zero,
+                                           grouping::global_first_occurence_required>>(zero_keys, 37);
+  }
+  test_padding_merge<SimdStyle, OperatorHintSet<linear_displacement>>();
+  test_padding_merge<SimdStyle, OperatorHintSet<linear_displacement, grouping::global_first_occurence_required>>();
+  REQUIRE_THROWS_AS((typename Group<SimdStyle, size_t>::growable_builder_t(16, 1.0)), std::invalid_argument);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{100 * 1000}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Growable group build, sse", "[sse]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Growable group build, avx2", "[avx2]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Growable group build, avx512", "[avx512]", uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
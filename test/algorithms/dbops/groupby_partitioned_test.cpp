@@ -0,0 +1,135 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_grouping(std::vector<typename SimdStyle::base_type> const &keys, unsigned radix_bits, size_t thread_count,
+                   bool partitioners_in_order) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t, HintSet>::partitioned_builder_t;
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  builder_t builder(radix_bits, 16);
+  // Phase 1: every thread partitions its slice of the input.
+  std::vector<typename builder_t::partitioner_t> partitioners;
+  for (size_t t = 0; t < thread_count; ++t) {
+    partitioners.push_back(builder.make_partitioner());
+  }
+  size_t const elements_per_thread = (keys.size() + thread_count - 1) / thread_count;
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < thread_count; ++t) {
+    // Without the global first hint, the partitioners have to be passed in input order.
+    size_t const slice = partitioners_in_order ? t : thread_count - 1 - t;
+    size_t const begin = std::min(keys.size(), slice * elements_per_thread);
+    size_t const end = std::min(keys.size(), begin + elements_per_thread);
+    pool.emplace_back([&, t, begin, end]() { partitioners[t](keys.data() + begin, end - begin, begin); });
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  pool.clear();
+
+  // Phase 2: every thread builds every thread_count-th partition.
+  for (size_t t = 0; t < thread_count; ++t) {
+    pool.emplace_back([&, t]() {
+      for (size_t p = t; p < builder.partition_count(); p += thread_count) {
+        builder.build_partition(p, partitioners);
+      }
+    });
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+
+  std::vector<T> gids(keys.size());
+  auto const grouper = builder.grouper();
+  grouper(gids.data(), keys.data(), keys.size());
+  std::map<T, T> gid_of_key;
+  std::vector<bool> gid_used(first_occurence.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(gids[i] < first_occurence.size());
+    REQUIRE(builder.original_positions_sink()[gids[i]] == first_occurence[keys[i]]);
+    auto const [it, inserted] = gid_of_key.try_emplace(keys[i], gids[i]);
+    REQUIRE(it->second == gids[i]);
+    if (inserted) {
+      REQUIRE(!gid_used[gids[i]]);
+      gid_used[gids[i]] = true;
+    }
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t>::partitioned_builder_t;
+  REQUIRE_THROWS_AS(builder_t(0), std::invalid_argument);
+  REQUIRE(builder_t::radix_bits_for(1) == 1);
+  REQUIRE(builder_t::radix_bits_for(size_t{1} << 20, size_t{1} << 16) > builder_t::radix_bits_for(size_t{1} << 20));
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{50000}}) {
+    // Keys are never 0, which is the empty bucket value.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    for (unsigned radix_bits : {1u, 4u}) {
+      for (size_t thread_count : {size_t{1}, size_t{3}, size_t{4}}) {
+        test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys, radix_bits, thread_count,
+                                                                                    true);
+        test_grouping<SimdStyle, OperatorHintSet<linear_displacement>>(keys, radix_bits, thread_count, true);
+        test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2,
+                                                 hints::grouping::global_first_occurence_required>>(
+          keys, radix_bits, thread_count, false);
+      }
+    }
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Partitioned group build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Partitioned group build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Partitioned group build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
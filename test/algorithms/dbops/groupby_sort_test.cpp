@@ -0,0 +1,175 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle>
+void test_grouping(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count, size_t split) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = Group<SimdStyle, size_t, OperatorHintSet<hints::grouping::sort_based>>;
+  constexpr T invalid_gid = std::numeric_limits<T>::max();
+
+  std::map<T, size_t> first_occurence;
+  std::map<T, uint64_t> expected_sums;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+    expected_sums[keys[i]] += i;
+  }
+
+  std::vector<T> key_sink(map_count);
+  std::vector<T> gid_sink(map_count);
+  std::vector<size_t> position_sink(map_count);
+  typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  // The second half is collected by another builder, as a second thread would do.
+  std::vector<T> other_key_sink(map_count);
+  std::vector<T> other_gid_sink(map_count);
+  std::vector<size_t> other_position_sink(map_count);
+  typename group_t::builder_t other(other_key_sink.data(), other_gid_sink.data(), other_position_sink.data(),
+                                    map_count);
+  builder(keys.data(), split, 0);
+  other(keys.data() + split, keys.size() - split, split);
+  builder.merge(other);
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+  REQUIRE(builder.row_count() == keys.size());
+
+  std::vector<T> gids(keys.size());
+  typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  grouper(gids.data(), keys.data(), keys.size());
+  std::vector<T> build_gids(keys.size(), invalid_gid);
+  builder.group_ids(build_gids.data());
+  REQUIRE(build_gids == gids);
+
+  std::vector<uint64_t> values(keys.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  std::vector<uint64_t> sums(first_occurence.size());
+  builder.template sum<uint64_t>(values.data(), sums.data());
+
+  std::map<T, T> gid_of_key;
+  std::vector<bool> gid_used(first_occurence.size(), false);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(gids[i] < first_occurence.size());
+    REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+    REQUIRE(sums[gids[i]] == expected_sums[keys[i]]);
+    auto const [it, inserted] = gid_of_key.try_emplace(keys[i], gids[i]);
+    REQUIRE(it->second == gids[i]);
+    if (inserted) {
+      REQUIRE(!gid_used[gids[i]]);
+      gid_used[gids[i]] = true;
+    }
+  }
+  // Group ids follow the key order.
+  T expected_gid = 0;
+  for (auto const &[key, gid] : gid_of_key) {
+    REQUIRE(gid == expected_gid++);
+  }
+
+  // Keys without a group.
+  std::vector<T> missing;
+  for (auto const &[key, position] : first_occurence) {
+    if (key < std::numeric_limits<T>::max() && !first_occurence.contains(static_cast<T>(key + 1))) {
+      missing.push_back(static_cast<T>(key + 1));
+    }
+  }
+  missing.push_back(std::numeric_limits<T>::min());
+  missing.push_back(std::numeric_limits<T>::max());
+  std::vector<T> missing_gids(missing.size());
+  grouper(missing_gids.data(), missing.data(), missing.size());
+  for (size_t i = 0; i < missing.size(); ++i) {
+    if (!first_occurence.contains(missing[i])) {
+      REQUIRE(missing_gids[i] == invalid_gid);
+    }
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{100000}}) {
+    std::uniform_int_distribution<size_t> key(0, distinct - 1);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    size_t const map_count = std::min(elements, distinct) + 5;
+    test_grouping<SimdStyle>(keys, map_count, 0);
+    test_grouping<SimdStyle>(keys, map_count, elements / 3);
+  }
+
+  using group_t = Group<SimdStyle, size_t, OperatorHintSet<hints::grouping::sort_based>>;
+  {
+    // Positions far beyond the number of collected keys.
+    constexpr size_t start_position = size_t{1} << 20;
+    std::uniform_int_distribution<size_t> key(0, 999);
+    std::vector<T> keys(5000);
+    std::map<T, size_t> first_occurence;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = static_cast<T>(key(mt) * 7919);
+      first_occurence.try_emplace(keys[i], start_position + i);
+    }
+    std::vector<T> key_sink(keys.size());
+    std::vector<T> gid_sink(keys.size());
+    std::vector<size_t> position_sink(keys.size());
+    typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), keys.size());
+    builder(keys.data(), keys.size(), start_position);
+    builder.finalize();
+    REQUIRE(builder.distinct_key_count() == first_occurence.size());
+    std::vector<T> gids(keys.size());
+    typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), keys.size());
+    grouper(gids.data(), keys.data(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      REQUIRE(key_sink[gids[i]] == keys[i]);
+      REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+    }
+  }
+
+  std::vector<T> keys{1, 2, 3};
+  std::vector<T> key_sink(2);
+  std::vector<T> gid_sink(2);
+  std::vector<size_t> position_sink(2);
+  typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), 2);
+  builder(keys.data(), keys.size());
+  REQUIRE_THROWS_AS(builder.finalize(), std::length_error);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Sort-based group build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Sort-based group build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Sort-based group build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,147 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_grouping(std::filesystem::path const &spill_directory, std::vector<typename SimdStyle::base_type> const &keys,
+                   size_t memory_budget, unsigned radix_bits, bool must_spill) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t, HintSet>::spilling_builder_t;
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  builder_t builder(spill_directory, memory_budget, radix_bits, 16);
+  // Two chunks, the second one with explicit positions.
+  auto const half = keys.size() / 2;
+  builder(keys.data(), half);
+  std::vector<size_t> positions(keys.size() - half);
+  for (size_t i = 0; i < positions.size(); ++i) {
+    positions[i] = half + i;
+  }
+  builder.insert_at_positions(keys.data() + half, positions.size(), positions.data());
+  bool const spilled = builder.spilled_partition_count() > 0;
+  REQUIRE((spilled || !must_spill));
+  // Partitions without groups are never spilled.
+  REQUIRE(builder.spilled_partition_count() <= first_occurence.size());
+  if (memory_budget >= (size_t{1} << 30)) {
+    REQUIRE(!spilled);
+  }
+  // Spill files are unlinked when they are created.
+  REQUIRE(std::filesystem::is_empty(spill_directory));
+
+  std::map<T, size_t> groups;
+  auto const group_count = builder.finalize([&groups](T key, size_t first_position) {
+    REQUIRE(groups.try_emplace(key, first_position).second);
+  });
+  REQUIRE(group_count == first_occurence.size());
+  REQUIRE(groups == first_occurence);
+  REQUIRE((builder.spilled_bytes() > 0) == spilled);
+}
+
+template <class SimdStyle, class HintSet>
+void test_single_key(std::filesystem::path const &spill_directory, size_t elements, unsigned radix_bits) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = typename Group<SimdStyle, size_t, HintSet>::spilling_builder_t;
+  constexpr size_t hash_bits = sizeof(T) * CHAR_BIT - (std::is_signed_v<T> ? 1 : 0);
+
+  // A budget below the empty tables spills the only partition that holds a group, on every level.
+  std::vector<T> keys(elements, T{42});
+  builder_t builder(spill_directory, 1, radix_bits, 16);
+  builder(keys.data(), keys.size());
+  REQUIRE(builder.spilled_partition_count() == 1);
+  size_t groups = 0;
+  REQUIRE(builder.finalize([&groups](T key, size_t first_position) {
+    REQUIRE(key == T{42});
+    REQUIRE(first_position == 0);
+    ++groups;
+  }) == 1);
+  REQUIRE(groups == 1);
+  // The keys of a batch are appended once per distinct key, so every level writes a single block.
+  REQUIRE(builder.spilled_bytes() > 0);
+  REQUIRE(builder.spilled_bytes() <= hash_bits / radix_bits * builder_t::run_t::block_bytes);
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using hints_t = OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement>;
+  using zero_hints_t = OperatorHintSet<hints::hashing::linear_displacement, hints::hashing::keys_may_contain_zero>;
+  using direct_hints_t =
+    OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::linear_displacement, hints::grouping::spill_direct_io>;
+  using builder_t = typename Group<SimdStyle, size_t, hints_t>::spilling_builder_t;
+
+  auto const spill_directory =
+    std::filesystem::temp_directory_path() / ("simdops_spilling_test_" + std::to_string(seed));
+  std::filesystem::create_directories(spill_directory);
+  REQUIRE_THROWS_AS(builder_t(spill_directory, 1024, 0), std::invalid_argument);
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{1000}, size_t{100000}}) {
+    std::uniform_int_distribution<size_t> key(0, distinct - 1);
+    std::vector<T> keys(elements);
+    std::vector<T> keys_with_zero(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      // Keys are never 0, which is the empty bucket value, unless the hints allow it.
+      keys[i] = static_cast<T>((key(mt) + 1) * 7919);
+      keys_with_zero[i] = static_cast<T>(key(mt) * 7919);
+    }
+    // 64 KiB force 100000 groups to spill, recursively.
+    bool const spills = elements > 1000 && distinct >= 100000;
+    test_grouping<SimdStyle, hints_t>(spill_directory, keys, size_t{1} << 30, 4, false);
+    test_grouping<SimdStyle, hints_t>(spill_directory, keys, size_t{64} << 10, 4, spills);
+    test_grouping<SimdStyle, hints_t>(spill_directory, keys, size_t{64} << 10, 2, spills);
+    test_grouping<SimdStyle, direct_hints_t>(spill_directory, keys, size_t{64} << 10, 3, spills);
+    test_grouping<SimdStyle, zero_hints_t>(spill_directory, keys_with_zero, size_t{1} << 30, 4, false);
+    test_grouping<SimdStyle, zero_hints_t>(spill_directory, keys_with_zero, size_t{64} << 10, 4, spills);
+  }
+  if (elements > 0) {
+    test_single_key<SimdStyle, hints_t>(spill_directory, elements, 4);
+  }
+  std::filesystem::remove(spill_directory);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{256 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Spilling grouping, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Spilling grouping, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Spilling grouping, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
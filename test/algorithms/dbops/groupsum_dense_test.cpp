@@ -0,0 +1,127 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_sums(std::vector<typename SimdStyle::base_type> const &keys,
+               std::vector<typename SimdStyle::base_type> const &values, size_t split) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = GroupAggregate_Sum<SimdStyle, T, HintSet, tsl::workaround, int64_t>;
+
+  std::map<T, int64_t> expected;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    expected[keys[i]] += values[i];
+  }
+
+  auto const [min_key, max_key] = group_t::builder_t::key_range(keys.data(), keys.size());
+  REQUIRE(min_key == expected.begin()->first);
+  REQUIRE(max_key == expected.rbegin()->first);
+  size_t const key_count = static_cast<size_t>(max_key - min_key) + 1;
+
+  std::vector<T> key_sink(key_count);
+  std::vector<int64_t> value_sink(key_count);
+  typename group_t::builder_t builder(key_sink.data(), value_sink.data(), key_count, min_key);
+  // The second part is aggregated by another builder, as a second thread would do.
+  std::vector<T> other_key_sink(key_count);
+  std::vector<int64_t> other_value_sink(key_count);
+  typename group_t::builder_t other(other_key_sink.data(), other_value_sink.data(), key_count, min_key);
+  builder(keys.data(), split, values.data());
+  other(keys.data() + split, keys.size() - split, values.data() + split);
+  builder.merge(other);
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == expected.size());
+  REQUIRE(!builder.overflow_detected());
+
+  std::vector<T> group_keys(key_count + 1);
+  std::vector<int64_t> group_sums(key_count + 1);
+  REQUIRE((builder.empty_bucket_value() < min_key || builder.empty_bucket_value() > max_key));
+  typename group_t::grouper_t grouper(key_sink.data(), value_sink.data(), key_count, builder.empty_bucket_value());
+  grouper(group_keys.data(), group_sums.data());
+  std::map<T, int64_t> result;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    result[group_keys[i]] = group_sums[i];
+  }
+  REQUIRE(result == expected);
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using dense_t = OperatorHintSet<hints::grouping::dense_keys>;
+
+  std::mt19937_64 mt(seed);
+  // Signed ranges contain 0, unsigned ranges start at 0 or at the lowest key.
+  T const min_key = std::is_signed_v<T> ? static_cast<T>(-1000) : static_cast<T>(0);
+  for (size_t range : {size_t{1}, size_t{17}, size_t{3000}}) {
+    std::uniform_int_distribution<size_t> key(0, range - 1);
+    std::uniform_int_distribution<int> value(-100, 100);
+    std::vector<T> keys(elements);
+    std::vector<T> values(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      keys[i] = static_cast<T>(min_key + static_cast<T>(key(mt)));
+      values[i] = std::is_signed_v<T> ? static_cast<T>(value(mt)) : static_cast<T>(value(mt) + 100);
+    }
+    test_sums<SimdStyle, dense_t>(keys, values, elements);
+    test_sums<SimdStyle, dense_t>(keys, values, elements / 3);
+    test_sums<SimdStyle, OperatorHintSet<hints::grouping::dense_keys, hints::arithmetic::checked>>(keys, values,
+                                                                                                   elements / 2);
+  }
+
+  // The key 0 and the lowest key form groups, even if the sum of a group is 0.
+  std::vector<T> edge_keys{0, 1, 0, 2, 0};
+  std::vector<T> edge_values{0, 5, 0, 7, 0};
+  test_sums<SimdStyle, dense_t>(edge_keys, edge_values, 2);
+  std::vector<T> lowest_keys{std::numeric_limits<T>::lowest(), static_cast<T>(std::numeric_limits<T>::lowest() + 3)};
+  std::vector<T> lowest_values{3, 4};
+  test_sums<SimdStyle, dense_t>(lowest_keys, lowest_values, 1);
+
+  using checked_t = GroupAggregate_Sum<SimdStyle, T, OperatorHintSet<hints::grouping::dense_keys,
+                                                                      hints::arithmetic::checked>>;
+  std::vector<T> keys{1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+  std::vector<T> values(keys.size(), std::numeric_limits<T>::max() / 4);
+  std::vector<T> key_sink(1);
+  std::vector<T> value_sink(1);
+  typename checked_t::builder_t builder(key_sink.data(), value_sink.data(), 1, 1);
+  builder(keys.data(), keys.size(), values.data());
+  builder.finalize();
+  REQUIRE(builder.overflow_detected());
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Dense group sum, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Dense group sum, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Dense group sum, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
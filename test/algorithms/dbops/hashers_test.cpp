@@ -0,0 +1,180 @@
+#include "algorithms/utils/hashers.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+#include "algorithms/utils/hashing.hpp"
+
+/* A user defined hash function, plugged in via a hint. */
+struct xor_fold_hash {
+  template <tsl::VectorProcessingStyle SimdStyle, typename Idof>
+  struct hasher_t {
+    static auto hash_value(typename SimdStyle::base_type key) {
+      return static_cast<typename SimdStyle::base_type>(key ^ (key >> 4));
+    }
+  };
+};
+
+namespace selection_checks {
+  using namespace tuddbs;
+  using S = tsl::simd<uint64_t, tsl::scalar>;
+  static_assert(std::is_same_v<hasher_t<S, OperatorHintSet<>, tsl::workaround>, default_hasher<S, tsl::workaround>>);
+  static_assert(
+    std::is_same_v<hasher_t<S, OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::identity_hash>,
+                            tsl::workaround>,
+                   identity_hasher<S, tsl::workaround>>);
+  static_assert(std::is_same_v<hasher_t<S, OperatorHintSet<xor_fold_hash, hints::hashing::murmur3_hash>,
+                                        tsl::workaround>,
+                               xor_fold_hash::hasher_t<S, tsl::workaround>>);
+}  // namespace selection_checks
+
+template <class SimdStyle, template <class, class> class Hasher>
+void test_hasher(std::vector<typename SimdStyle::base_type> const &keys, bool mixing) {
+  using T = typename SimdStyle::base_type;
+  using hasher = Hasher<SimdStyle, tsl::workaround>;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  constexpr size_t bucket_count = 1024;
+  std::vector<size_t> bucket_load(bucket_count, 0);
+  std::vector<T> hashes(lanes);
+  for (size_t i = 0; i + lanes <= keys.size(); i += lanes) {
+    tsl::storeu<SimdStyle>(hashes.data(), hasher::hash(tsl::loadu<SimdStyle>(keys.data() + i)));
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      // Registers and single values hash identically.
+      REQUIRE(hashes[lane] == hasher::hash_value(keys[i + lane]));
+      if (mixing) {
+        REQUIRE(hashes[lane] >= 0);
+      }
+      ++bucket_load[static_cast<size_t>(hashes[lane]) & (bucket_count - 1)];
+    }
+  }
+  if (mixing && (sizeof(T) >= sizeof(uint32_t)) && (keys.size() >= 64 * bucket_count)) {
+    // Strided keys share their low bits, the identity would put them all into few buckets.
+    size_t const expected = keys.size() / bucket_count;
+    for (auto load : bucket_load) {
+      REQUIRE(load < 2 * expected);
+    }
+  }
+}
+
+template <class SimdStyle, class HintSet>
+void test_grouping(std::vector<typename SimdStyle::base_type> const &keys) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+  constexpr size_t map_count = 4096;
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+  std::vector<T> key_sink(map_count + SimdStyle::vector_element_count());
+  std::vector<T> gid_sink(map_count + SimdStyle::vector_element_count());
+  std::vector<size_t> position_sink(map_count + SimdStyle::vector_element_count());
+  typename group_t::builder_t builder(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  builder(keys.data(), keys.size());
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+  std::vector<T> gids(keys.size());
+  typename group_t::grouper_t grouper(key_sink.data(), gid_sink.data(), position_sink.data(), map_count);
+  grouper(gids.data(), keys.data(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(position_sink[gids[i]] == first_occurence[keys[i]]);
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  std::mt19937_64 mt(seed);
+
+  std::vector<T> strided(elements);
+  for (size_t i = 0; i < elements; ++i) {
+    strided[i] = static_cast<T>((i + 1) * 1024);
+  }
+  // uniform_int_distribution is undefined for 8-bit types, thus narrower keys are drawn as 32-bit integers.
+  using draw_t =
+    std::conditional_t<(sizeof(T) < sizeof(int32_t)), std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>, T>;
+  std::uniform_int_distribution<draw_t> any(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+  std::vector<T> random(elements);
+  for (auto &key : random) {
+    key = static_cast<T>(any(mt));
+  }
+  for (auto const *keys : {&strided, &random}) {
+    test_hasher<SimdStyle, identity_hasher>(*keys, false);
+    test_hasher<SimdStyle, multiply_shift_hasher>(*keys, true);
+    test_hasher<SimdStyle, murmur3_hasher>(*keys, true);
+    test_hasher<SimdStyle, crc32c_hasher>(*keys, true);
+    test_hasher<SimdStyle, tabulation_hasher>(*keys, true);
+  }
+
+  if constexpr (sizeof(T) == sizeof(uint64_t)) {
+    // Keys that differ only in their high half spread over the buckets as well.
+    std::vector<T> high_strided(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      high_strided[i] = static_cast<T>(static_cast<uint64_t>(i + 1) << 32);
+    }
+    test_hasher<SimdStyle, crc32c_hasher>(high_strided, true);
+    // Two CRCs of the same key would make the upper half of the hash the lower half XOR a constant.
+    using unsigned_hasher = crc32c_hasher<typename SimdStyle::template transform_extension<uint64_t>, tsl::workaround>;
+    std::map<uint64_t, size_t> half_differences;
+    for (auto key : random) {
+      auto const hash = unsigned_hasher::hash_value(static_cast<uint64_t>(key));
+      ++half_differences[(hash >> 32) ^ (hash & 0xFFFFFFFF)];
+    }
+    REQUIRE(((elements < 2) || (half_differences.size() > 1)));
+  }
+
+  if constexpr (std::is_unsigned_v<T> && (sizeof(T) >= sizeof(uint32_t))) {
+    // Multiples of 1024 in a power-of-two table.
+    std::vector<T> keys(std::min(elements, size_t{3000}));
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = static_cast<T>(((i * 7) % 2000 + 1) * 1024);
+    }
+    using namespace hints::hashing;
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(keys);
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, identity_hash>>(keys);
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, multiply_shift_hash>>(keys);
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, crc32c_hash>>(keys);
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, tabulation_hash>>(keys);
+    test_grouping<SimdStyle, OperatorHintSet<linear_displacement, xor_fold_hash>>(keys);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Hash functions, sse", "[sse]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t,
+                   int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Hash functions, avx2", "[avx2]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t,
+                   int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Hash functions, avx512", "[avx512]", uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t,
+                   int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
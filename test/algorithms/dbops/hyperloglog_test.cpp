@@ -0,0 +1,93 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithms/dbops/cardinality/hyperloglog.hpp"
+#include "algorithms/dbops/dbops_hints.hpp"
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using sketch_t = HyperLogLog<SimdStyle>;
+
+  REQUIRE_THROWS_AS(sketch_t{3}, std::invalid_argument);
+  REQUIRE_THROWS_AS(sketch_t{19}, std::invalid_argument);
+  REQUIRE(sketch_t::template bucket_count_for<OperatorHintSet<hints::hashing::size_exp_2>>(1000.0) == 2048);
+  REQUIRE(sketch_t::bucket_count_for(1000.0) == 1429);
+  REQUIRE(sketch_t::bucket_count_for(0.0) == SimdStyle::vector_element_count());
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{1000}, size_t{100000}}) {
+    std::uniform_int_distribution<size_t> key(0, distinct - 1);
+    std::vector<T> keys(elements);
+    for (auto &k : keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    std::vector<bool> seen(distinct, false);
+    size_t actual = 0;
+    for (auto k : keys) {
+      auto const i = static_cast<size_t>(k) / 7919;
+      actual += !seen[i];
+      seen[i] = true;
+    }
+
+    for (unsigned precision : {10u, 14u}) {
+      sketch_t sketch(precision);
+      sketch(keys.data(), keys.size());
+      // Six standard errors.
+      double const tolerance = 6.0 * 1.04 / std::sqrt(static_cast<double>(size_t{1} << precision));
+      REQUIRE(std::abs(sketch.estimate() - static_cast<double>(actual)) <= tolerance * static_cast<double>(actual));
+
+      // Merging the sketches of two halves yields the sketch of all keys.
+      sketch_t first(precision);
+      sketch_t second(precision);
+      first(keys.data(), keys.size() / 2);
+      second(keys.data() + keys.size() / 2, keys.size() - keys.size() / 2);
+      first.merge(second);
+      REQUIRE(first.registers() == sketch.registers());
+
+      auto const buckets = sketch.template recommended_bucket_count<OperatorHintSet<hints::hashing::size_exp_2>>();
+      REQUIRE(std::has_single_bit(buckets));
+      REQUIRE(static_cast<double>(buckets) * 0.7 >= sketch.estimate());
+    }
+  }
+  sketch_t sketch(10);
+  sketch_t other(12);
+  REQUIRE_THROWS_AS(sketch.merge(other), std::invalid_argument);
+  REQUIRE(sketch.estimate() == 0.0);
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{256 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("HyperLogLog, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("HyperLogLog, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("HyperLogLog, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
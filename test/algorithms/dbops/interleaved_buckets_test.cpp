@@ -0,0 +1,233 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/groupby/groupby.hpp"
+#include "algorithms/dbops/join/hash_join.hpp"
+
+template <class BucketGroup>
+void require_cache_line_layout() {
+  // A bucket group fits a cache line and does not straddle two.
+  REQUIRE(sizeof(BucketGroup) <= 64);
+  REQUIRE(alignof(BucketGroup) == sizeof(BucketGroup));
+  REQUIRE(BucketGroup::bucket_count >= 1);
+}
+
+template <class SimdStyle, class HintSet>
+void test_group(std::vector<typename SimdStyle::base_type> const &keys, size_t map_count, std::mt19937_64 &mt) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  using group_t = Group<SimdStyle, size_t, HintSet>;
+  using bucket_group_t = typename group_t::builder_t::BucketGroupType;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  T const unwritten = std::numeric_limits<T>::max();
+  require_cache_line_layout<bucket_group_t>();
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    first_occurence.try_emplace(keys[i], i);
+  }
+
+  auto const group_count = group_t::builder_t::bucket_group_count(map_count);
+  std::vector<bucket_group_t> buckets(group_count);
+  std::vector<size_t> positions(group_count * lanes);
+  std::vector<T> build_gids(keys.size(), unwritten);
+  typename group_t::builder_t builder(buckets.data(), positions.data(), map_count);
+  builder.build_with_gids(build_gids.data(), keys.data(), keys.size());
+  builder.finalize();
+  REQUIRE(builder.distinct_key_count() == first_occurence.size());
+
+  typename group_t::grouper_t grouper(buckets.data(), map_count);
+  std::vector<T> gids(keys.size(), unwritten);
+  grouper(gids.data(), keys.data(), keys.size());
+  REQUIRE(gids == build_gids);
+  std::map<T, T> gid_of_key;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(positions[gids[i]] == first_occurence[keys[i]]);
+    REQUIRE(gid_of_key.try_emplace(keys[i], gids[i]).first->second == gids[i]);
+  }
+  std::set<T> distinct_gids;
+  for (auto const &[key, gid] : gid_of_key) {
+    distinct_gids.insert(gid);
+  }
+  REQUIRE(distinct_gids.size() == gid_of_key.size());
+
+  // Two halves built separately and merged yield the same groups.
+  std::vector<bucket_group_t> first_buckets(group_count);
+  std::vector<size_t> first_positions(group_count * lanes);
+  std::vector<bucket_group_t> second_buckets(group_count);
+  std::vector<size_t> second_positions(group_count * lanes);
+  typename group_t::builder_t first(first_buckets.data(), first_positions.data(), map_count);
+  typename group_t::builder_t second(second_buckets.data(), second_positions.data(), map_count);
+  first(keys.data(), keys.size() / 2);
+  second(keys.data() + keys.size() / 2, keys.size() - keys.size() / 2, keys.size() / 2);
+  first.merge(second);
+  REQUIRE(first.distinct_key_count() == first_occurence.size());
+  typename group_t::grouper_t merged_grouper(first_buckets.data(), map_count);
+  std::vector<T> merged_gids(keys.size(), unwritten);
+  merged_grouper(merged_gids.data(), keys.data(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    REQUIRE(first_positions[merged_gids[i]] == first_occurence[keys[i]]);
+  }
+
+  if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+    std::uniform_int_distribution<uint64_t> bits;
+    std::vector<imask_t> masks((keys.size() + lanes - 1) / lanes);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    std::vector<T> masked_gids(keys.size(), unwritten);
+    grouper(masked_gids.data(), keys.data(), keys.size(), masks.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      bool const valid = ((masks[i / lanes] >> (i % lanes)) & 1) != 0;
+      REQUIRE(masked_gids[i] == (valid ? gids[i] : unwritten));
+    }
+  }
+
+  if constexpr (has_any_hint<HintSet, hints::intermediate::bit_mask, hints::intermediate::dense_bit_mask>) {
+    // Only the selected keys are inserted, their positions count the selected keys.
+    constexpr size_t bits_per_mask =
+      has_hint<HintSet, hints::intermediate::bit_mask> ? lanes : sizeof(imask_t) * CHAR_BIT;
+    std::uniform_int_distribution<uint64_t> bits;
+    std::vector<imask_t> masks((keys.size() + bits_per_mask - 1) / bits_per_mask);
+    for (auto &mask : masks) {
+      mask = static_cast<imask_t>(bits(mt));
+    }
+    std::map<T, size_t> first_selected;
+    size_t selected_count = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (((masks[i / bits_per_mask] >> (i % bits_per_mask)) & 1) != 0) {
+        first_selected.try_emplace(keys[i], selected_count++);
+      }
+    }
+    std::vector<bucket_group_t> masked_buckets(group_count);
+    std::vector<size_t> masked_positions(group_count * lanes);
+    typename group_t::builder_t masked_builder(masked_buckets.data(), masked_positions.data(), map_count);
+    masked_builder(keys.data(), keys.size(), masks.data());
+    REQUIRE(masked_builder.distinct_key_count() == first_selected.size());
+    typename group_t::grouper_t masked_grouper(masked_buckets.data(), map_count);
+    for (auto const &[key, position] : first_selected) {
+      T probe_key = key;
+      T gid = unwritten;
+      masked_grouper(&gid, &probe_key, size_t{1});
+      REQUIRE(gid < first_selected.size());
+      REQUIRE(masked_positions[gid] == position);
+    }
+  }
+}
+
+template <class SimdStyle, class HintSet>
+void test_join(std::vector<typename SimdStyle::base_type> const &build_keys,
+               std::vector<typename SimdStyle::base_type> const &probe_keys, size_t map_count) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using join_t = Hash_Join<SimdStyle, size_t, HintSet>;
+  using bucket_group_t = typename join_t::builder_t::BucketGroupType;
+  require_cache_line_layout<bucket_group_t>();
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < build_keys.size(); ++i) {
+    first_occurence.try_emplace(build_keys[i], i);
+  }
+
+  auto const group_count = join_t::builder_t::bucket_group_count(map_count);
+  std::vector<bucket_group_t> buckets(group_count);
+  std::vector<bucket_group_t> other_buckets(group_count);
+  typename join_t::builder_t builder(buckets.data(), map_count);
+  typename join_t::builder_t other(other_buckets.data(), map_count);
+  auto const half = build_keys.size() / 2;
+  REQUIRE(builder(build_keys.data(), half) == half);
+  REQUIRE(other(build_keys.data() + half, build_keys.size() - half, half) == build_keys.size() - half);
+  REQUIRE(builder.merge(other));
+  builder.finalize();
+  REQUIRE(builder.get_used_bucket_count() == first_occurence.size());
+
+  std::vector<size_t> build_positions(probe_keys.size());
+  std::vector<size_t> probe_positions(probe_keys.size());
+  typename join_t::prober_t prober(buckets.data(), map_count);
+  auto const matches =
+    prober(build_positions.data(), probe_positions.data(), probe_keys.data(), probe_keys.size());
+  size_t expected_matches = 0;
+  for (auto key : probe_keys) {
+    expected_matches += first_occurence.contains(key);
+  }
+  REQUIRE(matches == expected_matches);
+  for (size_t i = 0; i < matches; ++i) {
+    auto const key = probe_keys[probe_positions[i]];
+    REQUIRE(build_positions[i] == first_occurence[key]);
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using first_t = hints::grouping::global_first_occurence_required;
+  using join_first_t = hints::hash_join::global_first_occurence_required;
+  using T = typename SimdStyle::base_type;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{3000}}) {
+    // Keys start at 1, 0 is the empty bucket value, unless the hints allow it.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> keys(elements);
+    std::vector<T> keys_with_zero(elements);
+    std::vector<T> probe_keys(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      keys[i] = static_cast<T>(key(mt) * 7919);
+      keys_with_zero[i] = static_cast<T>((key(mt) - 1) * 7919);
+      probe_keys[i] = static_cast<T>((key(mt) * 2 - 1) * 7919);
+    }
+    test_group<SimdStyle, OperatorHintSet<interleaved_buckets, size_exp_2, first_t>>(keys, 4096, mt);
+    test_group<SimdStyle, OperatorHintSet<interleaved_buckets, first_t>>(keys, 4001, mt);
+    test_group<SimdStyle, OperatorHintSet<interleaved_buckets, size_exp_2, first_t, hints::intermediate::bit_mask>>(
+      keys, 4096, mt);
+    test_group<SimdStyle, OperatorHintSet<interleaved_buckets, first_t, hints::intermediate::dense_bit_mask>>(
+      keys, 4001, mt);
+    test_group<SimdStyle, OperatorHintSet<interleaved_buckets, first_t, keys_may_contain_zero>>(keys_with_zero, 4001,
+                                                                                                mt);
+
+    test_join<SimdStyle, OperatorHintSet<interleaved_buckets, size_exp_2, join_first_t>>(keys, probe_keys, 4096);
+    test_join<SimdStyle, OperatorHintSet<interleaved_buckets, join_first_t>>(keys, probe_keys, 4001);
+    test_join<SimdStyle, OperatorHintSet<interleaved_buckets, join_first_t,
+                                         hints::hash_join::keys_may_contain_empty_indicator>>(keys_with_zero,
+                                                                                              keys_with_zero, 4001);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{61}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Interleaved bucket groups, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Interleaved bucket groups, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Interleaved bucket groups, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
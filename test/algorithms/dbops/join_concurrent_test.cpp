@@ -0,0 +1,150 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/join/hash_join.hpp"
+
+template <class SimdStyle, class HintSet>
+void test_join(std::vector<typename SimdStyle::base_type> const &build_keys,
+               std::vector<typename SimdStyle::base_type> const &probe_keys, size_t map_count, size_t thread_count) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using join_t = Hash_Join<SimdStyle, size_t, HintSet>;
+  constexpr bool duplicates = has_hint<HintSet, hints::hash_join::keys_may_contain_empty_indicator>;
+
+  std::map<T, size_t> first_occurence;
+  for (size_t i = 0; i < build_keys.size(); ++i) {
+    first_occurence.try_emplace(build_keys[i], i);
+  }
+
+  std::vector<T> key_sink(map_count);
+  std::vector<T> used_sink(map_count);
+  std::vector<size_t> position_sink(map_count);
+  typename join_t::concurrent_builder_t builder(key_sink.data(), used_sink.data(), position_sink.data(), map_count);
+
+  constexpr size_t slice = 97;
+  std::vector<std::thread> pool;
+  std::vector<size_t> inserted(thread_count, 0);
+  for (size_t t = 0; t < thread_count; ++t) {
+    pool.emplace_back([&, t]() {
+      for (size_t begin = t * slice; begin < build_keys.size(); begin += thread_count * slice) {
+        auto const count = std::min(slice, build_keys.size() - begin);
+        inserted[t] += builder(build_keys.data() + begin, count, begin);
+      }
+    });
+  }
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  builder.finalize();
+  size_t inserted_count = 0;
+  for (auto count : inserted) {
+    inserted_count += count;
+  }
+  REQUIRE(inserted_count == build_keys.size());
+  REQUIRE(builder.distinct_key_count() == (duplicates ? build_keys.size() : first_occurence.size()));
+
+  std::vector<size_t> build_positions(probe_keys.size());
+  std::vector<size_t> probe_positions(probe_keys.size());
+  typename join_t::prober_t prober(key_sink.data(), used_sink.data(), position_sink.data(), map_count);
+  auto const result_count =
+    prober(build_positions.data(), probe_positions.data(), probe_keys.data(), probe_keys.size());
+  size_t expected_count = 0;
+  for (auto key : probe_keys) {
+    expected_count += first_occurence.count(key);
+  }
+  REQUIRE(result_count == expected_count);
+  for (size_t i = 0; i < result_count; ++i) {
+    auto const key = probe_keys[probe_positions[i]];
+    REQUIRE(build_keys[build_positions[i]] == key);
+    if constexpr (has_hint<HintSet, hints::hash_join::global_first_occurence_required>) {
+      REQUIRE(build_positions[i] == first_occurence[key]);
+    }
+  }
+
+  if constexpr (duplicates) {
+    // Every build key has its own bucket.
+    std::map<T, size_t> occurences;
+    for (auto key : build_keys) {
+      ++occurences[key];
+    }
+    std::map<T, size_t> stored;
+    std::vector<bool> position_stored(build_keys.size(), false);
+    for (size_t i = 0; i < map_count; ++i) {
+      if (used_sink[i] == builder.full_bucket_indicator()) {
+        ++stored[key_sink[i]];
+        REQUIRE(build_keys[position_sink[i]] == key_sink[i]);
+        REQUIRE(!position_stored[position_sink[i]]);
+        position_stored[position_sink[i]] = true;
+      }
+    }
+    REQUIRE(stored == occurences);
+  }
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using namespace hints::hashing;
+  using namespace hints::hash_join;
+  using T = typename SimdStyle::base_type;
+
+  std::mt19937_64 mt(seed);
+  for (size_t distinct : {size_t{1}, size_t{300}, size_t{1500}}) {
+    // Keys are never 0, which is the empty bucket value.
+    std::uniform_int_distribution<size_t> key(1, distinct);
+    std::vector<T> build_keys(std::min(elements, size_t{1500}));
+    for (auto &k : build_keys) {
+      k = static_cast<T>(key(mt) * 7919);
+    }
+    std::uniform_int_distribution<size_t> probe_key(1, 2 * distinct);
+    std::vector<T> probe_keys(elements);
+    for (auto &k : probe_keys) {
+      k = static_cast<T>(probe_key(mt) * 7919);
+    }
+    for (size_t thread_count : {size_t{1}, size_t{4}}) {
+      test_join<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, global_first_occurence_required>>(
+        build_keys, probe_keys, 4096, thread_count);
+      test_join<SimdStyle, OperatorHintSet<linear_displacement, global_first_occurence_required>>(
+        build_keys, probe_keys, 3001, thread_count);
+      test_join<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2>>(build_keys, probe_keys, 4096,
+                                                                             thread_count);
+      test_join<SimdStyle, OperatorHintSet<linear_displacement, size_exp_2, keys_may_contain_empty_indicator>>(
+        build_keys, probe_keys, 4096, thread_count);
+    }
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Concurrent join build, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Concurrent join build, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Concurrent join build, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,175 @@
+#include "algorithms/dbops/arithmetic/moments.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+struct reference_moments_t {
+  size_t count = 0;
+  long double mean = 0;
+  long double mean_y = 0;
+  long double m2 = 0;
+  long double m2_y = 0;
+  long double co_moment = 0;
+};
+
+/* Two-pass reference in long double. */
+template <typename T, typename imask_t>
+reference_moments_t reference_moments(std::vector<T> const &x, std::vector<T> const &y,
+                                      std::vector<imask_t> const *bit_mask, size_t lanes) {
+  auto const selected = [&](size_t i) {
+    return (bit_mask == nullptr) || ((((*bit_mask)[i / lanes]) >> (i % lanes)) & 1);
+  };
+  reference_moments_t result;
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (selected(i)) {
+      ++result.count;
+      result.mean += x[i];
+      result.mean_y += y[i];
+    }
+  }
+  if (result.count == 0) {
+    return result;
+  }
+  result.mean /= result.count;
+  result.mean_y /= result.count;
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (selected(i)) {
+      result.m2 += (x[i] - result.mean) * (x[i] - result.mean);
+      result.m2_y += (y[i] - result.mean_y) * (y[i] - result.mean_y);
+      result.co_moment += (x[i] - result.mean) * (y[i] - result.mean_y);
+    }
+  }
+  return result;
+}
+
+template <typename T>
+void require_close(T is, long double should, long double magnitude) {
+  // Welford updates lose a few digits relative to the magnitude of the moments, not of the raw values.
+  long double const tolerance = (std::is_same_v<T, float> ? 1e-3L : 1e-9L) * (std::fabs(magnitude) + 1);
+  REQUIRE(std::fabs(is - should) <= tolerance);
+}
+
+template <typename T>
+void require_close(tuddbs::arithmetic_moments_t<T> const &is, reference_moments_t const &should, bool with_y) {
+  REQUIRE(is.count == should.count);
+  if (should.count == 0) {
+    return;
+  }
+  require_close(is.mean, should.mean, should.mean);
+  require_close(is.m2, should.m2, should.m2);
+  if (with_y) {
+    require_close(is.mean_y, should.mean_y, should.mean_y);
+    require_close(is.m2_y, should.m2_y, should.m2_y);
+    require_close(is.co_moment, should.co_moment, std::sqrt(should.m2 * should.m2_y));
+  }
+}
+
+template <class SimdStyle, class HintSet>
+auto partitioned_moments(auto const &x, auto const &y, auto const &bit_mask, size_t partition_count) {
+  using namespace tuddbs;
+  using moments_t = StreamingMoments<SimdStyle, HintSet>;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+  moments_t result;
+  for (size_t p = 0; p < partition_count; ++p) {
+    // Partitions start at mask boundaries.
+    auto const begin = std::min(x.size(), ((p * x.size()) / partition_count) / lanes * lanes);
+    auto const end = std::min(x.size(), (((p + 1) * x.size()) / partition_count) / lanes * lanes);
+    auto const count = (p + 1 == partition_count) ? x.size() - begin : end - begin;
+    moments_t partial;
+    if constexpr (has_hint<HintSet, hints::arithmetic::covariance>) {
+      if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+        partial(x.data() + begin, count, y.data() + begin, bit_mask.data() + begin / lanes);
+      } else {
+        partial(x.data() + begin, count, y.data() + begin);
+      }
+    } else {
+      if constexpr (has_hint<HintSet, hints::intermediate::bit_mask>) {
+        partial(x.data() + begin, count, bit_mask.data() + begin / lanes);
+      } else {
+        partial(x.data() + begin, count);
+      }
+    }
+    result.merge(partial);
+  }
+  result.finalize();
+  return result.result();
+}
+
+template <class SimdStyle>
+void test(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using imask_t = typename SimdStyle::imask_type;
+  constexpr size_t lanes = SimdStyle::vector_element_count();
+
+  std::mt19937_64 mt(seed);
+  // A large offset compared to the deviation, where the sum-of-squares formula cancels.
+  std::normal_distribution<T> noise(0, 1);
+  std::bernoulli_distribution selected(0.3);
+  std::vector<T> x(elements);
+  std::vector<T> y(elements);
+  std::vector<imask_t> bit_mask(elements / lanes + 1, 0);
+  for (size_t i = 0; i < elements; ++i) {
+    x[i] = 1000 + noise(mt);
+    y[i] = -2 * x[i] + noise(mt);
+    if (selected(mt)) {
+      bit_mask[i / lanes] |= static_cast<imask_t>(imask_t{1} << (i % lanes));
+    }
+  }
+
+  auto const expected_all = reference_moments(x, y, static_cast<std::vector<imask_t> const *>(nullptr), lanes);
+  auto const expected_selected = reference_moments(x, y, &bit_mask, lanes);
+
+  using all_t = OperatorHintSet<hints::intermediate::position_list>;
+  using selected_t = OperatorHintSet<hints::intermediate::bit_mask>;
+  using all_co_t = OperatorHintSet<hints::intermediate::position_list, hints::arithmetic::covariance>;
+  using selected_co_t = OperatorHintSet<hints::intermediate::bit_mask, hints::arithmetic::covariance>;
+  for (size_t partition_count : {1, 3, 8}) {
+    require_close(partitioned_moments<SimdStyle, all_t>(x, y, bit_mask, partition_count), expected_all, false);
+    require_close(partitioned_moments<SimdStyle, selected_t>(x, y, bit_mask, partition_count), expected_selected,
+                  false);
+    require_close(partitioned_moments<SimdStyle, all_co_t>(x, y, bit_mask, partition_count), expected_all, true);
+    require_close(partitioned_moments<SimdStyle, selected_co_t>(x, y, bit_mask, partition_count), expected_selected,
+                  true);
+  }
+
+  if (elements > 1) {
+    auto const moments = partitioned_moments<SimdStyle, all_co_t>(x, y, bit_mask, 1);
+    require_close(moments.sample_variance(), expected_all.m2 / (elements - 1), 1);
+    require_close(moments.population_covariance(), expected_all.co_moment / elements, 2);
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  for (size_t elements : {size_t{0}, size_t{1}, size_t{1000}, size_t{1024 * 1024 + 3}}) {
+    test<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Streaming moments, sse", "[sse]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Streaming moments, avx2", "[avx2]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Streaming moments, avx512", "[avx512]", float, double) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,111 @@
+#include "datastructures/rank_select_index.hpp"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+
+template <class SimdStyle, class HintSet>
+bool test_rank_select(size_t elements, double selectivity, size_t seed) {
+  using index_t = tuddbs::RankSelectIndex<SimdStyle, HintSet>;
+  using mask_t = typename SimdStyle::imask_type;
+  constexpr size_t bits_per_mask = index_t::bits_per_mask;
+
+  std::mt19937_64 mt(seed);
+  std::bernoulli_distribution dist(selectivity);
+  std::vector<mask_t> masks((elements + bits_per_mask - 1) / bits_per_mask, 0);
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < elements; ++i) {
+    if (dist(mt)) {
+      masks[i / bits_per_mask] |= static_cast<mask_t>(mask_t{1} << (i % bits_per_mask));
+      positions.push_back(i);
+    }
+  }
+
+  index_t index(masks.data(), elements);
+  if (index.count() != positions.size()) {
+    std::cerr << "Count mismatch: " << index.count() << " vs. " << positions.size() << std::endl;
+    return false;
+  }
+  size_t expected_rank = 0;
+  for (size_t i = 0; i <= elements; ++i) {
+    if (index.rank(i) != expected_rank) {
+      std::cerr << "Rank mismatch at " << i << ": " << index.rank(i) << " vs. " << expected_rank << std::endl;
+      return false;
+    }
+    if ((expected_rank < positions.size()) && (positions[expected_rank] == i)) {
+      ++expected_rank;
+    }
+  }
+  for (size_t k = 0; k < positions.size(); ++k) {
+    if (index.select(k) != positions[k]) {
+      std::cerr << "Select mismatch for " << k << ": " << index.select(k) << " vs. " << positions[k] << std::endl;
+      return false;
+    }
+  }
+  if (index.select(positions.size()) != elements) {
+    return false;
+  }
+
+  for (size_t partition_count : {1, 3, 8, 31}) {
+    auto const partitions = index.partition(partition_count);
+    size_t next_begin = 0;
+    size_t next_offset = 0;
+    for (auto const &partition : partitions) {
+      if ((partition.begin != next_begin) || (partition.output_offset != next_offset) ||
+          ((partition.begin % bits_per_mask) != 0)) {
+        return false;
+      }
+      next_begin = partition.end;
+      next_offset += partition.output_count;
+      // Every partition gets an equal share of the output, up to the rounding to mask boundaries.
+      if (partition.output_count > (positions.size() / partition_count) + 2 * bits_per_mask) {
+        std::cerr << "Unbalanced partition: " << partition.output_count << " of " << positions.size() << std::endl;
+        return false;
+      }
+    }
+    if ((next_begin != elements) || (next_offset != positions.size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  // The largest bitmask spans several superblocks, with selectivity 0.0005 these are sparser than the select samples.
+  for (size_t elements : {size_t{0}, size_t{1}, size_t{1000}, size_t{200003}, (size_t{1} << 21) + 5}) {
+    for (double selectivity : {0.0, 0.0005, 0.01, 0.5, 1.0}) {
+      REQUIRE(test_rank_select<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::bit_mask>>(
+        elements, selectivity, seed));
+      REQUIRE(test_rank_select<SimdStyle, tuddbs::OperatorHintSet<tuddbs::hints::intermediate::dense_bit_mask>>(
+        elements, selectivity, seed));
+    }
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Rank/Select, sse", "[sse]", uint8_t, uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Rank/Select, avx2", "[avx2]", uint8_t, uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Rank/Select, avx512", "[avx512]", uint8_t, uint32_t, uint64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif
@@ -0,0 +1,229 @@
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "algorithms/dbops/dbops_hints.hpp"
+#include "algorithms/dbops/group_aggregate/group_sum.hpp"
+#include "algorithms/dbops/groupby/groupby_simd_linear_displacement.hpp"
+#include "algorithms/dbops/join/hash_join_simd_linear_probing.hpp"
+#include "algorithms/utils/table_init.hpp"
+
+template <class SimdStyle>
+void test_fill(const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  std::mt19937_64 mt(seed);
+  // The last count exceeds non_temporal_fill_threshold.
+  for (size_t count : {size_t{0}, size_t{1}, SimdStyle::vector_element_count() + 1, size_t{100003},
+                       tuddbs::non_temporal_fill_threshold / sizeof(T) + 7}) {
+    for (size_t threads : {size_t{1}, size_t{3}}) {
+      // The sink starts one element behind an aligned address and is surrounded by guard values.
+      std::vector<T> sink(count + 2, static_cast<T>(7));
+      auto const value = static_cast<T>(mt());
+      fill_sink<SimdStyle>(sink.data() + 1, count, value, threads);
+      REQUIRE(sink.front() == static_cast<T>(7));
+      REQUIRE(sink.back() == static_cast<T>(7));
+      REQUIRE(std::count(sink.begin() + 1, sink.end() - 1, value) == static_cast<std::ptrdiff_t>(count));
+    }
+  }
+}
+
+template <class SimdStyle>
+auto random_keys(std::mt19937_64 &mt, size_t elements, size_t distinct) {
+  using T = typename SimdStyle::base_type;
+  // Keys are never 0, which is the empty bucket value.
+  std::uniform_int_distribution<size_t> key(1, distinct);
+  std::vector<T> keys(elements);
+  for (auto &k : keys) {
+    k = static_cast<T>(key(mt) * 31);
+  }
+  return keys;
+}
+
+template <class SimdStyle>
+void test_group(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = Grouper_Build_Hash_SIMD_Linear_Displacement<
+    SimdStyle, size_t, OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::reusable_table>>;
+  std::mt19937_64 mt(seed);
+  constexpr size_t map_count = 4096;
+  std::vector<T> keys(map_count);
+  std::vector<T> gids(map_count);
+  std::vector<size_t> positions(map_count);
+  builder_t builder(keys.data(), gids.data(), positions.data(), map_count, 0, std::numeric_limits<size_t>::max(),
+                    std::numeric_limits<T>::max(), false);
+  builder.initialize_sinks(4);
+
+  std::vector<T> fresh_keys(map_count);
+  std::vector<T> fresh_gids(map_count);
+  std::vector<size_t> fresh_positions(map_count);
+  for (size_t distinct : {size_t{1}, size_t{200}, size_t{2000}, size_t{50}}) {
+    auto const data = random_keys<SimdStyle>(mt, elements, distinct);
+    builder(data.data(), data.size());
+    builder_t fresh(fresh_keys.data(), fresh_gids.data(), fresh_positions.data(), map_count);
+    fresh(data.data(), data.size());
+    REQUIRE(builder.distinct_key_count() == fresh.distinct_key_count());
+    REQUIRE(keys == fresh_keys);
+    REQUIRE(gids == fresh_gids);
+    REQUIRE(positions == fresh_positions);
+
+    builder.reset();
+    REQUIRE(builder.distinct_key_count() == 0);
+    REQUIRE(std::all_of(keys.begin(), keys.end(), [](auto k) { return k == 0; }));
+    REQUIRE(std::all_of(gids.begin(), gids.end(), [](auto g) { return g == std::numeric_limits<T>::max(); }));
+    REQUIRE(std::all_of(positions.begin(), positions.end(),
+                        [](auto p) { return p == std::numeric_limits<size_t>::max(); }));
+  }
+}
+
+template <class SimdStyle>
+void test_join(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = Hash_Join_Build_SIMD_Linear_Probing<
+    SimdStyle, size_t, OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::reusable_table>>;
+  std::mt19937_64 mt(seed);
+  constexpr size_t map_count = 4096;
+  std::vector<T> keys(map_count);
+  std::vector<T> used(map_count);
+  std::vector<size_t> positions(map_count);
+  builder_t builder(keys.data(), used.data(), positions.data(), map_count);
+
+  std::vector<T> fresh_keys(map_count);
+  std::vector<T> fresh_used(map_count);
+  std::vector<size_t> fresh_positions(map_count);
+  for (size_t distinct : {size_t{1}, size_t{200}, size_t{2000}, size_t{50}}) {
+    auto const data = random_keys<SimdStyle>(mt, elements, distinct);
+    builder(data.data(), data.size());
+    builder_t fresh(fresh_keys.data(), fresh_used.data(), fresh_positions.data(), map_count);
+    fresh(data.data(), data.size());
+    REQUIRE(builder.get_used_bucket_count() == fresh.get_used_bucket_count());
+    REQUIRE(keys == fresh_keys);
+    REQUIRE(used == fresh_used);
+    REQUIRE(positions == fresh_positions);
+
+    builder.reset();
+    REQUIRE(builder.get_used_bucket_count() == 0);
+    REQUIRE(std::all_of(keys.begin(), keys.end(), [](auto k) { return k == 0; }));
+    REQUIRE(std::all_of(used.begin(), used.end(), [](auto u) { return u == 0; }));
+    REQUIRE(std::all_of(positions.begin(), positions.end(),
+                        [](auto p) { return p == std::numeric_limits<size_t>::max(); }));
+  }
+}
+
+template <class SimdStyle>
+void test_group_sum(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using builder_t = Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement<
+    SimdStyle, T, OperatorHintSet<hints::hashing::size_exp_2, hints::hashing::reusable_table>, tsl::workaround,
+    int64_t>;
+  std::mt19937_64 mt(seed);
+  constexpr size_t map_count = 4096;
+  std::vector<T> keys(map_count);
+  std::vector<int64_t> sums(map_count);
+  builder_t builder(keys.data(), sums.data(), map_count, 0, false);
+  builder.initialize_sinks(2);
+
+  std::vector<T> fresh_keys(map_count);
+  std::vector<int64_t> fresh_sums(map_count);
+  for (size_t distinct : {size_t{1}, size_t{200}, size_t{2000}, size_t{50}}) {
+    auto const data = random_keys<SimdStyle>(mt, elements, distinct);
+    builder(data.data(), data.size(), data.data());
+    builder_t fresh(fresh_keys.data(), fresh_sums.data(), map_count);
+    fresh(data.data(), data.size(), data.data());
+    REQUIRE(builder.distinct_key_count() == fresh.distinct_key_count());
+    REQUIRE(keys == fresh_keys);
+    REQUIRE(sums == fresh_sums);
+
+    builder.reset();
+    REQUIRE(builder.distinct_key_count() == 0);
+    REQUIRE(std::all_of(keys.begin(), keys.end(), [](auto k) { return k == 0; }));
+    REQUIRE(std::all_of(sums.begin(), sums.end(), [](auto s) { return s == 0; }));
+  }
+}
+
+template <class SimdStyle>
+void test_group_sum_padding(const size_t elements, const size_t seed) {
+  using namespace tuddbs;
+  using T = typename SimdStyle::base_type;
+  using hints_t = OperatorHintSet<hints::hashing::reusable_table>;
+  using builder_t = Grouper_Aggregate_Sum_Build_Hash_SIMD_Linear_Displacement<SimdStyle, T, hints_t, tsl::workaround,
+                                                                              int64_t>;
+  using grouper_t =
+    Grouper_Aggregate_Sum_Hash_SIMD_Linear_Displacement<SimdStyle, T, hints_t, tsl::workaround, int64_t>;
+  std::mt19937_64 mt(seed);
+  // Neither a power of two nor a multiple of the lanes, so the probes of the last buckets read the padding.
+  constexpr size_t map_count = 1001;
+  auto const sink_count = map_count + bucket_padding<SimdStyle, hints_t>(map_count);
+  REQUIRE(sink_count == map_count + SimdStyle::vector_element_count());
+  // The sinks start out with garbage, which has to be cleared in the padding as well.
+  std::vector<T> keys(sink_count, static_cast<T>(7));
+  std::vector<int64_t> sums(sink_count, 7);
+  builder_t builder(keys.data(), sums.data(), map_count, 0, false);
+  builder.initialize_sinks(3);
+  REQUIRE(std::all_of(keys.begin(), keys.end(), [](auto k) { return k == 0; }));
+  REQUIRE(std::all_of(sums.begin(), sums.end(), [](auto s) { return s == 0; }));
+
+  for (size_t distinct : {size_t{1}, size_t{500}, size_t{1000}}) {
+    auto const data = random_keys<SimdStyle>(mt, elements, distinct);
+    builder(data.data(), data.size(), data.data());
+    std::vector<T> group_keys(sink_count);
+    std::vector<int64_t> group_sums(sink_count);
+    grouper_t grouper(keys.data(), sums.data(), map_count);
+    grouper(group_keys.data(), group_sums.data());
+    group_keys.resize(builder.distinct_key_count());
+    group_sums.resize(builder.distinct_key_count());
+    int64_t expected_sum = 0;
+    for (auto const k : data) {
+      expected_sum += static_cast<int64_t>(k);
+    }
+    int64_t sum = 0;
+    for (size_t i = 0; i < group_keys.size(); ++i) {
+      REQUIRE(group_keys[i] != 0);
+      REQUIRE(group_sums[i] % static_cast<int64_t>(group_keys[i]) == 0);
+      sum += group_sums[i];
+    }
+    REQUIRE(sum == expected_sum);
+    builder.reset();
+    REQUIRE(std::all_of(keys.begin(), keys.end(), [](auto k) { return k == 0; }));
+  }
+}
+
+template <class SimdStyle>
+void dispatch_type() {
+  const size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::cout << "Seed: " << seed << std::endl;
+  test_fill<SimdStyle>(seed);
+  for (size_t elements : {size_t{1}, size_t{1000}, size_t{64 * 1024 + 3}}) {
+    test_group<SimdStyle>(elements, seed);
+    test_join<SimdStyle>(elements, seed);
+    test_group_sum<SimdStyle>(elements, seed);
+    test_group_sum_padding<SimdStyle>(elements, seed);
+  }
+}
+
+#ifdef TSL_CONTAINS_SSE
+TEMPLATE_TEST_CASE("Hash table initialization and reset, sse", "[sse]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::sse>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX2
+TEMPLATE_TEST_CASE("Hash table initialization and reset, avx2", "[avx2]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx2>>(); }
+}
+#endif
+
+#ifdef TSL_CONTAINS_AVX512
+TEMPLATE_TEST_CASE("Hash table initialization and reset, avx512", "[avx512]", uint32_t, uint64_t, int32_t, int64_t) {
+  SECTION(tsl::type_name<TestType>()) { dispatch_type<tsl::simd<TestType, tsl::avx512>>(); }
+}
+#endif